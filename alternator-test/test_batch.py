@@ -251,3 +251,70 @@ def test_batch_get_item_projection_expression(test_table):
         got_items = reply['Responses'][test_table.name]
         expected_items = [{k: item[k] for k in wanted if k in item} for item in items]
         assert multiset(got_items) == multiset(expected_items)
+
+# Test that BatchGetItem rejects a request which asks for the same key twice,
+# like DynamoDB does. Keys which share only one of their components are fine.
+def test_batch_get_item_duplicate_keys(test_table_s, test_table):
+    p = random_string()
+    with pytest.raises(ClientError, match='ValidationException.*duplicates'):
+        test_table_s.meta.client.batch_get_item(RequestItems = {test_table_s.name: {'Keys': [{'p': p}, {'p': p}]}})
+    c = random_string()
+    with pytest.raises(ClientError, match='ValidationException.*duplicates'):
+        test_table.meta.client.batch_get_item(RequestItems = {test_table.name: {'Keys': [{'p': p, 'c': c}, {'p': p, 'c': c}]}})
+    other = random_string()
+    reply = test_table.meta.client.batch_get_item(RequestItems = {test_table.name: {'Keys': [{'p': p, 'c': c}, {'p': p, 'c': other}, {'p': other, 'c': c}]}})
+    assert reply['Responses'][test_table.name] == []
+
+# Test BatchGetItem of several sort keys of the same partition, some of them
+# missing, together with keys of other partitions.
+def test_batch_get_item_same_partition(test_table):
+    p = random_string()
+    items = [{'p': p, 'c': random_string(), 'val': random_string()} for i in range(10)]
+    other_items = [{'p': random_string(), 'c': random_string(), 'val': random_string()} for i in range(3)]
+    with test_table.batch_writer() as batch:
+        for item in items + other_items:
+            batch.put_item(item)
+    keys = [{k: x[k] for k in ('p', 'c')} for x in items + other_items]
+    keys += [{'p': p, 'c': random_string()} for i in range(3)]
+    reply = test_table.meta.client.batch_get_item(RequestItems = {test_table.name: {'Keys': keys, 'ConsistentRead': True}})
+    assert multiset(reply['Responses'][test_table.name]) == multiset(items + other_items)
+
+# Test BatchGetItem of a table with just a hash key, with more partitions than
+# are read concurrently.
+def test_batch_get_item_hash_only_many_partitions(test_table_s):
+    items = [{'p': random_string(), 'val': random_string()} for i in range(50)]
+    with test_table_s.batch_writer() as batch:
+        for item in items:
+            batch.put_item(item)
+    keys = [{'p': x['p']} for x in items] + [{'p': random_string()} for i in range(10)]
+    reply = test_table_s.meta.client.batch_get_item(RequestItems = {test_table_s.name: {'Keys': keys, 'ConsistentRead': True}})
+    assert multiset(reply['Responses'][test_table_s.name]) == multiset(items)
+
+# Test BatchWriteItem of puts and deletes of several sort keys of the same
+# partition, which are applied together.
+def test_batch_write_same_partition(test_table):
+    p = random_string()
+    items = [{'p': p, 'c': random_string(), 'val': random_string()} for i in range(10)]
+    with test_table.batch_writer() as batch:
+        for item in items:
+            batch.put_item(item)
+    assert multiset(full_query(test_table, KeyConditions={'p': {'AttributeValueList': [p], 'ComparisonOperator': 'EQ'}}, ConsistentRead=True)) == multiset(items)
+    new_items = [{'p': p, 'c': random_string(), 'val': random_string()} for i in range(5)]
+    with test_table.batch_writer() as batch:
+        for item in items[:5]:
+            batch.delete_item(Key={'p': p, 'c': item['c']})
+        for item in new_items:
+            batch.put_item(item)
+    assert multiset(full_query(test_table, KeyConditions={'p': {'AttributeValueList': [p], 'ComparisonOperator': 'EQ'}}, ConsistentRead=True)) == multiset(items[5:] + new_items)
+
+# A batch which was fully processed returns empty UnprocessedKeys or
+# UnprocessedItems, like DynamoDB does. Nothing short of a replica failure
+# makes part of a batch unprocessed, and failing the whole call requires all
+# of it to fail, so neither can be provoked here.
+def test_batch_fully_processed(test_table_s):
+    p = random_string()
+    reply = test_table_s.meta.client.batch_write_item(RequestItems = {test_table_s.name: [{'PutRequest': {'Item': {'p': p}}}]})
+    assert reply['UnprocessedItems'] == {}
+    reply = test_table_s.meta.client.batch_get_item(RequestItems = {test_table_s.name: {'Keys': [{'p': p}], 'ConsistentRead': True}})
+    assert reply['Responses'][test_table_s.name] == [{'p': p}]
+    assert reply['UnprocessedKeys'] == {}
@@ -18,6 +18,7 @@
 # Test for operations on items with *nested* attributes.
 
 import pytest
+from decimal import Decimal
 from botocore.exceptions import ClientError
 from util import random_string
 
@@ -58,3 +59,38 @@ def test_attribute_updates_dot(test_table_s):
     p = random_string()
     test_table_s.update_item(Key={'p': p}, AttributeUpdates={'a.b': {'Value': 3, 'Action': 'PUT'}})
     assert test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item'] == {'p': p, 'a.b': 3}
+
+# Test that every kind of value which isn't a plain scalar - lists, maps,
+# the three set types and NULL - is read back exactly as it was written,
+# including when nested inside each other.
+def test_nested_value_types_round_trip(test_table_s):
+    p = random_string()
+    item = {
+        'p': p,
+        'l': [1, 'hi', b'\x01\x02', True, None, [2, [3]], {'x': 'y'}],
+        'm': {'b': Decimal('-2.5'), 'a': b'\xff', 'c': {'d': {'e', 'f'}}, 'e': []},
+        'ss': {'a', 'b', 'c'},
+        'ns': {1, -2, Decimal('3.25')},
+        'bs': {b'\x01\x02', b'\x03'},
+        'n': None,
+        'empty_m': {},
+    }
+    test_table_s.put_item(Item=item)
+    assert test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item'] == item
+    test_table_s.update_item(Key={'p': p}, AttributeUpdates={'l': {'Value': {'q': [None, {'r'}]}, 'Action': 'PUT'}})
+    item['l'] = {'q': [None, {'r'}]}
+    assert test_table_s.get_item(Key={'p': p}, ConsistentRead=True)['Item'] == item
+
+# Test that a QueryFilter with EQ on a nested value matches the items which
+# hold an equal value, regardless of the order in which map members were
+# given.
+def test_query_filter_eq_nested_value(test_table):
+    p = random_string()
+    test_table.put_item(Item={'p': p, 'c': 'a', 'm': {'x': 1, 'y': [2, 'z']}})
+    test_table.put_item(Item={'p': p, 'c': 'b', 'm': {'y': [2, 'z'], 'x': 1}})
+    test_table.put_item(Item={'p': p, 'c': 'c', 'm': {'x': 1, 'y': [3, 'z']}})
+    test_table.put_item(Item={'p': p, 'c': 'd', 'm': ['x', 1]})
+    got_items = test_table.query(ConsistentRead=True,
+        KeyConditions={'p': {'AttributeValueList': [p], 'ComparisonOperator': 'EQ'}},
+        QueryFilter={'m': {'AttributeValueList': [{'y': [2, 'z'], 'x': 1}], 'ComparisonOperator': 'EQ'}})['Items']
+    assert sorted(item['c'] for item in got_items) == ['a', 'b']
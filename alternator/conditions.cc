@@ -65,9 +65,11 @@ comparison_operator_type get_comparison_operator(const rjson::value& comparison_
 static ::shared_ptr<cql3::restrictions::single_column_restriction::contains> make_map_element_restriction(const column_definition& cdef, std::string_view key, const rjson::value& value) {
     bytes raw_key = utf8_type->from_string(sstring_view(key.data(), key.size()));
     auto key_value = ::make_shared<cql3::constants::value>(cql3::raw_value::make_value(std::move(raw_key)));
-    bytes raw_value = serialize_item(value);
+    // The value is only compared on this node, and items written in either format have to match it.
+    bytes raw_value = serialize_item(value, nested_value_format::encoded);
     auto entry_value = ::make_shared<cql3::constants::value>(cql3::raw_value::make_value(std::move(raw_value)));
-    return make_shared<cql3::restrictions::single_column_restriction::contains>(cdef, std::move(key_value), std::move(entry_value));
+    return make_shared<cql3::restrictions::single_column_restriction::contains>(cdef, std::move(key_value), std::move(entry_value),
+            [] (bytes_view stored, bytes_view expected) { return serialized_items_equal(stored, expected); });
 }
 
 static ::shared_ptr<cql3::restrictions::single_column_restriction::EQ> make_key_eq_restriction(const column_definition& cdef, const rjson::value& value) {
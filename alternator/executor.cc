@@ -51,6 +51,7 @@
 #include "seastar/json/json_elements.hh"
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include "collection_mutation.hh"
+#include "service/storage_service.hh"
 
 #include <boost/range/adaptors.hpp>
 
@@ -69,14 +70,54 @@ static const column_definition& attrs_column(const schema& schema) {
     return *cdef;
 }
 
-struct make_jsonable : public json::jsonable {
-    rjson::value _value;
+// Items are read by any node of the cluster, so the binary encoding of nested
+// values can only be written once all of them understand it.
+static nested_value_format stored_nested_value_format() {
+    return service::get_local_storage_service().cluster_supports_alternator_encoded_values()
+            ? nested_value_format::encoded : nested_value_format::json;
+}
+
+struct chunked_json : public json::jsonable {
+    rjson::chunked_content _content;
+    size_t _size;
 public:
-    explicit make_jsonable(rjson::value&& value) : _value(std::move(value)) {}
+    chunked_json(rjson::chunked_content&& content, size_t size) : _content(std::move(content)), _size(size) {}
     virtual std::string to_json() const override {
-        return rjson::print(_value);
+        std::string ret;
+        ret.reserve(_size);
+        for (auto& buf : _content) {
+            ret.append(buf.get(), buf.size());
+        }
+        return ret;
     }
 };
+
+// Responses larger than this are streamed to the client from the buffers
+// they were serialized into, instead of being copied into a contiguous
+// string (several times, on the way to the HTTP reply). Smaller ones are
+// returned as a string, which is sent with a Content-Length.
+static constexpr size_t streamed_response_threshold = 64 * 1024;
+
+static json::json_return_type make_response(rjson::value&& value) {
+    auto content = rjson::print_chunked(value);
+    size_t size = 0;
+    for (auto& buf : content) {
+        size += buf.size();
+    }
+    if (size <= streamed_response_threshold) {
+        return json::json_return_type(chunked_json(std::move(content), size));
+    }
+    std::function<future<>(output_stream<char>&&)> body_writer = [content = make_lw_shared(std::move(content))] (output_stream<char>&& os) {
+        return do_with(std::move(os), [content] (output_stream<char>& os) {
+            return do_for_each(*content, [&os] (temporary_buffer<char>& buf) {
+                return os.write(buf.share());
+            }).finally([&os] {
+                return os.close();
+            });
+        });
+    };
+    return json::json_return_type(std::move(body_writer));
+}
 struct json_string : public json::jsonable {
     std::string _value;
 public:
@@ -299,7 +340,7 @@ static void describe_key_schema(rjson::value& parent, const schema& schema, std:
 
 }
 
-future<json::json_return_type> executor::describe_table(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::describe_table(client_state& client_state, sstring content) {
     _stats.api_operations.describe_table++;
     rjson::value request = rjson::parse(content);
     elogger.trace("Describing table {}", request);
@@ -375,10 +416,10 @@ future<json::json_return_type> executor::describe_table(client_state& client_sta
     rjson::value response = rjson::empty_object();
     rjson::set(response, "Table", std::move(table_description));
     elogger.trace("returning {}", response);
-    return make_ready_future<json::json_return_type>(make_jsonable(std::move(response)));
+    return make_ready_future<json::json_return_type>(make_response(std::move(response)));
 }
 
-future<json::json_return_type> executor::delete_table(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::delete_table(client_state& client_state, sstring content) {
     _stats.api_operations.delete_table++;
     rjson::value request = rjson::parse(content);
     elogger.trace("Deleting table {}", request);
@@ -398,7 +439,7 @@ future<json::json_return_type> executor::delete_table(client_state& client_state
         rjson::value response = rjson::empty_object();
         rjson::set(response, "TableDescription", std::move(table_description));
         elogger.trace("returning {}", response);
-        return make_ready_future<json::json_return_type>(make_jsonable(std::move(response)));
+        return make_ready_future<json::json_return_type>(make_response(std::move(response)));
     });
 }
 
@@ -481,7 +522,7 @@ static std::pair<std::string, std::string> parse_key_schema(const rjson::value&
 }
 
 
-future<json::json_return_type> executor::create_table(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::create_table(client_state& client_state, sstring content) {
     _stats.api_operations.create_table++;
     rjson::value table_info = rjson::parse(content);
     elogger.trace("Creating table {}", table_info);
@@ -655,7 +696,7 @@ future<json::json_return_type> executor::create_table(client_state& client_state
             rjson::value status = rjson::empty_object();
             supplement_table_info(table_info, *schema);
             rjson::set(status, "TableDescription", std::move(table_info));
-            return make_ready_future<json::json_return_type>(make_jsonable(std::move(status)));
+            return make_ready_future<json::json_return_type>(make_response(std::move(status)));
         });
     }).handle_exception_type([table_name = std::move(table_name)] (exceptions::already_exists_exception&) {
         return make_exception_future<json::json_return_type>(
@@ -709,7 +750,7 @@ static mutation make_item_mutation(const rjson::value& item, schema_ptr schema)
         bytes column_name = to_bytes(it->name.GetString());
         const column_definition* cdef = schema->get_column_definition(column_name);
         if (!cdef) {
-            bytes value = serialize_item(it->value);
+            bytes value = serialize_item(it->value, stored_nested_value_format());
             attrs_collector.put(std::move(column_name), std::move(value), ts);
         } else if (!cdef->is_primary_key()) {
             // Explicitly defined regular columns can appear as a result of creating a global secondary index
@@ -749,7 +790,7 @@ static future<std::unique_ptr<rjson::value>> maybe_get_previous_item(
         bool need_read_before_write,
         alternator::stats& stats);
 
-future<json::json_return_type> executor::put_item(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::put_item(client_state& client_state, sstring content) {
     _stats.api_operations.put_item++;
     auto start_time = std::chrono::steady_clock::now();
     rjson::value update_info = rjson::parse(content);
@@ -806,7 +847,7 @@ static mutation make_delete_item_mutation(const rjson::value& key, schema_ptr sc
     return m;
 }
 
-future<json::json_return_type> executor::delete_item(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::delete_item(client_state& client_state, sstring content) {
     _stats.api_operations.delete_item++;
     auto start_time = std::chrono::steady_clock::now();
     rjson::value update_info = rjson::parse(content);
@@ -868,56 +909,109 @@ struct primary_key_equal {
     }
 };
 
-future<json::json_return_type> executor::batch_write_item(client_state& client_state, std::string content) {
+// Batch operations write or read each partition with a separate
+// storage_proxy request, with at most this many of them in flight.
+static constexpr size_t max_batch_concurrency = 16;
+
+future<json::json_return_type> executor::batch_write_item(client_state& client_state, sstring content) {
     _stats.api_operations.batch_write_item++;
     rjson::value batch_info = rjson::parse(content);
     rjson::value& request_items = batch_info["RequestItems"];
 
-    std::vector<mutation> mutations;
-    mutations.reserve(request_items.MemberCount());
+    // Requests writing to the same partition are merged into one mutation.
+    // If writing a partition fails, its requests are returned to the client
+    // in UnprocessedItems, so it can retry them, instead of failing the
+    // whole batch.
+    struct partition_write {
+        mutation m;
+        std::vector<rjson::value> requests;
+    };
+    struct table_writes {
+        std::string table_name;
+        std::vector<partition_write> partitions;
+        rjson::value unprocessed = rjson::empty_array();
+    };
+    std::vector<table_writes> writes;
+    writes.reserve(request_items.MemberCount());
 
     for (auto it = request_items.MemberBegin(); it != request_items.MemberEnd(); ++it) {
         schema_ptr schema = get_table_from_batch_request(_proxy, it);
         tracing::add_table_name(client_state.get_trace_state(), schema->ks_name(), schema->cf_name());
+        table_writes tw{schema->cf_name(), {}};
         std::unordered_set<primary_key, primary_key_hash, primary_key_equal> used_keys(1, primary_key_hash{schema}, primary_key_equal{schema});
+        std::unordered_map<partition_key, size_t, partition_key::hashing, partition_key::equality> partitions(1,
+                partition_key::hashing(*schema), partition_key::equality(*schema));
         for (auto& request : it->value.GetArray()) {
             if (!request.IsObject() || request.MemberCount() != 1) {
                 throw api_error("ValidationException", format("Invalid BatchWriteItem request: {}", request));
             }
             auto r = request.MemberBegin();
             const std::string r_name = r->name.GetString();
+            std::optional<mutation> m;
             if (r_name == "PutRequest") {
                 const rjson::value& put_request = r->value;
                 const rjson::value& item = put_request["Item"];
-                mutations.push_back(make_item_mutation(item, schema));
-                // make_item_mutation returns a mutation with a single clustering row
-                auto mut_key = std::make_pair(mutations.back().key(), mutations.back().partition().clustered_rows().begin()->key());
-                if (used_keys.count(mut_key) > 0) {
-                    throw api_error("ValidationException", "Provided list of item keys contains duplicates");
-                }
-                used_keys.insert(std::move(mut_key));
+                m = make_item_mutation(item, schema);
             } else if (r_name == "DeleteRequest") {
                 const rjson::value& key = (r->value)["Key"];
-                mutations.push_back(make_delete_item_mutation(key, schema));
-                // make_delete_item_mutation returns a mutation with a single clustering row
-                auto mut_key = std::make_pair(mutations.back().key(), mutations.back().partition().clustered_rows().begin()->key());
-                if (used_keys.count(mut_key) > 0) {
-                    throw api_error("ValidationException", "Provided list of item keys contains duplicates");
-                }
-                used_keys.insert(std::move(mut_key));
+                m = make_delete_item_mutation(key, schema);
             } else {
                 throw api_error("ValidationException", format("Unknown BatchWriteItem request type: {}", r_name));
             }
+            // make_item_mutation and make_delete_item_mutation return a
+            // mutation with a single clustering row
+            auto mut_key = std::make_pair(m->key(), m->partition().clustered_rows().begin()->key());
+            if (used_keys.count(mut_key) > 0) {
+                throw api_error("ValidationException", "Provided list of item keys contains duplicates");
+            }
+            used_keys.insert(std::move(mut_key));
+            auto [p, inserted] = partitions.try_emplace(m->key(), tw.partitions.size());
+            if (inserted) {
+                tw.partitions.push_back(partition_write{std::move(*m), {}});
+            } else {
+                tw.partitions[p->second].m.apply(std::move(*m));
+            }
+            tw.partitions[p->second].requests.push_back(rjson::copy(request));
         }
-    }
-
-    return _proxy.mutate(std::move(mutations), db::consistency_level::LOCAL_QUORUM, default_timeout(), client_state.get_trace_state(), empty_service_permit()).then([] () {
-        // Without special options on what to return, BatchWriteItem returns nothing,
-        // unless there are UnprocessedItems - it's possible to just stop processing a batch
-        // due to throttling. TODO(sarna): Consider UnprocessedItems when returning.
-        rjson::value ret = rjson::empty_object();
-        rjson::set(ret, "UnprocessedItems", rjson::empty_object());
-        return make_ready_future<json::json_return_type>(make_jsonable(std::move(ret)));
+        writes.push_back(std::move(tw));
+    }
+
+    return do_with(std::move(writes), semaphore(max_batch_concurrency), std::exception_ptr(), size_t(0),
+            [this, &client_state] (std::vector<table_writes>& writes, semaphore& sem, std::exception_ptr& error, size_t& failed) {
+        return parallel_for_each(writes, [this, &client_state, &sem, &error, &failed] (table_writes& tw) {
+            return parallel_for_each(tw.partitions, [this, &client_state, &sem, &error, &failed, &tw] (partition_write& pw) {
+                return with_semaphore(sem, 1, [this, &client_state, &pw] {
+                    return _proxy.mutate(std::vector<mutation>{std::move(pw.m)}, db::consistency_level::LOCAL_QUORUM, default_timeout(), client_state.get_trace_state(), empty_service_permit());
+                }).handle_exception([&error, &failed, &tw, &pw] (std::exception_ptr ep) {
+                    elogger.debug("BatchWriteItem: failed writing to table {}: {}", tw.table_name, ep);
+                    error = ep;
+                    ++failed;
+                    for (auto& request : pw.requests) {
+                        rjson::push_back(tw.unprocessed, std::move(request));
+                    }
+                });
+            });
+        }).then([&writes, &error, &failed] {
+            size_t partitions = 0;
+            for (auto& tw : writes) {
+                partitions += tw.partitions.size();
+            }
+            // Only report unprocessed items when part of the batch made it,
+            // so a client doesn't keep retrying a batch which can't succeed.
+            if (failed && failed == partitions) {
+                return make_exception_future<json::json_return_type>(error);
+            }
+            // Without special options on what to return, BatchWriteItem returns nothing,
+            // unless there are UnprocessedItems.
+            rjson::value ret = rjson::empty_object();
+            rjson::set(ret, "UnprocessedItems", rjson::empty_object());
+            for (auto& tw : writes) {
+                if (!tw.unprocessed.Empty()) {
+                    rjson::set_with_string_name(ret["UnprocessedItems"], tw.table_name, std::move(tw.unprocessed));
+                }
+            }
+            return make_ready_future<json::json_return_type>(make_response(std::move(ret)));
+        });
     });
 }
 
@@ -1410,7 +1504,7 @@ static future<std::unique_ptr<rjson::value>> maybe_get_previous_item(
 }
 
 
-future<json::json_return_type> executor::update_item(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::update_item(client_state& client_state, sstring content) {
     _stats.api_operations.update_item++;
     auto start_time = std::chrono::steady_clock::now();
     rjson::value update_info = rjson::parse(content);
@@ -1483,7 +1577,7 @@ future<json::json_return_type> executor::update_item(client_state& client_state,
                 bytes column_value = get_key_from_typed_value(json_value, *cdef, type_to_string(cdef->type));
                 row.cells().apply(*cdef, atomic_cell::make_live(*cdef->type, ts, column_value));
             } else {
-                attrs_collector.put(std::move(column_name), serialize_item(json_value), ts);
+                attrs_collector.put(std::move(column_name), serialize_item(json_value, stored_nested_value_format()), ts);
             }
         };
         auto do_delete = [&] (bytes&& column_name) {
@@ -1630,7 +1724,7 @@ static db::consistency_level get_read_consistency(const rjson::value& request) {
     return consistent_read ? db::consistency_level::LOCAL_QUORUM : db::consistency_level::LOCAL_ONE;
 }
 
-future<json::json_return_type> executor::get_item(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::get_item(client_state& client_state, sstring content) {
     _stats.api_operations.get_item++;
     auto start_time = std::chrono::steady_clock::now();
     rjson::value table_info = rjson::parse(content);
@@ -1669,34 +1763,43 @@ future<json::json_return_type> executor::get_item(client_state& client_state, st
     return _proxy.query(schema, std::move(command), std::move(partition_ranges), cl, service::storage_proxy::coordinator_query_options(default_timeout(), empty_service_permit(), client_state)).then(
             [this, schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = std::move(attrs_to_get), start_time = std::move(start_time)] (service::storage_proxy::coordinator_query_result qr) mutable {
         _stats.api_operations.get_item_latency.add(std::chrono::steady_clock::now() - start_time, _stats.api_operations.get_item_latency._count + 1);
-        return make_ready_future<json::json_return_type>(make_jsonable(describe_item(schema, partition_slice, *selection, std::move(qr.query_result), std::move(attrs_to_get))));
+        return make_ready_future<json::json_return_type>(make_response(describe_item(schema, partition_slice, *selection, std::move(qr.query_result), std::move(attrs_to_get))));
     });
 }
 
-future<json::json_return_type> executor::batch_get_item(client_state& client_state, std::string content) {
+static rjson::value describe_multi_item(schema_ptr schema, const query::partition_slice& slice, const cql3::selection::selection& selection, const query::result& query_result, const std::unordered_set<std::string>& attrs_to_get);
+
+future<json::json_return_type> executor::batch_get_item(client_state& client_state, sstring content) {
     // FIXME: In this implementation, an unbounded batch size can cause
-    // unbounded response JSON object to be buffered in memory, unbounded
-    // parallelism of the requests, and unbounded amount of non-preemptable
-    // work in the following loops. So we should limit the batch size, and/or
-    // the response size, as DynamoDB does.
+    // unbounded response JSON object to be buffered in memory, and unbounded
+    // amount of non-preemptable work in the following loops. So we should
+    // limit the batch size, and/or the response size, as DynamoDB does.
     _stats.api_operations.batch_get_item++;
     rjson::value req = rjson::parse(content);
     rjson::value& request_items = req["RequestItems"];
 
     // We need to validate all the parameters before starting any asynchronous
     // query, and fail the entire request on any parse error. So we parse all
-    // the input into our own vector "requests".
+    // the input into our own vector "requests". Keys of the same partition
+    // are grouped, so they are read with a single query.
     struct table_requests {
         schema_ptr schema;
         db::consistency_level cl;
         std::unordered_set<std::string> attrs_to_get;
-        struct single_request {
+        // The table's part of the request, echoed back in UnprocessedKeys
+        // with the keys which couldn't be read.
+        rjson::value request;
+        struct partition_request {
             partition_key pk;
-            clustering_key ck;
+            std::vector<clustering_key> cks;
+            std::vector<rjson::value> keys;
         };
-        std::vector<single_request> requests;
+        std::vector<partition_request> partitions;
+        rjson::value responses = rjson::empty_array();
+        rjson::value unprocessed = rjson::empty_array();
     };
     std::vector<table_requests> requests;
+    requests.reserve(request_items.MemberCount());
 
     for (auto it = request_items.MemberBegin(); it != request_items.MemberEnd(); ++it) {
         table_requests rs;
@@ -1704,61 +1807,97 @@ future<json::json_return_type> executor::batch_get_item(client_state& client_sta
         tracing::add_table_name(client_state.get_trace_state(), KEYSPACE_NAME, rs.schema->cf_name());
         rs.cl = get_read_consistency(it->value);
         rs.attrs_to_get = calculate_attrs_to_get(it->value);
+        rs.request = rjson::copy(it->value);
+        std::unordered_map<partition_key, size_t, partition_key::hashing, partition_key::equality> partitions(1,
+                partition_key::hashing(*rs.schema), partition_key::equality(*rs.schema));
         auto& keys = (it->value)["Keys"];
         for (const rjson::value& key : keys.GetArray()) {
-            rs.requests.push_back({pk_from_json(key, rs.schema), ck_from_json(key, rs.schema)});
+            auto pk = pk_from_json(key, rs.schema);
+            auto ck = ck_from_json(key, rs.schema);
             check_key(key, rs.schema);
+            auto [p, inserted] = partitions.try_emplace(pk, rs.partitions.size());
+            if (inserted) {
+                rs.partitions.push_back({std::move(pk), {}, {}});
+            }
+            rs.partitions[p->second].cks.push_back(std::move(ck));
+            rs.partitions[p->second].keys.push_back(rjson::copy(key));
         }
-        requests.emplace_back(std::move(rs));
-    }
-
-    // If got here, all "requests" are valid, so let's start them all
-    // in parallel. The requests object are then immediately destroyed.
-    std::vector<future<std::tuple<std::string, std::optional<rjson::value>>>> response_futures;
-    for (const auto& rs : requests) {
-        for (const auto &r : rs.requests) {
-            dht::partition_range_vector partition_ranges{dht::partition_range(dht::global_partitioner().decorate_key(*rs.schema, std::move(r.pk)))};
-            std::vector<query::clustering_range> bounds;
-            if (rs.schema->clustering_key_size() == 0) {
-                bounds.push_back(query::clustering_range::make_open_ended_both_sides());
-            } else {
-                bounds.push_back(query::clustering_range::make_singular(std::move(r.ck)));
+        // The clustering ranges of a slice must be sorted and disjoint.
+        for (auto& p : rs.partitions) {
+            std::sort(p.cks.begin(), p.cks.end(), clustering_key::less_compare(*rs.schema));
+            if (std::adjacent_find(p.cks.begin(), p.cks.end(), clustering_key::equality(*rs.schema)) != p.cks.end()) {
+                throw api_error("ValidationException", "Provided list of item keys contains duplicates");
             }
-            auto regular_columns = boost::copy_range<query::column_id_vector>(
-                    rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
-            auto selection = cql3::selection::selection::wildcard(rs.schema);
-            auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
-            auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, query::max_partitions);
-            future<std::tuple<std::string, std::optional<rjson::value>>> f = _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl, service::storage_proxy::coordinator_query_options(default_timeout(), empty_service_permit(), client_state)).then(
-                    [schema = rs.schema, partition_slice = std::move(partition_slice), selection = std::move(selection), attrs_to_get = rs.attrs_to_get] (service::storage_proxy::coordinator_query_result qr) mutable {
-                std::optional<rjson::value> json = describe_single_item(schema, partition_slice, *selection, std::move(qr.query_result), std::move(attrs_to_get));
-                return make_ready_future<std::tuple<std::string, std::optional<rjson::value>>>(
-                        std::make_tuple(schema->cf_name(), std::move(json)));
-            });
-            response_futures.push_back(std::move(f));
         }
+        requests.emplace_back(std::move(rs));
     }
 
-    // Wait for all requests to complete, and then return the response.
-    // FIXME: If one of the requests failed this will fail the entire request.
-    // What we should do instead is to return the failed key in the array
-    // UnprocessedKeys (which the BatchGetItem API supports) and let the user
-    // try again. Note that simply a missing key is *not* an error (we already
-    // handled it above), but this case does include things like timeouts,
-    // unavailable CL, etc.
-    return when_all_succeed(response_futures.begin(), response_futures.end()).then(
-            [] (std::vector<std::tuple<std::string, std::optional<rjson::value>>> responses) {
-        rjson::value response = rjson::empty_object();
-        rjson::set(response, "Responses", rjson::empty_object());
-        for (auto& t : responses) {
-            if (!response["Responses"].HasMember(std::get<0>(t).c_str())) {
-                rjson::set_with_string_name(response["Responses"], std::get<0>(t), rjson::empty_array());
+    // If got here, all "requests" are valid, so let's start them, at most
+    // max_batch_concurrency at a time. Note that simply a missing key is
+    // *not* an error, but a failed read, e.g. a timeout or unavailable CL,
+    // returns the keys it was to read in UnprocessedKeys for the client to
+    // retry, instead of failing the entire request.
+    return do_with(std::move(requests), semaphore(max_batch_concurrency), std::exception_ptr(), size_t(0),
+            [this, &client_state] (std::vector<table_requests>& requests, semaphore& sem, std::exception_ptr& error, size_t& failed) {
+        return parallel_for_each(requests, [this, &client_state, &sem, &error, &failed] (table_requests& rs) {
+            return parallel_for_each(rs.partitions, [this, &client_state, &sem, &error, &failed, &rs] (table_requests::partition_request& p) {
+                return with_semaphore(sem, 1, [this, &client_state, &rs, &p] {
+                    dht::partition_range_vector partition_ranges{dht::partition_range(dht::global_partitioner().decorate_key(*rs.schema, p.pk))};
+                    std::vector<query::clustering_range> bounds;
+                    if (rs.schema->clustering_key_size() == 0) {
+                        bounds.push_back(query::clustering_range::make_open_ended_both_sides());
+                    } else {
+                        for (auto& ck : p.cks) {
+                            bounds.push_back(query::clustering_range::make_singular(ck));
+                        }
+                    }
+                    auto regular_columns = boost::copy_range<query::column_id_vector>(
+                            rs.schema->regular_columns() | boost::adaptors::transformed([] (const column_definition& cdef) { return cdef.id; }));
+                    auto selection = cql3::selection::selection::wildcard(rs.schema);
+                    auto partition_slice = query::partition_slice(std::move(bounds), {}, std::move(regular_columns), selection->get_query_options());
+                    auto command = ::make_lw_shared<query::read_command>(rs.schema->id(), rs.schema->version(), partition_slice, query::max_partitions);
+                    return _proxy.query(rs.schema, std::move(command), std::move(partition_ranges), rs.cl, service::storage_proxy::coordinator_query_options(default_timeout(), empty_service_permit(), client_state)).then(
+                            [&rs, partition_slice = std::move(partition_slice), selection = std::move(selection)] (service::storage_proxy::coordinator_query_result qr) {
+                        return describe_multi_item(rs.schema, partition_slice, *selection, *qr.query_result, rs.attrs_to_get);
+                    });
+                }).then_wrapped([&error, &failed, &rs, &p] (future<rjson::value> f) {
+                    if (f.failed()) {
+                        error = f.get_exception();
+                        elogger.debug("BatchGetItem: failed reading from table {}: {}", rs.schema->cf_name(), error);
+                        ++failed;
+                        for (auto& key : p.keys) {
+                            rjson::push_back(rs.unprocessed, std::move(key));
+                        }
+                        return;
+                    }
+                    rjson::value items = f.get0();
+                    for (auto& item : items.GetArray()) {
+                        rjson::push_back(rs.responses, std::move(item));
+                    }
+                });
+            });
+        }).then([&requests, &error, &failed] {
+            size_t partitions = 0;
+            for (auto& rs : requests) {
+                partitions += rs.partitions.size();
             }
-            if (std::get<1>(t)) {
-                rjson::push_back(response["Responses"][std::get<0>(t)], std::move(*std::get<1>(t)));
+            // Only report unprocessed keys when part of the batch made it,
+            // so a client doesn't keep retrying a batch which can't succeed.
+            if (failed && failed == partitions) {
+                return make_exception_future<json::json_return_type>(error);
             }
-        }
-        return make_ready_future<json::json_return_type>(make_jsonable(std::move(response)));
+            rjson::value response = rjson::empty_object();
+            rjson::set(response, "Responses", rjson::empty_object());
+            rjson::set(response, "UnprocessedKeys", rjson::empty_object());
+            for (auto& rs : requests) {
+                rjson::set_with_string_name(response["Responses"], rs.schema->cf_name(), std::move(rs.responses));
+                if (!rs.unprocessed.Empty()) {
+                    rjson::get(rs.request, "Keys") = std::move(rs.unprocessed);
+                    rjson::set_with_string_name(response["UnprocessedKeys"], rs.schema->cf_name(), std::move(rs.request));
+                }
+            }
+            return make_ready_future<json::json_return_type>(make_response(std::move(response)));
+        });
     });
 }
 
@@ -1823,6 +1962,15 @@ class describe_items_visitor {
     }
 };
 
+static rjson::value describe_multi_item(schema_ptr schema, const query::partition_slice& slice, const cql3::selection::selection& selection, const query::result& query_result, const std::unordered_set<std::string>& attrs_to_get) {
+    cql3::selection::result_set_builder builder(selection, gc_clock::now(), cql_serialization_format::latest());
+    query::result_view::consume(query_result, slice, cql3::selection::result_set_builder::visitor(builder, *schema, selection));
+    auto result_set = builder.build();
+    describe_items_visitor visitor(selection.get_columns(), attrs_to_get);
+    result_set->visit(visitor);
+    return std::move(visitor).get_items();
+}
+
 static rjson::value describe_items(schema_ptr schema, const query::partition_slice& slice, const cql3::selection::selection& selection, std::unique_ptr<cql3::result_set> result_set, std::unordered_set<std::string>&& attrs_to_get) {
     describe_items_visitor visitor(selection.get_columns(), attrs_to_get);
     result_set->visit(visitor);
@@ -1910,7 +2058,7 @@ static future<json::json_return_type> do_query(schema_ptr schema,
         if (paging_state) {
             rjson::set(items, "LastEvaluatedKey", encode_paging_state(*schema, *paging_state));
         }
-        return make_ready_future<json::json_return_type>(make_jsonable(std::move(items)));
+        return make_ready_future<json::json_return_type>(make_response(std::move(items)));
     });
 }
 
@@ -1919,7 +2067,7 @@ static future<json::json_return_type> do_query(schema_ptr schema,
 // 2. Filtering - by passing appropriately created restrictions to pager as a last parameter
 // 3. Proper timeouts instead of gc_clock::now() and db::no_timeout
 // 4. Implement parallel scanning via Segments
-future<json::json_return_type> executor::scan(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::scan(client_state& client_state, sstring content) {
     _stats.api_operations.scan++;
     rjson::value request_info = rjson::parse(content);
     elogger.trace("Scanning {}", request_info);
@@ -2079,7 +2227,7 @@ calculate_bounds(schema_ptr schema, const rjson::value& conditions) {
     return {std::move(partition_ranges), std::move(ck_bounds)};
 }
 
-future<json::json_return_type> executor::query(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::query(client_state& client_state, sstring content) {
     _stats.api_operations.query++;
     rjson::value request_info = rjson::parse(content);
     elogger.trace("Querying {}", request_info);
@@ -2138,7 +2286,7 @@ static void validate_limit(int limit) {
     }
 }
 
-future<json::json_return_type> executor::list_tables(client_state& client_state, std::string content) {
+future<json::json_return_type> executor::list_tables(client_state& client_state, sstring content) {
     _stats.api_operations.list_tables++;
     rjson::value table_info = rjson::parse(content);
     elogger.trace("Listing tables {}", table_info);
@@ -2186,10 +2334,10 @@ future<json::json_return_type> executor::list_tables(client_state& client_state,
         rjson::set(response, "LastEvaluatedTableName", rjson::copy(last_table_name));
     }
 
-    return make_ready_future<json::json_return_type>(make_jsonable(std::move(response)));
+    return make_ready_future<json::json_return_type>(make_response(std::move(response)));
 }
 
-future<json::json_return_type> executor::describe_endpoints(client_state& client_state, std::string content, std::string host_header) {
+future<json::json_return_type> executor::describe_endpoints(client_state& client_state, sstring content, std::string host_header) {
     _stats.api_operations.describe_endpoints++;
     rjson::value response = rjson::empty_object();
     // Without having any configuration parameter to say otherwise, we tell
@@ -2205,7 +2353,7 @@ future<json::json_return_type> executor::describe_endpoints(client_state& client
     rjson::push_back(response["Endpoints"], rjson::empty_object());
     rjson::set(response["Endpoints"][0], "Address", rjson::from_string(host_header));
     rjson::set(response["Endpoints"][0], "CachePeriodInMinutes", rjson::value(1440));
-    return make_ready_future<json::json_return_type>(make_jsonable(std::move(response)));
+    return make_ready_future<json::json_return_type>(make_response(std::move(response)));
 }
 
 // Create the keyspace in which we put all Alternator tables, if it doesn't
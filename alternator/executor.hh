@@ -46,19 +46,19 @@ class executor {
 
     executor(service::storage_proxy& proxy, service::migration_manager& mm) : _proxy(proxy), _mm(mm) {}
 
-    future<json::json_return_type> create_table(client_state& client_state, std::string content);
-    future<json::json_return_type> describe_table(client_state& client_state, std::string content);
-    future<json::json_return_type> delete_table(client_state& client_state, std::string content);
-    future<json::json_return_type> put_item(client_state& client_state, std::string content);
-    future<json::json_return_type> get_item(client_state& client_state, std::string content);
-    future<json::json_return_type> delete_item(client_state& client_state, std::string content);
-    future<json::json_return_type> update_item(client_state& client_state, std::string content);
-    future<json::json_return_type> list_tables(client_state& client_state, std::string content);
-    future<json::json_return_type> scan(client_state& client_state, std::string content);
-    future<json::json_return_type> describe_endpoints(client_state& client_state, std::string content, std::string host_header);
-    future<json::json_return_type> batch_write_item(client_state& client_state, std::string content);
-    future<json::json_return_type> batch_get_item(client_state& client_state, std::string content);
-    future<json::json_return_type> query(client_state& client_state, std::string content);
+    future<json::json_return_type> create_table(client_state& client_state, sstring content);
+    future<json::json_return_type> describe_table(client_state& client_state, sstring content);
+    future<json::json_return_type> delete_table(client_state& client_state, sstring content);
+    future<json::json_return_type> put_item(client_state& client_state, sstring content);
+    future<json::json_return_type> get_item(client_state& client_state, sstring content);
+    future<json::json_return_type> delete_item(client_state& client_state, sstring content);
+    future<json::json_return_type> update_item(client_state& client_state, sstring content);
+    future<json::json_return_type> list_tables(client_state& client_state, sstring content);
+    future<json::json_return_type> scan(client_state& client_state, sstring content);
+    future<json::json_return_type> describe_endpoints(client_state& client_state, sstring content, std::string host_header);
+    future<json::json_return_type> batch_write_item(client_state& client_state, sstring content);
+    future<json::json_return_type> batch_get_item(client_state& client_state, sstring content);
+    future<json::json_return_type> query(client_state& client_state, sstring content);
 
     future<> start();
     future<> stop() { return make_ready_future<>(); }
@@ -22,6 +22,7 @@
 #include "rjson.hh"
 #include "error.hh"
 #include <seastar/core/print.hh>
+#include <algorithm>
 
 namespace rjson {
 
@@ -31,19 +32,64 @@ std::string print(const rjson::value& value) {
     string_buffer buffer;
     writer writer(buffer);
     value.Accept(writer);
-    return std::string(buffer.GetString());
+    return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+namespace {
+// A rapidjson output stream writing into a chain of buffers. The buffers
+// grow geometrically, so that small values need a single small allocation.
+class chunked_stream {
+    static constexpr size_t min_chunk_size = 512;
+    static constexpr size_t max_chunk_size = 128 * 1024;
+    chunked_content _chunks;
+    temporary_buffer<char> _current;
+    size_t _pos = 0;
+private:
+    void seal_current() {
+        if (_pos) {
+            _current.trim(_pos);
+            _chunks.push_back(std::move(_current));
+        }
+        _pos = 0;
+    }
+public:
+    using Ch = char;
+    void Put(Ch c) {
+        if (_pos == _current.size()) {
+            auto size = std::clamp(_current.size() * 2, min_chunk_size, max_chunk_size);
+            seal_current();
+            _current = temporary_buffer<char>(size);
+        }
+        _current.get_write()[_pos++] = c;
+    }
+    void Flush() { }
+    chunked_content finish() && {
+        seal_current();
+        return std::move(_chunks);
+    }
+};
+}
+
+chunked_content print_chunked(const rjson::value& value) {
+    chunked_stream stream;
+    rapidjson::Writer<chunked_stream, encoding> writer(stream);
+    value.Accept(writer);
+    return std::move(stream).finish();
 }
 
 rjson::value copy(const rjson::value& value) {
     return rjson::value(value, the_allocator);
 }
 
-rjson::value parse(const std::string& str) {
-    return parse_raw(str.c_str(), str.size());
+rjson::value parse(std::string_view str) {
+    return parse_raw(str.data(), str.size());
 }
 
 rjson::value parse_raw(const char* c_str, size_t size) {
-    rjson::document d;
+    // Without explicit allocators, the document would allocate its own for
+    // the value and for the parsing stack.
+    constexpr size_t stack_capacity = 1024;
+    rjson::document d(&the_allocator, stack_capacity, &the_allocator);
     d.Parse(c_str, size);
     if (d.HasParseError()) {
         throw rjson::error(format("Parsing JSON failed: {}", GetParseError_En(d.GetParseError())));
@@ -40,7 +40,9 @@
  */
 
 #include <string>
+#include <string_view>
 #include <stdexcept>
+#include <vector>
 
 namespace rjson {
 class error : public std::exception {
@@ -67,6 +69,7 @@ class error : public std::exception {
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/error/en.h>
 #include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
 #include "seastarx.hh"
 
 namespace rjson {
@@ -104,6 +107,14 @@ inline rjson::value empty_string() {
 // The representation is dense - without any redundant indentation.
 std::string print(const rjson::value& value);
 
+// A serialized JSON value, split into buffers of bounded size.
+using chunked_content = std::vector<temporary_buffer<char>>;
+
+// Like print(), but serializes into a chain of buffers instead of one
+// contiguous string, so that large values don't need large allocations
+// and can be written out without further copying.
+chunked_content print_chunked(const rjson::value& value);
+
 // Copies given JSON value - involves allocation
 rjson::value copy(const rjson::value& value);
 
@@ -111,7 +122,7 @@ rjson::value copy(const rjson::value& value);
 // The string/char array liveness does not need to be persisted,
 // as both parse() and parse_raw() will allocate member names and values.
 // Throws rjson::error if parsing failed.
-rjson::value parse(const std::string& str);
+rjson::value parse(std::string_view str);
 rjson::value parse_raw(const char* c_str, size_t size);
 
 // Creates a JSON value (of JSON string type) out of internal string representations.
@@ -26,6 +26,7 @@
 #include "rapidjson/writer.h"
 #include "concrete_types.hh"
 #include "cql3/type_json.hh"
+#include <seastar/net/byteorder.hh>
 
 static logging::logger slogger("alternator-serialization");
 
@@ -82,14 +83,272 @@ struct from_json_visitor {
     }
 };
 
-bytes serialize_item(const rjson::value& item) {
+// Values which don't map to a single CQL type - L, M, SS, NS, BS and NULL -
+// are stored as alternator_type::ENCODED, followed by a version byte and the
+// value in the binary encoding below. They used to be stored as
+// alternator_type::NOT_SUPPORTED_YET followed by the JSON text of the value,
+// and such items can still be read.
+//
+// An encoded value is a kind byte followed by a payload:
+//   S, B        uint32 length, then the string, or the bytes (not base64)
+//   N           uint32 length, then the number as serialized by decimal_type
+//   BOOL        one byte, 0 or 1
+//   NULL        nothing
+//   SS, NS, BS  uint32 length of the rest, uint32 count, then the payloads
+//               of the members
+//   L           uint32 length of the rest, uint32 count, then the elements
+//               as encoded values
+//   M           uint32 length of the rest, uint32 count, then for each member
+//               its name as an S payload followed by its encoded value
+// All integers are big endian. The length prefixes of nested values allow
+// skipping them without decoding. Map members are sorted by name, so that
+// equal maps have equal encodings, which EQ conditions rely on.
+namespace encoding {
+
+static constexpr int8_t version = 1;
+
+enum class kind : int8_t {
+    string, binary, number, boolean, null, list, map, string_set, number_set, binary_set
+};
+
+static const std::array<std::string_view, 10> kind_names = {
+    "S", "B", "N", "BOOL", "NULL", "L", "M", "SS", "NS", "BS"
+};
+
+static std::optional<kind> kind_from_name(std::string_view name) {
+    auto it = std::find(kind_names.begin(), kind_names.end(), name);
+    if (it == kind_names.end()) {
+        return std::nullopt;
+    }
+    return kind(it - kind_names.begin());
+}
+
+// Thrown for values the encoding doesn't understand. Those are stored as JSON,
+// like before the encoding existed, leaving their validation to whoever
+// reads them.
+struct unencodable {};
+
+class writer {
+    bytes_ostream& _out;
+public:
+    explicit writer(bytes_ostream& out) : _out(out) {}
+
+    void write_byte(int8_t b) {
+        _out.write(bytes_view(&b, 1));
+    }
+    void write_uint32(uint32_t v) {
+        v = net::hton(v);
+        _out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    }
+    void write_blob(bytes_view v) {
+        write_uint32(v.size());
+        _out.write(v);
+    }
+    void write_string(const rjson::value& v) {
+        if (!v.IsString()) {
+            throw unencodable{};
+        }
+        write_uint32(v.GetStringLength());
+        _out.write(v.GetString(), v.GetStringLength());
+    }
+    void write_number(const rjson::value& v) {
+        if (v.IsString()) {
+            write_blob(decimal_type->from_string(sstring_view(v.GetString(), v.GetStringLength())));
+        } else if (v.IsNumber()) {
+            write_blob(decimal_type->from_string(rjson::print(v)));
+        } else {
+            throw unencodable{};
+        }
+    }
+    void write_payload(kind k, const rjson::value& v) {
+        switch (k) {
+        case kind::string:
+            write_string(v);
+            break;
+        case kind::binary:
+            if (!v.IsString()) {
+                throw unencodable{};
+            }
+            write_blob(base64_decode(v));
+            break;
+        case kind::number:
+            write_number(v);
+            break;
+        case kind::boolean:
+            if (!v.IsBool()) {
+                throw unencodable{};
+            }
+            write_byte(v.GetBool());
+            break;
+        case kind::null:
+            break;
+        case kind::list:
+            if (!v.IsArray()) {
+                throw unencodable{};
+            }
+            write_nested(v.Size(), [&] {
+                for (auto& e : v.GetArray()) {
+                    write_value(e);
+                }
+            });
+            break;
+        case kind::map:
+            if (!v.IsObject()) {
+                throw unencodable{};
+            }
+            write_nested(v.MemberCount(), [&] {
+                std::vector<const rjson::value::Member*> members;
+                members.reserve(v.MemberCount());
+                for (auto& m : v.GetObject()) {
+                    members.push_back(&m);
+                }
+                std::sort(members.begin(), members.end(), [] (const rjson::value::Member* a, const rjson::value::Member* b) {
+                    return std::string_view(a->name.GetString(), a->name.GetStringLength()) < std::string_view(b->name.GetString(), b->name.GetStringLength());
+                });
+                for (auto* m : members) {
+                    write_string(m->name);
+                    write_value(m->value);
+                }
+            });
+            break;
+        case kind::string_set:
+        case kind::number_set:
+        case kind::binary_set: {
+            if (!v.IsArray()) {
+                throw unencodable{};
+            }
+            auto member_kind = k == kind::string_set ? kind::string : k == kind::number_set ? kind::number : kind::binary;
+            write_nested(v.Size(), [&] {
+                for (auto& e : v.GetArray()) {
+                    write_payload(member_kind, e);
+                }
+            });
+            break;
+        }
+        }
+    }
+    void write_value(const rjson::value& v) {
+        if (!v.IsObject() || v.MemberCount() != 1) {
+            throw unencodable{};
+        }
+        auto it = v.MemberBegin();
+        auto k = kind_from_name(std::string_view(it->name.GetString(), it->name.GetStringLength()));
+        if (!k) {
+            throw unencodable{};
+        }
+        write_byte(int8_t(*k));
+        write_payload(*k, it->value);
+    }
+private:
+    template <typename Func>
+    void write_nested(uint32_t count, Func&& write_elements) {
+        auto length = _out.write_place_holder(sizeof(uint32_t));
+        auto start = _out.size();
+        write_uint32(count);
+        write_elements();
+        auto len = net::hton(uint32_t(_out.size() - start));
+        std::copy_n(reinterpret_cast<const int8_t*>(&len), sizeof(len), length);
+    }
+};
+
+class reader {
+    bytes_view _v;
+public:
+    explicit reader(bytes_view v) : _v(v) {}
+
+    bool empty() const {
+        return _v.empty();
+    }
+    int8_t read_byte() {
+        return read_simple<int8_t>(_v);
+    }
+    bytes_view read_blob() {
+        auto len = read_simple<uint32_t>(_v);
+        return read_simple_bytes(_v, len);
+    }
+    rjson::value read_payload(kind k) {
+        switch (k) {
+        case kind::string: {
+            auto s = read_blob();
+            return rjson::from_string(reinterpret_cast<const char*>(s.data()), s.size());
+        }
+        case kind::binary:
+            return rjson::from_string(base64_encode(read_blob()));
+        case kind::number:
+            return rjson::from_string(to_json_string(*decimal_type, bytes(read_blob())));
+        case kind::boolean:
+            return rjson::value(bool(read_byte()));
+        case kind::null:
+            return rjson::value(true);
+        case kind::list: {
+            reader elements(read_blob());
+            auto count = elements.read_count();
+            rjson::value ret = rjson::empty_array();
+            for (uint32_t i = 0; i < count; ++i) {
+                rjson::push_back(ret, elements.read_value());
+            }
+            return ret;
+        }
+        case kind::map: {
+            reader members(read_blob());
+            auto count = members.read_count();
+            rjson::value ret = rjson::empty_object();
+            for (uint32_t i = 0; i < count; ++i) {
+                auto name = members.read_blob();
+                rjson::set_with_string_name(ret, std::string(reinterpret_cast<const char*>(name.data()), name.size()), members.read_value());
+            }
+            return ret;
+        }
+        case kind::string_set:
+        case kind::number_set:
+        case kind::binary_set: {
+            auto member_kind = k == kind::string_set ? kind::string : k == kind::number_set ? kind::number : kind::binary;
+            reader members(read_blob());
+            auto count = members.read_count();
+            rjson::value ret = rjson::empty_array();
+            for (uint32_t i = 0; i < count; ++i) {
+                rjson::push_back(ret, members.read_payload(member_kind));
+            }
+            return ret;
+        }
+        }
+        throw std::runtime_error(format("Unknown encoded alternator value kind {}", int8_t(k)));
+    }
+    rjson::value read_value() {
+        auto k = read_byte();
+        if (k < 0 || size_t(k) >= kind_names.size()) {
+            throw std::runtime_error(format("Unknown encoded alternator value kind {}", k));
+        }
+        rjson::value ret = rjson::empty_object();
+        rjson::set_with_string_name(ret, std::string(kind_names[k]), read_payload(kind(k)));
+        return ret;
+    }
+private:
+    uint32_t read_count() {
+        return read_simple<uint32_t>(_v);
+    }
+};
+
+}
+
+bytes serialize_item(const rjson::value& item, nested_value_format format) {
     if (item.IsNull() || item.MemberCount() != 1) {
         throw api_error("ValidationException", format("An item can contain only one attribute definition: {}", item));
     }
     auto it = item.MemberBegin();
     type_info type_info = type_info_from_string(it->name.GetString()); // JSON keys are guaranteed to be strings
 
-    if (type_info.atype == alternator_type::NOT_SUPPORTED_YET) {
+    if (type_info.atype == alternator_type::NOT_SUPPORTED_YET && format == nested_value_format::encoded) {
+        try {
+            bytes_ostream bo;
+            bo.write(bytes{int8_t(alternator_type::ENCODED), encoding::version});
+            encoding::writer(bo).write_value(item);
+            return bytes(bo.linearize());
+        } catch (const encoding::unencodable&) {
+            slogger.trace("Non-optimal serialization of type {}", it->name.GetString());
+            return bytes{int8_t(type_info.atype)} + to_bytes(rjson::print(item));
+        }
+    } else if (type_info.atype == alternator_type::NOT_SUPPORTED_YET) {
         slogger.trace("Non-optimal serialization of type {}", it->name.GetString());
         return bytes{int8_t(type_info.atype)} + to_bytes(rjson::print(item));
     }
@@ -138,12 +397,34 @@ rjson::value deserialize_item(bytes_view bv) {
         slogger.trace("Non-optimal deserialization of alternator type {}", int8_t(atype));
         return rjson::parse_raw(reinterpret_cast<const char *>(bv.data()), bv.size());
     }
+    if (atype == alternator_type::ENCODED) {
+        encoding::reader r(bv);
+        auto version = r.read_byte();
+        if (version != encoding::version) {
+            throw std::runtime_error(format("Unknown alternator value encoding version {}", version));
+        }
+        return r.read_value();
+    }
     type_representation type_representation = represent_type(atype);
     visit(*type_representation.dtype, to_json_visitor{deserialized, type_representation.ident, bv});
 
     return deserialized;
 }
 
+bool serialized_items_equal(bytes_view a, bytes_view b) {
+    if (a == b) {
+        return true;
+    }
+    if (a.empty() || b.empty() || a[0] == b[0]) {
+        return false;
+    }
+    // Only nested values have more than one serialization.
+    auto nested = [] (bytes_view v) {
+        return alternator_type(v[0]) == alternator_type::NOT_SUPPORTED_YET || alternator_type(v[0]) == alternator_type::ENCODED;
+    };
+    return nested(a) && nested(b) && deserialize_item(a) == deserialize_item(b);
+}
+
 std::string type_to_string(data_type type) {
     static thread_local std::unordered_map<data_type, std::string> types = {
         {utf8_type, "S"},
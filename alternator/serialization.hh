@@ -32,7 +32,7 @@
 namespace alternator {
 
 enum class alternator_type : int8_t {
-    S, B, BOOL, N, NOT_SUPPORTED_YET
+    S, B, BOOL, N, NOT_SUPPORTED_YET, ENCODED
 };
 
 struct type_info {
@@ -48,9 +48,20 @@ struct type_representation {
 type_info type_info_from_string(std::string type);
 type_representation represent_type(alternator_type atype);
 
-bytes serialize_item(const rjson::value& item);
+// How values which don't map to a single CQL type - L, M, SS, NS, BS and
+// NULL - are serialized. Nodes which predate the binary encoding can only
+// read JSON, so it is only written once the whole cluster supports it.
+enum class nested_value_format {
+    json, encoded
+};
+
+bytes serialize_item(const rjson::value& item, nested_value_format format);
 rjson::value deserialize_item(bytes_view bv);
 
+// Compares two serialized values, which may be serialized in different
+// formats. Values of the same format are compared as bytes.
+bool serialized_items_equal(bytes_view a, bytes_view b);
+
 std::string type_to_string(data_type type);
 
 bytes get_key_column_value(const rjson::value& item, const column_definition& column);
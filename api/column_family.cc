@@ -277,6 +277,13 @@ static double get_compression_ratio(column_family& cf) {
     return std::move(result).get();
 }
 
+static future<sstables::compression::read_stats> get_compression_read_stats(http_context& ctx, const sstring& name) {
+    auto uuid = get_uuid(name, ctx.db.local());
+    return ctx.db.map_reduce0([uuid](database& db) {
+        return db.find_column_family(uuid).compression_read_stats();
+    }, sstables::compression::read_stats(), std::plus<sstables::compression::read_stats>());
+}
+
 static std::vector<uint64_t> concat_sstable_count_per_level(std::vector<uint64_t> a, std::vector<uint64_t>&& b) {
     a.resize(std::max(a.size(), b.size()), 0UL);
     for (auto i = 0U; i < b.size(); i++) {
@@ -449,6 +456,20 @@ void set_column_family(http_context& ctx, routes& r) {
         utils::estimated_histogram_merge, utils_json::estimated_histogram());
     });
 
+    cf::get_decompression_ns_per_byte.set(r, [&ctx] (std::unique_ptr<request> req) {
+        return get_compression_read_stats(ctx, req->param["name"]).then([] (sstables::compression::read_stats stats) {
+            double ret = stats.decompressed_bytes ? double(stats.decompression_ns) / stats.decompressed_bytes : 0;
+            return make_ready_future<json::json_return_type>(ret);
+        });
+    });
+
+    cf::get_compression_read_amplification.set(r, [&ctx] (std::unique_ptr<request> req) {
+        return get_compression_read_stats(ctx, req->param["name"]).then([] (sstables::compression::read_stats stats) {
+            double ret = stats.requested_bytes ? double(stats.decompressed_bytes) / stats.requested_bytes : 0;
+            return make_ready_future<json::json_return_type>(ret);
+        });
+    });
+
     cf::get_all_compression_ratio.set(r, [] (std::unique_ptr<request> req) {
         //TBD
         unimplemented();
@@ -788,6 +788,30 @@ void set_storage_service(http_context& ctx, routes& r) {
         }
     });
 
+    ss::get_slow_query_profiles.set(r, [](std::unique_ptr<request> req) {
+        using profiles_list = std::vector<ss::slow_query_profile>;
+        return tracing::tracing::tracing_instance().map_reduce0([] (const tracing::tracing& local_tracing) {
+            profiles_list res;
+            for (auto& rec : local_tracing.slow_query_profiles()) {
+                ss::slow_query_profile p;
+                p.shard = engine().cpu_id();
+                p.started_at = rec.started_at_us;
+                p.total = rec.total_us;
+                p.parse = rec.phases_us[size_t(tracing::query_phase::parse)];
+                p.authorize = rec.phases_us[size_t(tracing::query_phase::authorize)];
+                p.execute = rec.phases_us[size_t(tracing::query_phase::execute)];
+                p.respond = rec.phases_us[size_t(tracing::query_phase::respond)];
+                res.push_back(std::move(p));
+            }
+            return res;
+        }, profiles_list(), [] (profiles_list res, profiles_list shard_res) {
+            std::move(shard_res.begin(), shard_res.end(), std::back_inserter(res));
+            return res;
+        }).then([] (profiles_list res) {
+            return make_ready_future<json::json_return_type>(std::move(res));
+        });
+    });
+
     ss::enable_auto_compaction.set(r, [&ctx](std::unique_ptr<request> req) {
         //TBD
         unimplemented();
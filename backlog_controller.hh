@@ -131,6 +131,33 @@ class flush_controller : public backlog_controller {
     {}
 };
 
+// Hints replay controller.
+//
+// The backlog is the fraction of the hints disk space quota occupied by hints files that are still
+// waiting to be replayed. Instead of adjusting shares the output is the replay rate, in MB/s, which
+// is handed over to the rate limiter of the hints resource manager: the closer we are to running out
+// of space, the more aggressive the replay becomes.
+class hints_replay_controller : public backlog_controller {
+    std::function<void(float)> _set_rate;
+protected:
+    virtual void update_controller(float rate) override {
+        _set_rate(rate);
+    }
+public:
+    static constexpr float min_rate_mb_per_sec = 4;
+    static constexpr float max_rate_mb_per_sec = 128;
+    hints_replay_controller(seastar::scheduling_group sg, const ::io_priority_class& iop, std::chrono::milliseconds interval,
+                            std::function<float()> current_backlog, std::function<void(float)> set_rate)
+        : backlog_controller(sg, iop, std::move(interval),
+          std::vector<backlog_controller::control_point>({{0.0, min_rate_mb_per_sec}, {0.25, 16}, {0.75, 64}, {1.0, max_rate_mb_per_sec}}),
+          std::move(current_backlog)
+        )
+        , _set_rate(std::move(set_rate))
+    {
+        _set_rate(_control_points.front().output);
+    }
+};
+
 class compaction_controller : public backlog_controller {
 public:
     static constexpr unsigned normalization_factor = 30;
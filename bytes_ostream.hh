@@ -254,7 +254,9 @@ class bytes_ostream {
         }
 
         while (!v.empty()) {
-            auto this_size = std::min(v.size(), size_t(max_chunk_size()));
+            // Keep the chunk, header included, within max_chunk_size(), so
+            // that writing a large value doesn't make large allocations.
+            auto this_size = std::min(v.size(), size_t(max_chunk_size() - sizeof(chunk)));
             std::copy_n(v.begin(), this_size, alloc_new(this_size));
             v.remove_prefix(this_size);
         }
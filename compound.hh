@@ -36,10 +36,31 @@ enum class allow_prefixes { no, yes };
 template<allow_prefixes AllowPrefixes = allow_prefixes::no>
 class compound_type final {
 private:
+    struct fixed_width_component {
+        fixed_width_order order;
+        uint32_t length;
+        bool reversed;
+    };
     const std::vector<data_type> _types;
     const bool _byte_order_equal;
     const bool _byte_order_comparable;
     const bool _is_reversed;
+    // Non-empty iff every component has a fixed_width_order, in which case
+    // components are compared without a virtual call.
+    const std::vector<fixed_width_component> _fixed_width_components;
+
+    static std::vector<fixed_width_component> make_fixed_width_components(const std::vector<data_type>& types) {
+        std::vector<fixed_width_component> ret;
+        for (auto&& t : types) {
+            auto order = t->get_fixed_width_order();
+            auto length = t->value_length_if_fixed();
+            if (order == fixed_width_order::none || !length || !*length) {
+                return {};
+            }
+            ret.push_back(fixed_width_component{order, *length, t->is_reversed()});
+        }
+        return ret;
+    }
 public:
     static constexpr bool is_prefixable = AllowPrefixes == allow_prefixes::yes;
     using prefix_type = compound_type<allow_prefixes::yes>;
@@ -53,6 +74,7 @@ class compound_type final {
             }))
         , _byte_order_comparable(false)
         , _is_reversed(_types.size() == 1 && _types[0]->is_reversed())
+        , _fixed_width_components(make_fixed_width_components(_types))
     { }
 
     compound_type(compound_type&&) = default;
@@ -211,11 +233,71 @@ class compound_type final {
                 return compare_unsigned(b1, b2);
             }
         }
+        if (has_fixed_width_components()) {
+            auto it1 = begin(b1);
+            auto end1 = end(b1);
+            auto it2 = begin(b2);
+            auto end2 = end(b2);
+            for (size_t i = 0; it1 != end1 && it2 != end2; ++it1, ++it2, ++i) {
+                auto c = compare_fixed_width_component(_fixed_width_components[i], _types[i], *it1, *it2);
+                if (c) {
+                    return c;
+                }
+            }
+            return int(it1 != end1) - int(it2 != end2);
+        }
         return lexicographical_tri_compare(_types.begin(), _types.end(),
             begin(b1), end(b1), begin(b2), end(b2), [] (auto&& type, auto&& v1, auto&& v2) {
                 return type->compare(v1, v2);
             });
     }
+    // Returns an encoding of v such that compare_unsigned() of the encodings of two values
+    // has the same sign as compare(), see abstract_type::serialize_comparable().
+    bytes to_comparable_bytes(bytes_view v) const {
+        std::vector<int8_t> out;
+        out.reserve(v.size() + _types.size() * 2);
+        auto t = _types.begin();
+        for (auto&& component : components(v)) {
+            assert(t != _types.end());
+            (*t++)->serialize_comparable(component, out);
+        }
+        return bytes(out.data(), out.size());
+    }
+    // True iff all components are fixed-width and can be compared without a virtual call,
+    // see prefix_equality_tri_compare().
+    bool has_fixed_width_components() const {
+        return !_fixed_width_components.empty();
+    }
+    // Same as ::prefix_equality_tri_compare() applied on the components of b1 and b2
+    // with abstract_type::compare(), but avoids the virtual call for each component.
+    // Requires has_fixed_width_components().
+    int prefix_equality_tri_compare(bytes_view b1, bytes_view b2) const {
+        auto it1 = begin(b1);
+        auto end1 = end(b1);
+        auto it2 = begin(b2);
+        auto end2 = end(b2);
+        size_t i = 0;
+        while (it1 != end1 && it2 != end2) {
+            auto c = compare_fixed_width_component(_fixed_width_components[i], _types[i], *it1, *it2);
+            if (c) {
+                return c;
+            }
+            ++it1;
+            ++it2;
+            ++i;
+        }
+        return 0;
+    }
+private:
+    static int compare_fixed_width_component(const fixed_width_component& fc, const data_type& type, bytes_view v1, bytes_view v2) {
+        if (v1.size() != fc.length || v2.size() != fc.length) {
+            // Empty or malformed value, let the type deal with it.
+            return type->compare(v1, v2);
+        }
+        auto c = tri_compare_fixed_width(fc.order, v1, v2);
+        return fc.reversed ? -c : c;
+    }
+public:
     // Retruns true iff given prefix has no missing components
     bool is_full(bytes_view v) const {
         assert(AllowPrefixes == allow_prefixes::yes);
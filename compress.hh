@@ -116,6 +116,13 @@ class compression_parameters {
 
     void validate();
     std::map<sstring, sstring> get_options() const;
+
+    // The same parameters, with a different chunk length.
+    compression_parameters with_chunk_length(int32_t chunk_length) const {
+        auto ret = *this;
+        ret._chunk_length = chunk_length;
+        return ret;
+    }
     bool operator==(const compression_parameters& other) const;
     bool operator!=(const compression_parameters& other) const;
 
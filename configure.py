@@ -263,6 +263,7 @@ modes = {
 scylla_tests = [
     'test/boost/UUID_test',
     'test/boost/aggregate_fcts_test',
+    'test/boost/alternator_serialization_test',
     'test/boost/allocation_strategy_test',
     'test/boost/anchorless_list_test',
     'test/boost/auth_passwords_test',
@@ -273,6 +274,7 @@ scylla_tests = [
     'test/boost/broken_sstable_test',
     'test/boost/bytes_ostream_test',
     'test/boost/cache_flat_mutation_reader_test',
+    'test/boost/cache_warmer_test',
     'test/boost/caching_options_test',
     'test/boost/canonical_mutation_test',
     'test/boost/cartesian_product_test',
@@ -307,6 +309,8 @@ scylla_tests = [
     'test/boost/gossip_test',
     'test/boost/gossiping_property_file_snitch_test',
     'test/boost/hash_test',
+    'test/boost/hints_manager_test',
+    'test/boost/hints_resource_manager_test',
     'test/boost/idl_test',
     'test/boost/input_stream_test',
     'test/boost/json_cql_query_test',
@@ -375,6 +379,7 @@ scylla_tests = [
     'test/manual/partition_data_test',
     'test/manual/row_locker_test',
     'test/manual/streaming_histogram_test',
+    'test/perf/perf_alternator_json',
     'test/perf/perf_cache_eviction',
     'test/perf/perf_cql_parser',
     'test/perf/perf_fast_forward',
@@ -396,6 +401,7 @@ perf_tests = [
     'test/perf/perf_mutation_fragment',
     'test/perf/perf_idl',
     'test/perf/perf_vint',
+    'test/perf/perf_comparable_bytes',
 ]
 
 apps = [
@@ -598,6 +604,7 @@ scylla_core = (['database.cc',
                 'types.cc',
                 'validation.cc',
                 'service/priority_manager.cc',
+                'service/qos/service_level_controller.cc',
                 'service/migration_manager.cc',
                 'service/storage_proxy.cc',
                 'service/paxos/proposal.cc',
@@ -636,6 +643,7 @@ scylla_core = (['database.cc',
                 'db/commitlog/commitlog_replayer.cc',
                 'db/commitlog/commitlog_entry.cc',
                 'db/data_listeners.cc',
+                'db/cache_warmer.cc',
                 'db/hints/manager.cc',
                 'db/hints/resource_manager.cc',
                 'db/config.cc',
@@ -915,6 +923,7 @@ tests_not_using_seastar_test_framework = set([
     'test/boost/small_vector_test',
     'test/manual/gossip',
     'test/manual/message',
+    'test/perf/perf_alternator_json',
     'test/perf/perf_cache_eviction',
     'test/perf/perf_cql_parser',
     'test/perf/perf_hash',
@@ -946,6 +955,8 @@ perf_tests_seastar_deps = [
 for t in perf_tests:
     deps[t] = [t + '.cc'] + scylla_tests_dependencies + perf_tests_seastar_deps
 
+deps['test/perf/perf_alternator_json'] += ['alternator/rjson.cc']
+deps['test/boost/alternator_serialization_test'] += alternator
 deps['test/boost/sstable_test'] += ['test/lib/sstable_utils.cc', 'test/lib/normalizing_reader.cc']
 deps['test/boost/sstable_datafile_test'] += ['test/lib/sstable_utils.cc', 'test/lib/normalizing_reader.cc']
 deps['test/boost/mutation_reader_test'] += ['test/lib/sstable_utils.cc']
@@ -105,6 +105,15 @@ class cql_statement {
     virtual bool depends_on_column_family(const sstring& cf_name) const = 0;
 
     virtual shared_ptr<const metadata> get_result_metadata() const = 0;
+
+    // An estimate of the memory the statement holds on to, which sizes its
+    // entry in the prepared statements cache.
+    virtual size_t memory_usage() const {
+        return default_memory_usage;
+    }
+
+    // Charged for statements which don't estimate their own memory usage.
+    static constexpr size_t default_memory_usage = 1024;
 };
 
 class cql_statement_no_metadata : public cql_statement {
@@ -32,8 +32,7 @@ using prepared_cache_entry = std::unique_ptr<statements::prepared_statement>;
 
 struct prepared_cache_entry_size {
     size_t operator()(const prepared_cache_entry& val) {
-        // TODO: improve the size approximation
-        return 10000;
+        return val->memory_usage();
     }
 };
 
@@ -82,6 +81,8 @@ class prepared_statements_cache {
 public:
     struct stats {
         uint64_t prepared_cache_evictions = 0;
+        uint64_t prepared_cache_hits = 0;
+        uint64_t prepared_cache_misses = 0;
     };
 
     static stats& shard_stats() {
@@ -90,8 +91,12 @@ class prepared_statements_cache {
     }
 
     struct prepared_cache_stats_updater {
-        static void inc_hits() noexcept {}
-        static void inc_misses() noexcept {}
+        static void inc_hits() noexcept {
+            ++shard_stats().prepared_cache_hits;
+        }
+        static void inc_misses() noexcept {
+            ++shard_stats().prepared_cache_misses;
+        }
         static void inc_blocks() noexcept {}
         static void inc_evictions() noexcept {
             ++shard_stats().prepared_cache_evictions;
@@ -139,6 +144,18 @@ class prepared_statements_cache {
         return boost::make_transform_iterator(_cache.find(key.key()), _value_extractor_fn);
     }
 
+    /// \brief Keeps the statement from being evicted or expiring as if it was prepared again.
+    ///
+    /// Meant to be called on every execution of the statement.
+    void touch(const key_type& key) noexcept {
+        _cache.touch(key.key());
+    }
+
+    /// \brief Like touch(key), for the statement an iterator returned by find() points to.
+    void touch(iterator it) noexcept {
+        _cache.touch(it.base());
+    }
+
     iterator end() {
         return boost::make_transform_iterator(_cache.end(), _value_extractor_fn);
     }
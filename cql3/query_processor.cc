@@ -345,6 +345,22 @@ query_processor::query_processor(service::storage_proxy& proxy, database& db, qu
                             [] { return prepared_statements_cache::shard_stats().prepared_cache_evictions; },
                             sm::description("Counts the number of prepared statements cache entries evictions.")),
 
+                    sm::make_derive(
+                            "prepared_cache_hits",
+                            [] { return prepared_statements_cache::shard_stats().prepared_cache_hits; },
+                            sm::description("Counts the number of PREPARE requests for statements which were found in the prepared statements cache.")),
+
+                    sm::make_derive(
+                            "prepared_cache_misses",
+                            [] { return prepared_statements_cache::shard_stats().prepared_cache_misses; },
+                            sm::description("Counts the number of PREPARE requests for statements which were not found in the prepared statements cache and had to be prepared.")),
+
+                    sm::make_derive(
+                            "prepared_not_found",
+                            _stats.prepared_not_found,
+                            sm::description("Counts the number of EXECUTE requests for statements which were not found in the prepared statements cache. "
+                                            "Each one makes the client prepare the statement again.")),
+
                     sm::make_gauge(
                             "prepared_cache_size",
                             [this] { return _prepared_cache.size(); },
@@ -457,7 +473,9 @@ future<::shared_ptr<result_message>>
 query_processor::process(const sstring_view& query_string, service::query_state& query_state, query_options& options) {
     log.trace("process: \"{}\"", query_string);
     tracing::trace(query_state.get_trace_state(), "Parsing a statement");
+    auto parse_start = tracing::query_profile::clock::now();
     auto p = get_statement(query_string, query_state.get_client_state());
+    query_state.get_query_profile().add(tracing::query_phase::parse, tracing::query_profile::clock::now() - parse_start);
     auto cql_statement = p->statement;
     if (cql_statement->get_bound_terms() != options.get_values_count()) {
         const auto msg = format("Invalid amount of bind variables: expected {:d} received {:d}",
@@ -481,7 +499,9 @@ query_processor::process_statement_unprepared(
         ::shared_ptr<cql_statement> statement,
         service::query_state& query_state,
         const query_options& options) {
-    return statement->check_access(query_state.get_client_state()).then([this, statement, &query_state, &options] () mutable {
+    auto authorize_start = tracing::query_profile::clock::now();
+    return statement->check_access(query_state.get_client_state()).then([this, statement, &query_state, &options, authorize_start] () mutable {
+        query_state.get_query_profile().add(tracing::query_phase::authorize, tracing::query_profile::clock::now() - authorize_start);
         return process_authorized_statement(std::move(statement), query_state, options);
     });
 }
@@ -497,7 +517,9 @@ query_processor::process_statement_prepared(
     ::shared_ptr<cql_statement> statement = prepared->statement;
     future<> fut = make_ready_future<>();
     if (needs_authorization) {
-        fut = statement->check_access(query_state.get_client_state()).then([this, &query_state, prepared = std::move(prepared), cache_key = std::move(cache_key)] () mutable {
+        auto authorize_start = tracing::query_profile::clock::now();
+        fut = statement->check_access(query_state.get_client_state()).then([this, &query_state, prepared = std::move(prepared), cache_key = std::move(cache_key), authorize_start] () mutable {
+            query_state.get_query_profile().add(tracing::query_phase::authorize, tracing::query_profile::clock::now() - authorize_start);
             return _authorized_prepared_cache.insert(*query_state.get_client_state().user(), std::move(cache_key), std::move(prepared)).handle_exception([this] (auto eptr) {
                 log.error("failed to cache the entry", eptr);
             });
@@ -515,11 +537,13 @@ query_processor::process_authorized_statement(const ::shared_ptr<cql_statement>
 
     ++_stats.queries_by_cl[size_t(options.get_consistency())];
 
+    auto execute_start = tracing::query_profile::clock::now();
     statement->validate(_proxy, client_state);
 
     auto fut = statement->execute(_proxy, query_state, options);
 
-    return fut.then([statement] (auto msg) {
+    return fut.then([statement, &query_state, execute_start] (auto msg) {
+        query_state.get_query_profile().add(tracing::query_phase::execute, tracing::query_profile::clock::now() - execute_start);
         if (msg) {
             return make_ready_future<::shared_ptr<result_message>>(std::move(msg));
         }
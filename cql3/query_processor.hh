@@ -112,6 +112,7 @@ class query_processor {
 
     struct stats {
         uint64_t prepare_invocations = 0;
+        uint64_t prepared_not_found = 0;
         uint64_t queries_by_cl[size_t(db::consistency_level::MAX_VALUE) + 1] = {};
     } _stats;
 
@@ -163,7 +164,9 @@ class query_processor {
             auto it = _authorized_prepared_cache.find(*user, key);
             if (it != _authorized_prepared_cache.end()) {
                 try {
-                    return it->get()->checked_weak_from_this();
+                    auto ps = it->get()->checked_weak_from_this();
+                    _prepared_cache.touch(key);
+                    return ps;
                 } catch (seastar::checked_ptr_is_null_exception&) {
                     // If the prepared statement got invalidated - remove the corresponding authorized_prepared_statements_cache entry as well.
                     _authorized_prepared_cache.remove(*user, key);
@@ -176,8 +179,10 @@ class query_processor {
     statements::prepared_statement::checked_weak_ptr get_prepared(const prepared_cache_key_type& key) {
         auto it = _prepared_cache.find(key);
         if (it == _prepared_cache.end()) {
+            ++_stats.prepared_not_found;
             return statements::prepared_statement::checked_weak_ptr();
         }
+        _prepared_cache.touch(it);
         return *it;
     }
 
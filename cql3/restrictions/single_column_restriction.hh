@@ -42,6 +42,7 @@
 #pragma once
 
 #include <optional>
+#include <functional>
 
 #include "cql3/restrictions/restriction.hh"
 #include "cql3/restrictions/term_slice.hh"
@@ -444,11 +445,20 @@ class single_column_restriction::LIKE final : public single_column_restriction {
 
 // This holds CONTAINS, CONTAINS_KEY, and map[key] = value restrictions because we might want to have any combination of them.
 class single_column_restriction::contains final : public single_column_restriction {
+public:
+    // Tells whether a map entry value stored in the column equals an entry value of the restriction.
+    using entry_value_equal_fn = std::function<bool(bytes_view stored, bytes_view expected)>;
 private:
     std::vector<::shared_ptr<term>> _values;
     std::vector<::shared_ptr<term>> _keys;
     std::vector<::shared_ptr<term>> _entry_keys;
     std::vector<::shared_ptr<term>> _entry_values;
+    // Compares entry values instead of the value type of the map, if set.
+    entry_value_equal_fn _entry_value_equal;
+
+    bool entry_value_equal(const abstract_type& value_type, bytes_view stored, bytes_view expected) const {
+        return _entry_value_equal ? _entry_value_equal(stored, expected) : value_type.compare(stored, expected) == 0;
+    }
 public:
     contains(const column_definition& column_def, ::shared_ptr<term> t, bool is_key)
             : single_column_restriction(op::CONTAINS, column_def) {
@@ -466,6 +476,14 @@ class single_column_restriction::contains final : public single_column_restricti
         _entry_values.emplace_back(std::move(map_value));
     }
 
+    // A map entry restriction for maps which can hold equal values with different serializations,
+    // which entry_value_equal has to recognize.
+    contains(const column_definition& column_def, ::shared_ptr<term> map_key, ::shared_ptr<term> map_value, entry_value_equal_fn entry_value_equal)
+            : contains(column_def, std::move(map_key), std::move(map_value))
+    {
+        _entry_value_equal = std::move(entry_value_equal);
+    }
+
     virtual std::vector<bytes_opt> values(const query_options& options) const override {
         return bind_and_get(_values, options);
     }
@@ -481,6 +499,9 @@ class single_column_restriction::contains final : public single_column_restricti
         std::copy(other->_keys.begin(), other->_keys.end(), std::back_inserter(_keys));
         std::copy(other->_entry_keys.begin(), other->_entry_keys.end(), std::back_inserter(_entry_keys));
         std::copy(other->_entry_values.begin(), other->_entry_values.end(), std::back_inserter(_entry_values));
+        if (!_entry_value_equal) {
+            _entry_value_equal = other->_entry_value_equal;
+        }
     }
 
 #if 0
@@ -348,6 +348,17 @@ bool statement_restrictions::uses_function(const sstring& ks_name, const sstring
             || _nonprimary_key_restrictions->uses_function(ks_name, function_name);
 }
 
+size_t statement_restrictions::memory_usage() const {
+    // A rough estimate: restrictions are mostly single column ones, and a
+    // slice, the largest of them, holds two bound markers. Literal values
+    // aren't looked at.
+    constexpr size_t restriction_size = sizeof(single_column_restriction::slice) + 2 * sizeof(constants::marker);
+    auto restricted_columns = _partition_key_restrictions->size()
+            + _clustering_columns_restrictions->size()
+            + _nonprimary_key_restrictions->size();
+    return sizeof(*this) + (restricted_columns + _index_restrictions.size()) * restriction_size;
+}
+
 const std::vector<::shared_ptr<restrictions>>& statement_restrictions::index_restrictions() const {
     return _index_restrictions;
 }
@@ -775,12 +786,12 @@ bool single_column_restriction::contains::is_satisfied_by(const schema& schema,
             if (found == end) {
                 return false;
             }
-            auto cmp = with_linearized(*map_value, [&] (bytes_view map_value_bv) {
+            auto equal = with_linearized(*map_value, [&] (bytes_view map_value_bv) {
               return found->second.value().with_linearized([&] (bytes_view value_bv) {
-                return element_type->compare(value_bv, map_value_bv);
+                return entry_value_equal(*element_type, value_bv, map_value_bv);
               });
             });
-            if (cmp != 0) {
+            if (!equal) {
                 return false;
             }
         }
@@ -870,9 +881,9 @@ bool single_column_restriction::contains::is_satisfied_by(bytes_view collection_
               });
             });
             if (found == data_map.end()
-                || with_linearized(*map_value, [&] (bytes_view map_value_bv) {
-                     return element_type->compare(found->second.serialize(), map_value_bv);
-                   }) != 0) {
+                || !with_linearized(*map_value, [&] (bytes_view map_value_bv) {
+                     return entry_value_equal(*element_type, found->second.serialize(), map_value_bv);
+                   })) {
                 return false;
             }
         }
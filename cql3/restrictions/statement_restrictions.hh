@@ -125,6 +125,9 @@ class statement_restrictions {
 public:
     bool uses_function(const sstring& ks_name, const sstring& function_name) const;
 
+    // An estimate of the memory held by the restrictions.
+    size_t memory_usage() const;
+
     const std::vector<::shared_ptr<restrictions>>& index_restrictions() const;
 
     /**
@@ -162,6 +162,9 @@ concept bool ResultVisitor = requires(Visitor& visitor) {
 
 )
 
+// Holds linearized cell values. Results which don't need post-processing are
+// served from a result_generator instead, which hands the response serializer
+// the fragments of query::result without linearizing them.
 class result_set {
     ::shared_ptr<metadata> _metadata;
     std::deque<std::vector<bytes_opt>> _rows;
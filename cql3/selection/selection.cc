@@ -241,6 +241,11 @@ ::shared_ptr<selection> selection::for_columns(schema_ptr schema, std::vector<co
     return simple_selection::make(schema, std::move(columns), false);
 }
 
+size_t selection::memory_usage() const {
+    // Each column also has its specification in the result metadata.
+    return sizeof(*this) + _columns.size() * (sizeof(const column_definition*) + sizeof(column_specification));
+}
+
 uint32_t selection::add_column_for_post_processing(const column_definition& c) {
     _columns.push_back(&c);
     _metadata->add_non_serialized_column(c.column_specification);
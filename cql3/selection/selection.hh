@@ -185,6 +185,9 @@ class selection {
         return false;
     }
 
+    // An estimate of the memory held by the selection.
+    size_t memory_usage() const;
+
     query::partition_slice::option_set get_query_options();
 private:
     static bool processes_selection(const std::vector<::shared_ptr<raw_selector>>& raw_selectors) {
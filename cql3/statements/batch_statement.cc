@@ -178,6 +178,14 @@ void batch_statement::validate(service::storage_proxy& proxy, const service::cli
     }
 }
 
+size_t batch_statement::memory_usage() const {
+    auto size = sizeof(*this) + _statements.size() * sizeof(single_statement);
+    for (auto& s : _statements) {
+        size += s.statement->memory_usage();
+    }
+    return size;
+}
+
 const std::vector<batch_statement::single_statement>& batch_statement::get_statements()
 {
     return _statements;
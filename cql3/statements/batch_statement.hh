@@ -120,6 +120,8 @@ class batch_statement : public cql_statement_opt_metadata {
 
     virtual bool uses_function(const sstring& ks_name, const sstring& function_name) const override;
 
+    virtual size_t memory_usage() const override;
+
     virtual bool depends_on_keyspace(const sstring& ks_name) const override;
 
     virtual bool depends_on_column_family(const sstring& cf_name) const override;
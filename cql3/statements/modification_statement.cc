@@ -44,6 +44,7 @@
 #include "cql3/statements/raw/modification_statement.hh"
 #include "cql3/statements/prepared_statement.hh"
 #include "cql3/restrictions/single_column_restriction.hh"
+#include "cql3/constants.hh"
 #include "validation.hh"
 #include "db/consistency_level_validations.hh"
 #include <seastar/core/shared_ptr.hh>
@@ -87,6 +88,16 @@ modification_statement::modification_statement(statement_type type_, uint32_t bo
     , _ks_sel(::is_system_keyspace(schema_->ks_name()) ? ks_selector::SYSTEM : ks_selector::NONSYSTEM)
 { }
 
+size_t modification_statement::memory_usage() const {
+    // A rough estimate: an operation holds a bound marker, and a condition
+    // up to two of them. Literal values and IN lists aren't looked at.
+    constexpr size_t operation_size = sizeof(operation) + sizeof(constants::marker);
+    constexpr size_t condition_size = sizeof(column_condition) + 2 * sizeof(constants::marker);
+    auto conditions = _regular_conditions.size() + _static_conditions.size();
+    return sizeof(*this) + _column_operations.size() * operation_size + conditions * condition_size
+            + (_restrictions ? _restrictions->memory_usage() : 0);
+}
+
 bool modification_statement::uses_function(const sstring& ks_name, const sstring& function_name) const {
     if (attrs->uses_function(ks_name, function_name)) {
         return true;
@@ -296,6 +307,7 @@ static thread_local inheriting_concrete_execution_stage<
 
 future<::shared_ptr<cql_transport::messages::result_message>>
 modification_statement::execute(service::storage_proxy& proxy, service::query_state& qs, const query_options& options) const {
+    qs.get_query_profile().set_table(s->id());
     return modify_stage(this, seastar::ref(proxy), seastar::ref(qs), seastar::cref(options));
 }
 
@@ -151,6 +151,8 @@ class modification_statement : public cql_statement_opt_metadata {
 
     virtual bool uses_function(const sstring& ks_name, const sstring& function_name) const override;
 
+    virtual size_t memory_usage() const override;
+
     virtual bool require_full_clustering_key() const = 0;
 
     virtual bool allow_clustering_key_slices() const = 0;
@@ -85,6 +85,14 @@ prepared_statement::prepared_statement(::shared_ptr<cql_statement>&& statement_)
     : prepared_statement(statement_, std::vector<::shared_ptr<column_specification>>(), std::vector<uint16_t>())
 { }
 
+size_t prepared_statement::memory_usage() const {
+    return sizeof(*this)
+            + raw_cql_statement.size()
+            + bound_names.size() * (sizeof(::shared_ptr<column_specification>) + sizeof(column_specification))
+            + partition_key_bind_indices.size() * sizeof(uint16_t)
+            + statement->memory_usage();
+}
+
 }
 
 }
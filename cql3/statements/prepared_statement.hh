@@ -81,6 +81,10 @@ class prepared_statement : public weakly_referencable<prepared_statement> {
 
     prepared_statement(::shared_ptr<cql_statement>&& statement_);
 
+    // An estimate of the memory taken by the statement, its query string,
+    // restrictions and selection included.
+    size_t memory_usage() const;
+
     checked_weak_ptr checked_weak_from_this() {
         return checked_weak_ptr(this->weak_from_this());
     }
@@ -161,6 +161,10 @@ bool select_statement::uses_function(const sstring& ks_name, const sstring& func
         || (_limit && _limit->uses_function(ks_name, function_name));
 }
 
+size_t select_statement::memory_usage() const {
+    return sizeof(*this) + _selection->memory_usage() + _restrictions->memory_usage();
+}
+
 ::shared_ptr<const cql3::metadata> select_statement::get_result_metadata() const {
     // FIXME: COUNT needs special result metadata handling.
     return _selection->get_result_metadata();
@@ -289,6 +293,7 @@ select_statement::execute(service::storage_proxy& proxy,
                              service::query_state& state,
                              const query_options& options) const
 {
+    state.get_query_profile().set_table(_schema->id());
     return select_stage(this, seastar::ref(proxy), seastar::ref(state), seastar::cref(options));
 }
 
@@ -114,6 +114,7 @@ protected :
     virtual bool uses_function(const sstring& ks_name, const sstring& function_name) const override;
 
     virtual ::shared_ptr<const cql3::metadata> get_result_metadata() const override;
+    virtual size_t memory_usage() const override;
     virtual uint32_t get_bound_terms() const override;
     virtual future<> check_access(const service::client_state& state) const override;
     virtual void validate(service::storage_proxy&, const service::client_state& state) const override;
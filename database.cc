@@ -351,12 +351,21 @@ database::setup_metrics() {
                        sm::description("Counts sstables that survived the clustering key filtering. "
                                        "High value indicates that bloom filter is not very efficient and still have to access a lot of sstables to get data.")),
 
+        sm::make_derive("partition_tombstone_skipped_sstables", _cf_stats.sstables_skipped_by_partition_tombstone,
+                       sm::description("Counts sstables which single partition reads didn't read rows from, because a partition tombstone in a newer sstable shadows all their data.")),
+
+        sm::make_derive("timestamp_skipped_sstables", _cf_stats.sstables_skipped_by_timestamp,
+                       sm::description("Counts sstables which single row reads didn't read, because newer sstables already supersede all their data for the row.")),
+
         sm::make_derive("dropped_view_updates", _cf_stats.dropped_view_updates,
                        sm::description("Counts the number of view updates that have been dropped due to cluster overload. ")),
 
        sm::make_derive("view_building_paused", _cf_stats.view_building_paused,
                       sm::description("Counts the number of times view building process was paused (e.g. due to node unavailability). ")),
 
+       sm::make_derive("view_building_steps", _cf_stats.view_building_steps,
+                      sm::description("Counts the number of view building steps executed, each consuming up to a batch of base rows. ")),
+
         sm::make_derive("total_writes", _stats->total_writes,
                        sm::description("Counts the total number of successful write operations performed by this shard.")),
 
@@ -404,11 +413,11 @@ database::setup_metrics() {
                        sm::description("Counts the number of times the sstable read queue was overloaded. "
                                        "A non-zero value indicates that we have to drop read requests because they arrive faster than we can serve them.")),
 
-        sm::make_gauge("active_reads", [this] { return max_count_concurrent_reads - _read_concurrency_sem.available_resources().count; },
+        sm::make_gauge("active_reads", [this] { return _read_concurrency_sem.total_resources().count - _read_concurrency_sem.available_resources().count; },
                        sm::description("Holds the number of currently active read operations. "),
                        {user_label_instance}),
 
-        sm::make_gauge("active_reads_memory_consumption", [this] { return max_memory_concurrent_reads() - _read_concurrency_sem.available_resources().memory; },
+        sm::make_gauge("active_reads_memory_consumption", [this] { return _read_concurrency_sem.total_resources().memory - _read_concurrency_sem.available_resources().memory; },
                        sm::description(seastar::format("Holds the amount of memory consumed by currently active read operations. "
                                                        "If this value gets close to {} we are likely to start dropping new read requests. "
                                                        "In that case sstable_read_queue_overloads is going to get a non-zero value.", max_memory_concurrent_reads())),
@@ -428,6 +437,19 @@ database::setup_metrics() {
                                        " to be able to admit new ones, if there is a shortage of permits."),
                        {user_label_instance}),
 
+        sm::make_histogram("short_reads_admission_wait", [this] { return _read_concurrency_sem.get_admission_stats().short_read_wait.get_histogram(std::chrono::microseconds(100)); },
+                       sm::description("Histogram of the time single partition reads waited for admission, in microseconds."),
+                       {user_label_instance}),
+
+        sm::make_histogram("long_reads_admission_wait", [this] { return _read_concurrency_sem.get_admission_stats().long_read_wait.get_histogram(std::chrono::microseconds(100)); },
+                       sm::description("Histogram of the time range scans waited for admission, in microseconds."),
+                       {user_label_instance}),
+
+        sm::make_derive("long_reads_admission_promotions", [this] { return _read_concurrency_sem.get_admission_stats().long_read_promotions; },
+                       sm::description("The number of times a range scan was bypassed by so many single partition reads"
+                                       " that it was given precedence over them."),
+                       {user_label_instance}),
+
         sm::make_gauge("active_reads", [this] { return max_count_streaming_concurrent_reads - _streaming_concurrency_sem.available_resources().count; },
                        sm::description("Holds the number of currently active read operations issued on behalf of streaming "),
                        {streaming_label_instance}),
@@ -532,6 +554,83 @@ database::~database() {
     _read_concurrency_sem.clear_inactive_reads();
     _streaming_concurrency_sem.clear_inactive_reads();
     _system_read_concurrency_sem.clear_inactive_reads();
+    for (auto& [id, sem] : _service_level_read_concurrency_sems) {
+        sem->clear_inactive_reads();
+    }
+}
+
+void database::add_service_level_read_concurrency_semaphore(const io_priority_class& pc, const sstring& name) {
+    if (_service_level_read_concurrency_sems.count(pc.id())) {
+        return;
+    }
+    // The queue starts empty, it gets its part of the user read budget from
+    // set_user_read_shares().
+    _service_level_read_concurrency_sems.emplace(pc.id(), std::make_unique<reader_concurrency_semaphore>(0,
+        0,
+        format("_read_concurrency_sem_{}", name),
+        max_inactive_queue_length(),
+        [this] {
+            ++_stats->sstable_read_queue_overloaded;
+        }));
+}
+
+void database::register_service_level_read_metrics(const io_priority_class& pc, const sstring& service_level) {
+    auto& s = *_service_level_read_concurrency_sems.at(pc.id());
+    // Drops the metrics of the service level the queue belonged to before.
+    unregister_service_level_read_metrics(pc);
+
+    namespace sm = seastar::metrics;
+    auto class_label_instance = class_label(format("sl_{}", service_level));
+    auto& metrics = _service_level_read_metrics[pc.id()];
+    metrics.add_group("database", {
+        sm::make_gauge("active_reads", [&s] { return s.total_resources().count - s.available_resources().count; },
+                       sm::description("Holds the number of currently active read operations. "),
+                       {class_label_instance}),
+
+        sm::make_gauge("active_reads_memory_consumption", [&s] { return s.total_resources().memory - s.available_resources().memory; },
+                       sm::description("Holds the amount of memory consumed by currently active read operations. "),
+                       {class_label_instance}),
+
+        sm::make_gauge("queued_reads", [&s] { return s.waiters(); },
+                       sm::description("Holds the number of currently queued read operations."),
+                       {class_label_instance}),
+
+        sm::make_histogram("short_reads_admission_wait", [&s] { return s.get_admission_stats().short_read_wait.get_histogram(std::chrono::microseconds(100)); },
+                       sm::description("Histogram of the time single partition reads waited for admission, in microseconds."),
+                       {class_label_instance}),
+
+        sm::make_histogram("long_reads_admission_wait", [&s] { return s.get_admission_stats().long_read_wait.get_histogram(std::chrono::microseconds(100)); },
+                       sm::description("Histogram of the time range scans waited for admission, in microseconds."),
+                       {class_label_instance}),
+    });
+}
+
+void database::unregister_service_level_read_metrics(const io_priority_class& pc) {
+    _service_level_read_metrics.erase(pc.id());
+}
+
+void database::set_user_read_shares(int32_t default_shares, const std::unordered_map<unsigned, int32_t>& shares_by_class) {
+    using resources = reader_concurrency_semaphore::resources;
+    const auto max_count = static_cast<int>(max_count_concurrent_reads);
+    const auto max_memory = static_cast<ssize_t>(max_memory_concurrent_reads());
+    // Enough for a single reader, so that no queue is starved completely.
+    const auto min_memory = max_memory / max_count;
+
+    int64_t total_shares = default_shares;
+    for (auto& [id, shares] : shares_by_class) {
+        total_shares += shares;
+    }
+    auto remaining = resources(max_count, max_memory);
+    for (auto& [id, sem] : _service_level_read_concurrency_sems) {
+        auto it = shares_by_class.find(id);
+        auto shares = it == shares_by_class.end() ? 0 : it->second;
+        auto r = resources(std::max<int>(1, max_count * shares / total_shares),
+                std::max<ssize_t>(min_memory, max_memory * shares / total_shares));
+        sem->set_total_resources(r);
+        remaining -= r;
+    }
+    // The default queue takes what is left, which also absorbs the rounding.
+    _read_concurrency_sem.set_total_resources(resources(std::max(1, remaining.count), std::max(min_memory, remaining.memory)));
 }
 
 void database::update_version(const utils::UUID& version) {
@@ -904,6 +1003,7 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.streaming_dirty_memory_manager = _config.streaming_dirty_memory_manager;
     cfg.read_concurrency_semaphore = _config.read_concurrency_semaphore;
     cfg.streaming_read_concurrency_semaphore = _config.streaming_read_concurrency_semaphore;
+    cfg.service_level_read_concurrency_semaphores = _config.service_level_read_concurrency_semaphores;
     cfg.cf_stats = _config.cf_stats;
     cfg.enable_incremental_backups = _config.enable_incremental_backups;
     cfg.compaction_scheduling_group = _config.compaction_scheduling_group;
@@ -913,6 +1013,8 @@ keyspace::make_column_family_config(const schema& s, const database& db) const {
     cfg.streaming_scheduling_group = _config.streaming_scheduling_group;
     cfg.statement_scheduling_group = _config.statement_scheduling_group;
     cfg.enable_metrics_reporting = db_config.enable_keyspace_column_family_metrics();
+    cfg.memtable_flush_split_size = size_t(db_config.memtable_flush_split_size_in_mb()) << 20;
+    cfg.compression_auto_chunk_length = db_config.compression_auto_chunk_length();
 
     // avoid self-reporting
     if (is_system_table(s)) {
@@ -1570,6 +1672,7 @@ database::make_keyspace_config(const keyspace_metadata& ksm) {
     cfg.streaming_dirty_memory_manager = &_streaming_dirty_memory_manager;
     cfg.read_concurrency_semaphore = &_read_concurrency_sem;
     cfg.streaming_read_concurrency_semaphore = &_streaming_concurrency_sem;
+    cfg.service_level_read_concurrency_semaphores = &_service_level_read_concurrency_sems;
     cfg.cf_stats = &_cf_stats;
     cfg.enable_incremental_backups = _enable_incremental_backups;
 
@@ -73,10 +73,12 @@
 #include "sstables/sstable_set.hh"
 #include "sstables/progress_monitor.hh"
 #include "sstables/version.hh"
+#include "sstables/compress.hh"
 #include <seastar/core/rwlock.hh>
 #include <seastar/core/shared_future.hh>
 #include <seastar/core/metrics_registration.hh>
 #include "tracing/trace_state.hh"
+#include "tracing/query_profile.hh"
 #include "db/view/view.hh"
 #include "db/view/view_update_backlog.hh"
 #include "db/view/row_locking.hh"
@@ -304,12 +306,21 @@ struct cf_stats {
     // how many sstables survived the clustering key checks
     int64_t surviving_sstables_after_clustering_filter = 0;
 
+    // how many sstables a single partition read left out because a partition tombstone shadows all their data
+    int64_t sstables_skipped_by_partition_tombstone = 0;
+
+    // how many sstables a single row read left out because the newer sstables already supersede all their data for the row
+    int64_t sstables_skipped_by_timestamp = 0;
+
     // How many view updates were dropped due to overload.
     int64_t dropped_view_updates = 0;
 
     // How many times view building was paused (e.g. due to node unavailability)
     int64_t view_building_paused = 0;
 
+    // How many view building steps were executed
+    int64_t view_building_steps = 0;
+
     // How many view updates were processed for all tables
     uint64_t total_view_updates_pushed_local = 0;
     uint64_t total_view_updates_pushed_remote = 0;
@@ -320,6 +331,19 @@ struct cf_stats {
 class table;
 using column_family = table;
 struct table_stats;
+
+// The request a replica served a read with. They differ in how much
+// work the replica does and how much it sends back, so their latencies
+// are tracked separately.
+enum class replica_read_kind : uint8_t {
+    data,
+    digest,
+    mutation_data,
+};
+
+// Reader admission queues of service levels, keyed by the id of their
+// io priority class, see qos::service_level_controller.
+using reader_concurrency_semaphores_by_class = std::unordered_map<unsigned, std::unique_ptr<reader_concurrency_semaphore>>;
 using column_family_stats = table_stats;
 
 class database_sstable_write_monitor;
@@ -351,6 +375,13 @@ struct table_stats {
     utils::timed_rate_moving_average_and_histogram tombstone_scanned;
     utils::timed_rate_moving_average_and_histogram live_scanned;
     utils::estimated_histogram estimated_coordinator_read;
+    // Phases of the CQL requests targeting this table, as seen by the coordinator
+    std::array<utils::estimated_histogram, size_t(tracing::query_phase::count)> estimated_query_phases;
+    // Replica side phases of the reads of this table: waiting for the result
+    // memory, waiting for the admission of the sstable readers and the read itself
+    utils::estimated_histogram estimated_replica_memory_wait;
+    utils::estimated_histogram estimated_replica_admission;
+    utils::estimated_histogram estimated_replica_read;
 };
 
 class table : public enable_lw_shared_from_this<table> {
@@ -369,6 +400,7 @@ class table : public enable_lw_shared_from_this<table> {
         ::dirty_memory_manager* streaming_dirty_memory_manager = &default_dirty_memory_manager;
         reader_concurrency_semaphore* read_concurrency_semaphore;
         reader_concurrency_semaphore* streaming_read_concurrency_semaphore;
+        const reader_concurrency_semaphores_by_class* service_level_read_concurrency_semaphores = nullptr;
         ::cf_stats* cf_stats = nullptr;
         seastar::scheduling_group memtable_scheduling_group;
         seastar::scheduling_group memtable_to_cache_scheduling_group;
@@ -381,6 +413,11 @@ class table : public enable_lw_shared_from_this<table> {
         db::timeout_semaphore* view_update_concurrency_semaphore;
         size_t view_update_concurrency_semaphore_limit;
         db::data_listeners* data_listeners = nullptr;
+        // Memtables larger than this are flushed into several sstables in parallel. 0 disables splitting.
+        size_t memtable_flush_split_size = 0;
+        // Pick the compression chunk length of sstables written by compaction
+        // from how the table's sstables are read, see auto_compression_chunk_length().
+        bool compression_auto_chunk_length = false;
     };
     struct no_commitlog {};
 
@@ -392,6 +429,13 @@ class table : public enable_lw_shared_from_this<table> {
         cache_temperature rate;
         lowres_clock::time_point last_updated;
     };
+    // Read latency of a single replica of this table, as seen by this node acting as a coordinator.
+    struct replica_read_latency {
+        utils::estimated_histogram histogram;
+        double cached_percentile = -1;
+        lowres_clock::time_point percentile_cache_timestamp;
+        std::chrono::microseconds percentile_cache_value;
+    };
 private:
     schema_ptr _schema;
     config _config;
@@ -512,6 +556,11 @@ class table : public enable_lw_shared_from_this<table> {
     // in dynamically
     std::unordered_map<gms::inet_address, cache_hit_rate> _cluster_cache_hit_rates;
 
+    // holds read latencies of each replica of this table we have
+    // coordinated reads to, used to pick the data replica and the
+    // speculative retry delay
+    std::unordered_map<gms::inet_address, std::array<replica_read_latency, 3>> _replica_read_latencies;
+
     // Operations like truncate, flush, query, etc, may depend on a column family being alive to
     // complete.  Some of them have their own gate already (like flush), used in specialized wait
     // logic (like the streaming_flush_gate). That is particularly useful if there is a particular
@@ -524,6 +573,11 @@ class table : public enable_lw_shared_from_this<table> {
     lowres_clock::time_point _percentile_cache_timestamp;
     std::chrono::milliseconds _percentile_cache_value;
 
+    // The compression gauges are read one after another on every scrape;
+    // they share one sum over the live sstables, refreshed at most once a second.
+    mutable sstables::compression::read_stats _cached_compression_read_stats;
+    mutable lowres_clock::time_point _compression_read_stats_cache_timestamp;
+
     // Phaser used to synchronize with in-progress writes. This is useful for code that,
     // after some modification, needs to ensure that news writes will see it before
     // it can proceed, such as the view building code.
@@ -560,9 +614,10 @@ class table : public enable_lw_shared_from_this<table> {
     void load_sstable(sstables::shared_sstable& sstable, bool reset_level = false);
     lw_shared_ptr<memtable> new_memtable();
     lw_shared_ptr<memtable> new_streaming_memtable();
+    static constexpr size_t max_memtable_flush_splits = 8;
     future<stop_iteration> try_flush_memtable_to_sstable(lw_shared_ptr<memtable> memt, sstable_write_permit&& permit);
     // Caller must keep m alive.
-    future<> update_cache(lw_shared_ptr<memtable> m, sstables::shared_sstable sst);
+    future<> update_cache(lw_shared_ptr<memtable> m, std::vector<sstables::shared_sstable> ssts);
     struct merge_comparator;
 
     // update the sstable generation, making sure that new new sstables don't overwrite this one.
@@ -874,6 +929,17 @@ class table : public enable_lw_shared_from_this<table> {
         return _stats;
     }
 
+    // Read statistics of the compressed data files of the live sstables.
+    sstables::compression::read_stats compression_read_stats() const;
+private:
+    const sstables::compression::read_stats& cached_compression_read_stats() const;
+public:
+
+    // With compression_auto_chunk_length enabled, returns the compression
+    // chunk length new sstables should use, or nothing to keep the schema's.
+    // See sstables::chunk_length_for_reads().
+    std::optional<int32_t> auto_compression_chunk_length() const;
+
     const db::view::stats& get_view_stats() const {
         return _view_stats;
     }
@@ -932,7 +998,19 @@ class table : public enable_lw_shared_from_this<table> {
     future<row_locker::lock_holder> push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout) const;
     future<row_locker::lock_holder> stream_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, sstables::shared_sstable excluded_sstable) const;
     void add_coordinator_read_latency(utils::estimated_histogram::duration latency);
+    // Accounts the phases of a completed CQL request targeting this table.
+    void add_query_profile(const tracing::query_profile& profile);
     std::chrono::milliseconds get_coordinator_read_latency_percentile(double percentile);
+    void add_replica_read_latency(gms::inet_address addr, replica_read_kind kind, utils::estimated_histogram::duration latency);
+    // Returns the given percentile of the latency of the replica's reads of the given kind,
+    // or std::nullopt if there are not enough samples to make an estimation.
+    std::optional<std::chrono::microseconds> get_replica_read_latency_percentile(gms::inet_address addr, replica_read_kind kind, double percentile);
+    // Estimates the given percentile of the latency of the replica's reads of the given kind,
+    // taking its latest reported cache hit rate into account: the
+    // latency histogram reacts slowly, so a replica whose cache went cold
+    // (e.g. after a restart) is penalized up to 2x until it warms up again.
+    // An unknown hit rate (e.g. of an older node) is neither a penalty nor a bonus.
+    std::optional<std::chrono::microseconds> estimate_replica_read_latency(gms::inet_address addr, replica_read_kind kind, double percentile);
 
     secondary_index::secondary_index_manager& get_index_manager() {
         return _index_manager;
@@ -957,8 +1035,34 @@ class table : public enable_lw_shared_from_this<table> {
     }
 
 private:
-    future<row_locker::lock_holder> do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source, const io_priority_class& io_priority) const;
+    // Writes to the same base partition which need to read existing rows
+    // before generating view updates, and get to do so at about the same
+    // time, share a single read covering the rows of all of them. Their
+    // view updates are merged and sent together once all are generated.
+    struct view_update_read_batch {
+        dht::decorated_key key;
+        query::clustering_row_ranges ranges;
+        // The latest timeout of the members, which the read uses.
+        db::timeout_clock::time_point timeout = db::timeout_clock::time_point::min();
+        // Null when the partition doesn't exist.
+        shared_promise<lw_shared_ptr<const mutation>> existing;
+        std::vector<frozen_mutation_and_schema> updates;
+        // Members which haven't generated their view updates yet.
+        size_t pending = 0;
+        // Resolved once the updates of all members are sent. Members keep
+        // their row locks until then.
+        shared_promise<> propagated;
+
+        explicit view_update_read_batch(dht::decorated_key k) : key(std::move(k)) { }
+    };
+    // Batches still accepting members, keyed by token.
+    mutable std::unordered_multimap<dht::token, lw_shared_ptr<view_update_read_batch>> _view_update_read_batches;
+
+    lw_shared_ptr<view_update_read_batch> join_view_update_read_batch(const schema_ptr& base, const dht::decorated_key& key,
+            const query::clustering_row_ranges& ranges, db::timeout_clock::time_point timeout) const;
+    future<row_locker::lock_holder> do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source, const io_priority_class& io_priority, bool coalesce_reads) const;
     std::vector<view_ptr> affected_views(const schema_ptr& base, const mutation& update) const;
+    void propagate_view_updates(dht::token base_token, std::vector<frozen_mutation_and_schema>&& updates) const;
     future<> generate_and_propagate_view_updates(const schema_ptr& base,
             std::vector<view_ptr>&& views,
             mutation&& m,
@@ -1122,6 +1226,7 @@ class keyspace {
         ::dirty_memory_manager* streaming_dirty_memory_manager = &default_dirty_memory_manager;
         reader_concurrency_semaphore* read_concurrency_semaphore;
         reader_concurrency_semaphore* streaming_read_concurrency_semaphore;
+        const reader_concurrency_semaphores_by_class* service_level_read_concurrency_semaphores = nullptr;
         ::cf_stats* cf_stats = nullptr;
         seastar::scheduling_group memtable_scheduling_group;
         seastar::scheduling_group memtable_to_cache_scheduling_group;
@@ -1262,6 +1367,9 @@ class database {
     reader_concurrency_semaphore _read_concurrency_sem;
     reader_concurrency_semaphore _streaming_concurrency_sem;
     reader_concurrency_semaphore _system_read_concurrency_sem;
+    reader_concurrency_semaphores_by_class _service_level_read_concurrency_sems;
+    // Keyed like _service_level_read_concurrency_sems.
+    std::unordered_map<unsigned, seastar::metrics::metric_groups> _service_level_read_metrics;
 
     named_semaphore _sstable_load_concurrency_sem{max_concurrent_sstable_loads(), named_semaphore_exception_factory{"sstable load concurrency"}};
 
@@ -1517,6 +1625,20 @@ class database {
         return _querier_cache.get_stats();
     }
 
+    // Creates the reader admission queue for reads issued with the given priority class.
+    // The queue is named like the class, as it outlives the service levels using it.
+    void add_service_level_read_concurrency_semaphore(const io_priority_class& pc, const sstring& name);
+    // Exports the metrics of the queue of the given class under the name of the service
+    // level now using it, instead of the one that used it before, if any.
+    void register_service_level_read_metrics(const io_priority_class& pc, const sstring& service_level);
+    void unregister_service_level_read_metrics(const io_priority_class& pc);
+    // Splits the user read budget between the default read queue and the service level
+    // queues in proportion to their shares, so that together they admit no more than
+    // max_count_concurrent_reads reads and max_memory_concurrent_reads() memory, beyond
+    // the single reader every queue is guaranteed. Queues whose class is missing from shares_by_class, i.e. those of dropped
+    // service levels, keep just enough for a single reader.
+    void set_user_read_shares(int32_t default_shares, const std::unordered_map<unsigned, int32_t>& shares_by_class);
+
     query::querier_cache& get_querier_cache() {
         return _querier_cache;
     }
@@ -21,12 +21,15 @@
 
 #pragma once
 
+#include <cstdint>
+
 // database.hh
 class database;
 class keyspace;
 class table;
 using column_family = table;
 class memtable_list;
+enum class replica_read_kind : uint8_t;
 
 // mutation.hh
 class mutation;
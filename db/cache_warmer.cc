@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "db/cache_warmer.hh"
+#include "db/config.hh"
+#include "database.hh"
+#include "service/priority_manager.hh"
+#include "validation.hh"
+#include "log.hh"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/defer.hh>
+
+#include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
+
+#include <functional>
+
+static logging::logger cwlogger("cache_warmer");
+
+namespace db {
+
+// The file starts with the format version, followed by one record per shard
+// and table:
+//
+//   table id (most significant bits: int64, least significant bits: int64)
+//   number of keys (uint32)
+//   for each key, hottest first: length (uint32), serialized partition key
+//
+// All integers are big-endian.
+static constexpr uint32_t saved_keys_format_version = 1;
+static constexpr size_t record_header_size = 2 * sizeof(int64_t) + sizeof(uint32_t);
+
+cache_warmer::cache_warmer(seastar::sharded<database>& db, const db::config& cfg)
+    : _db(db.local())
+    , _dir(cfg.saved_caches_directory())
+    , _save_period(cfg.row_cache_save_period())
+    , _keys_to_save(cfg.row_cache_keys_to_save())
+    , _hit_rate_timer([this] { update_hit_rate(); })
+{
+    setup_metrics();
+}
+
+void cache_warmer::setup_metrics() {
+    namespace sm = seastar::metrics;
+    _metrics.add_group("cache_warmup", {
+        sm::make_gauge("keys_to_warm", sm::description("number of saved partition keys this shard reads back into the cache after a restart"), _stats.keys_to_warm),
+        sm::make_derive("keys_warmed", sm::description("number of saved partitions which were read back into the cache"), _stats.keys_warmed),
+        sm::make_derive("keys_failed", sm::description("number of saved partitions which failed to be read back into the cache"), _stats.keys_failed),
+        sm::make_gauge("in_progress", sm::description("1 while saved partitions are being read back into the cache, 0 otherwise"), [this] { return _warmup_finished ? 0 : 1; }),
+        sm::make_gauge("hit_rate", sm::description("ratio of partitions found in cache to all partitions needed by reads during the last 10 seconds"), _stats.hit_rate),
+    });
+}
+
+future<> cache_warmer::start() {
+    auto& st = _db.row_cache_tracker().get_stats();
+    _last_partition_hits = st.partition_hits;
+    _last_partition_misses = st.partition_misses;
+    _hit_rate_timer.arm_periodic(hit_rate_interval);
+
+    thread_attributes attr;
+    attr.sched_group = _db.get_streaming_scheduling_group();
+    _warmup_done = seastar::async(attr, [this] {
+        warm_up();
+    });
+    if (engine().cpu_id() == 0) {
+        _saver_done = seastar::async(attr, [this] {
+            while (!_as.abort_requested()) {
+                try {
+                    sleep_abortable(_save_period, _as).get();
+                } catch (const sleep_aborted&) {
+                    // Save once more before shutting down.
+                }
+                // Until the cache is warm, the saved keys are better than the sampled ones.
+                if (!_warmup_finished) {
+                    continue;
+                }
+                try {
+                    save();
+                } catch (...) {
+                    cwlogger.warn("Failed to save hot partition keys to {}: {}", saved_keys_file(), std::current_exception());
+                }
+            }
+        });
+    }
+    return make_ready_future<>();
+}
+
+future<> cache_warmer::stop() {
+    _as.request_abort();
+    _hit_rate_timer.cancel();
+    return _warmup_done.get_future().finally([this] {
+        return std::move(_saver_done);
+    });
+}
+
+sstring cache_warmer::saved_keys_file() const {
+    return _dir + "/row_cache_keys.db";
+}
+
+void cache_warmer::update_hit_rate() {
+    auto& st = _db.row_cache_tracker().get_stats();
+    auto hits = st.partition_hits - std::exchange(_last_partition_hits, st.partition_hits);
+    auto misses = st.partition_misses - std::exchange(_last_partition_misses, st.partition_misses);
+    _stats.hit_rate = hits + misses ? double(hits) / (hits + misses) : 0;
+}
+
+std::unordered_map<utils::UUID, std::vector<dht::decorated_key>> cache_warmer::load_saved_keys() {
+    std::unordered_map<utils::UUID, std::vector<dht::decorated_key>> keys;
+    auto name = saved_keys_file();
+    if (!file_exists(name).get0()) {
+        return keys;
+    }
+    auto in = make_file_input_stream(open_file_dma(name, open_flags::ro).get0());
+    auto read = [&in, &name] (size_t n) {
+        auto buf = in.read_exactly(n).get0();
+        if (buf.size() != n) {
+            throw std::runtime_error(format("{} is truncated", name));
+        }
+        return buf;
+    };
+    std::exception_ptr ex;
+    try {
+        auto version = read_be<uint32_t>(read(sizeof(uint32_t)).get());
+        if (version != saved_keys_format_version) {
+            throw std::runtime_error(format("{} has unsupported format version {}", name, version));
+        }
+        while (!_as.abort_requested()) {
+            auto header = in.read_exactly(record_header_size).get0();
+            if (header.empty()) {
+                break;
+            }
+            if (header.size() != record_header_size) {
+                throw std::runtime_error(format("{} is truncated", name));
+            }
+            utils::UUID id(read_be<int64_t>(header.get()), read_be<int64_t>(header.get() + sizeof(int64_t)));
+            auto count = read_be<uint32_t>(header.get() + 2 * sizeof(int64_t));
+            // Bound what a corrupt file can make us allocate.
+            if (count > row_cache::max_sampled_keys) {
+                throw std::runtime_error(format("{} is corrupt: {} keys of table {}", name, count, id));
+            }
+            auto it = _db.get_column_families().find(id);
+            // Keys of a table dropped since are skipped.
+            schema_ptr s = it != _db.get_column_families().end() ? it->second->schema() : nullptr;
+            for (uint32_t i = 0; i < count; ++i) {
+                auto len = read_be<uint32_t>(read(sizeof(uint32_t)).get());
+                if (len > validation::max_key_size) {
+                    throw std::runtime_error(format("{} is corrupt: key of {} bytes", name, len));
+                }
+                auto buf = read(len);
+                if (!s) {
+                    continue;
+                }
+                auto pk = partition_key::from_bytes(bytes_view(reinterpret_cast<const bytes::value_type*>(buf.get()), buf.size()));
+                auto dk = dht::global_partitioner().decorate_key(*s, std::move(pk));
+                if (dht::shard_of(dk.token()) == engine().cpu_id()) {
+                    keys[id].push_back(std::move(dk));
+                }
+            }
+        }
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    in.close().get();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    return keys;
+}
+
+future<> cache_warmer::warm_up_partition(lw_shared_ptr<table> t, const dht::decorated_key& key) {
+    return do_with(dht::partition_range::make_singular(key), [t = std::move(t)] (const dht::partition_range& pr) {
+        auto s = t->schema();
+        auto reader = t->make_reader(s, pr, s->full_slice(), service::get_local_streaming_read_priority(),
+                nullptr, streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+        return do_with(std::move(reader), [t] (flat_mutation_reader& reader) {
+            return repeat([&reader] {
+                return reader(db::no_timeout).then([] (mutation_fragment_opt mf) {
+                    return stop_iteration(!mf);
+                });
+            });
+        });
+    });
+}
+
+void cache_warmer::warm_up() {
+    auto finish = defer([this] {
+        _warmup_finished = true;
+    });
+    std::unordered_map<utils::UUID, std::vector<dht::decorated_key>> keys;
+    try {
+        keys = load_saved_keys();
+    } catch (...) {
+        cwlogger.warn("Failed to load hot partition keys from {}: {}", saved_keys_file(), std::current_exception());
+        return;
+    }
+    if (keys.empty()) {
+        return;
+    }
+    for (auto& table_keys : keys | boost::adaptors::map_values) {
+        _stats.keys_to_warm += table_keys.size();
+    }
+
+    cwlogger.info("Warming up the cache with {} partitions", _stats.keys_to_warm);
+    auto started = lowres_clock::now();
+    for (auto& [id, table_keys] : keys) {
+        auto it = _db.get_column_families().find(id);
+        if (it == _db.get_column_families().end()) {
+            _stats.keys_failed += table_keys.size();
+            continue;
+        }
+        auto t = it->second;
+        size_t next = 0;
+        parallel_for_each(boost::irange(0u, warmup_concurrency), [&] (unsigned) {
+            return do_until([&] { return next == table_keys.size() || _as.abort_requested(); }, [&] {
+                return warm_up_partition(t, table_keys[next++]).then_wrapped([this] (future<> f) {
+                    if (f.failed()) {
+                        cwlogger.debug("Failed to warm up partition: {}", f.get_exception());
+                        ++_stats.keys_failed;
+                    } else {
+                        ++_stats.keys_warmed;
+                    }
+                });
+            });
+        }).get();
+        if (_as.abort_requested()) {
+            return;
+        }
+    }
+    cwlogger.info("Cache warm-up done: {} of {} partitions read in {} seconds", _stats.keys_warmed, _stats.keys_to_warm,
+            std::chrono::duration_cast<std::chrono::seconds>(lowres_clock::now() - started).count());
+}
+
+future<std::vector<bytes>> cache_warmer::serialize_hot_keys() {
+    auto tables = boost::copy_range<std::vector<lw_shared_ptr<table>>>(_db.get_column_families() | boost::adaptors::map_values);
+    return do_with(std::move(tables), std::vector<bytes>(), [this] (auto& tables, auto& records) {
+        return do_for_each(tables, [this, &records] (const lw_shared_ptr<table>& t) {
+            auto keys = t->get_row_cache().hot_keys(_keys_to_save);
+            // Longer keys would be rejected when loading.
+            keys.erase(std::remove_if(keys.begin(), keys.end(), [] (const dht::decorated_key& key) {
+                return key.key().representation().size() > validation::max_key_size;
+            }), keys.end());
+            if (keys.empty()) {
+                return;
+            }
+            auto size = record_header_size;
+            for (auto& key : keys) {
+                size += sizeof(uint32_t) + key.key().view().representation().size();
+            }
+            bytes record(bytes::initialized_later(), size);
+            auto out = reinterpret_cast<char*>(record.begin());
+            auto id = t->schema()->id();
+            write_be<int64_t>(out, id.get_most_significant_bits());
+            write_be<int64_t>(out + sizeof(int64_t), id.get_least_significant_bits());
+            write_be<uint32_t>(out + 2 * sizeof(int64_t), keys.size());
+            out += record_header_size;
+            for (auto& key : keys) {
+                auto v = key.key().view().representation();
+                write_be<uint32_t>(out, v.size());
+                out = std::copy(v.begin(), v.end(), out + sizeof(uint32_t));
+            }
+            records.push_back(std::move(record));
+        }).then([&records] {
+            return std::move(records);
+        });
+    });
+}
+
+void cache_warmer::save() {
+    auto records = container().map_reduce0(std::mem_fn(&cache_warmer::serialize_hot_keys), std::vector<bytes>(),
+            [] (std::vector<bytes> a, std::vector<bytes> b) {
+        std::move(b.begin(), b.end(), std::back_inserter(a));
+        return a;
+    }).get0();
+
+    // Write a new file and replace the old one, so that a crash leaves one of them intact.
+    auto name = saved_keys_file();
+    auto tmp = name + ".tmp";
+    auto out = make_file_output_stream(open_file_dma(tmp, open_flags::wo | open_flags::create | open_flags::truncate).get0());
+    std::exception_ptr ex;
+    try {
+        char version[sizeof(uint32_t)];
+        write_be<uint32_t>(version, saved_keys_format_version);
+        out.write(version, sizeof(version)).get();
+        for (auto& record : records) {
+            out.write(reinterpret_cast<const char*>(record.begin()), record.size()).get();
+        }
+        out.flush().get();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    out.close().get();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    rename_file(tmp, name).get();
+    sync_directory(_dir).get();
+    cwlogger.debug("Saved hot partition keys of {} tables to {}", records.size(), name);
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "database_fwd.hh"
+#include "dht/i_partitioner.hh"
+#include "utils/UUID.hh"
+#include "bytes.hh"
+
+#include <seastar/core/abort_source.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/timer.hh>
+
+#include <unordered_map>
+#include <vector>
+
+namespace db {
+
+class config;
+
+/**
+ * Saves the keys of the partitions which are read most often from each
+ * table's row cache to saved_caches_directory every row_cache_save_period
+ * seconds, and after a restart reads them back into the cache in the
+ * background, so that the node doesn't serve its hot partitions from
+ * sstables until the workload brings them back on its own.
+ *
+ * Shard 0 writes a single file with the keys of all shards, and every
+ * shard warms up the keys it owns, so the file remains usable when the
+ * number of shards changes.
+ */
+class cache_warmer : public seastar::peering_sharded_service<cache_warmer> {
+public:
+    // Reads issued in parallel by the warm-up on each shard.
+    static constexpr unsigned warmup_concurrency = 4;
+    static constexpr std::chrono::seconds hit_rate_interval{10};
+private:
+    struct stats {
+        uint64_t keys_to_warm = 0;
+        uint64_t keys_warmed = 0;
+        uint64_t keys_failed = 0;
+        double hit_rate = 0;
+    };
+
+    database& _db;
+    sstring _dir;
+    std::chrono::seconds _save_period;
+    size_t _keys_to_save;
+    seastar::abort_source _as;
+    bool _warmup_finished = false;
+    shared_future<> _warmup_done = make_ready_future<>();
+    future<> _saver_done = make_ready_future<>();
+    timer<lowres_clock> _hit_rate_timer;
+    uint64_t _last_partition_hits = 0;
+    uint64_t _last_partition_misses = 0;
+    stats _stats;
+    seastar::metrics::metric_groups _metrics;
+public:
+    cache_warmer(seastar::sharded<database>& db, const db::config& cfg);
+
+    future<> start();
+    future<> stop();
+
+    // For tests
+    future<> wait_until_warmed_up() {
+        return _warmup_done.get_future();
+    }
+    uint64_t keys_to_warm() const {
+        return _stats.keys_to_warm;
+    }
+    uint64_t keys_warmed() const {
+        return _stats.keys_warmed;
+    }
+private:
+    sstring saved_keys_file() const;
+    std::unordered_map<utils::UUID, std::vector<dht::decorated_key>> load_saved_keys();
+    void warm_up();
+    future<> warm_up_partition(lw_shared_ptr<table> t, const dht::decorated_key& key);
+    future<std::vector<bytes>> serialize_hot_keys();
+    void save();
+    void update_hit_rate();
+    void setup_metrics();
+};
+
+}
@@ -195,6 +195,10 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "true: auto-adjust memtable shares for flush processes")
     , memtable_flush_static_shares(this, "memtable_flush_static_shares", value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the memtable shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
+    , memtable_flush_split_size_in_mb(this, "memtable_flush_split_size_in_mb", value_status::Used, 0,
+        "If set to higher than 0, memtables larger than this are flushed by token range into a run of up to 8 sstables written in parallel. This shortens the flush of large memtables when a single sstable writer can't keep up with the disk.")
+    , compression_auto_chunk_length(this, "compression_auto_chunk_length", value_status::Used, false,
+        "If true, sstables written by compaction of compressed tables use a chunk length between 4 and 64 KiB picked from the median size of user single partition reads of the table's sstables, instead of the table's chunk_length_in_kb. Smaller chunks waste less decompression on point reads, larger ones compress better for scans.")
     , compaction_static_shares(this, "compaction_static_shares", value_status::Used, 0,
         "If set to higher than 0, ignore the controller's output and set the compaction shares statically. Do not set this unless you know what you are doing and suspect a problem in the controller. This option will be retired when the controller reaches more maturity")
     , compaction_enforce_min_threshold(this, "compaction_enforce_min_threshold", liveness::LiveUpdate, value_status::Used, false,
@@ -230,8 +234,8 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         "The directory where hints files are stored if hinted handoff is enabled.")
     , view_hints_directory(this, "view_hints_directory", value_status::Used, "",
         "The directory where materialized-view updates are stored while a view replica is unreachable.")
-    , saved_caches_directory(this, "saved_caches_directory", value_status::Unused, "",
-        "The directory location where table key and row caches are stored.")
+    , saved_caches_directory(this, "saved_caches_directory", value_status::Used, "",
+        "The directory location where the keys of the hottest row cache partitions are saved, see row_cache_save_period.")
     /* Commonly used properties */
     /* Properties most frequently used when configuring Scylla. */
     /* Before starting a node for the first time, you should carefully evaluate your requirements. */
@@ -449,12 +453,12 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , key_cache_size_in_mb(this, "key_cache_size_in_mb", value_status::Unused, 100,
         "A global cache setting for tables. It is the maximum size of the key cache in memory. To disable set to 0.\n"
         "Related information: nodetool setcachecapacity.")
-    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Unused, 0,
-        "Number of keys from the row cache to save.")
+    , row_cache_keys_to_save(this, "row_cache_keys_to_save", value_status::Used, 0,
+        "Maximum number of the hottest partition keys of each table and shard to save. (0: all sampled keys)")
     , row_cache_size_in_mb(this, "row_cache_size_in_mb", value_status::Unused, 0,
         "Maximum size of the row cache in memory. Row cache can save more time than key_cache_size_in_mb, but is space-intensive because it contains the entire row. Use the row cache only for hot rows or static rows. If you reduce the size, you may not get you hottest keys loaded on start up.")
-    , row_cache_save_period(this, "row_cache_save_period", value_status::Unused, 0,
-        "Duration in seconds that rows are saved in cache. Caches are saved to saved_caches_directory.")
+    , row_cache_save_period(this, "row_cache_save_period", value_status::Used, 0,
+        "Period in seconds at which the keys of the hottest partitions in the row cache are saved to saved_caches_directory. On startup, the saved partitions are read back into the cache in the background. (0: disabled)")
     , memory_allocator(this, "memory_allocator", value_status::Invalid, "NativeAllocator",
         "The off-heap memory allocator. In addition to caches, this property affects storage engine meta data. Supported values:\n"
         "\tNativeAllocator\n"
@@ -691,6 +695,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
     , fd_max_interval_ms(this, "fd_max_interval_ms", value_status::Used, 2 * 1000, "The maximum failure_detector interval time in milliseconds. Interval larger than the maximum will be ignored. Larger cluster may need to increase the default.")
     , fd_initial_value_ms(this, "fd_initial_value_ms", value_status::Used, 2 * 1000, "The initial failure_detector interval time in milliseconds.")
     , shutdown_announce_in_ms(this, "shutdown_announce_in_ms", value_status::Used, 2 * 1000, "Time a node waits after sending gossip shutdown message in milliseconds. Same as -Dcassandra.shutdown_announce_in_ms in cassandra.")
+    , gossip_full_digest_interval(this, "gossip_full_digest_interval", value_status::Used, 10, "Every this many gossip exchanges with a live peer carry the digests of all endpoints. The others carry only the endpoints whose state changed since the previous exchange with that peer. 1 sends full digests every time.")
     , developer_mode(this, "developer_mode", value_status::Used, false, "Relax environment checks. Setting to true can reduce performance and reliability significantly.")
     , skip_wait_for_gossip_to_settle(this, "skip_wait_for_gossip_to_settle", value_status::Used, -1, "An integer to configure the wait for gossip to settle. -1: wait normally, 0: do not wait at all, n: wait for at most n polls. Same as -Dcassandra.skip_wait_for_gossip_to_settle in cassandra.")
     , experimental(this, "experimental", value_status::Used, false, "Set to true to unlock all experimental features.")
@@ -713,6 +718,7 @@ db::config::config(std::shared_ptr<db::extensions> exts)
         " Performance is affected to some extent as a result. Useful to help debugging problems that may arise at another layers.")
     , cpu_scheduler(this, "cpu_scheduler", value_status::Used, true, "Enable cpu scheduling")
     , view_building(this, "view_building", value_status::Used, true, "Enable view building; should only be set to false when the node is experience issues due to view building")
+    , view_building_bulk_mode(this, "view_building_bulk_mode", value_status::Used, false, "Build views in larger steps, generating and sending the view updates of several base partitions concurrently. Speeds up building views of large tables at the cost of more load on the view replicas")
     , enable_sstables_mc_format(this, "enable_sstables_mc_format", value_status::Used, true, "Enable SSTables 'mc' format to be used as the default file format")
     , enable_dangerous_direct_import_of_cassandra_counters(this, "enable_dangerous_direct_import_of_cassandra_counters", value_status::Used, false, "Only turn this option on if you want to import tables from Cassandra containing counters, and you are SURE that no counters in that table were created in a version earlier than Cassandra 2.1."
         " It is not enough to have ever since upgraded to newer versions of Cassandra. If you EVER used a version earlier than 2.1 in the cluster where these SSTables come from, DO NOT TURN ON THIS OPTION! You will corrupt your data. You have been warned.")
@@ -115,6 +115,8 @@ class config : public utils::config_file {
     named_value<double> background_writer_scheduling_quota;
     named_value<bool> auto_adjust_flush_quota;
     named_value<float> memtable_flush_static_shares;
+    named_value<uint32_t> memtable_flush_split_size_in_mb;
+    named_value<bool> compression_auto_chunk_length;
     named_value<float> compaction_static_shares;
     named_value<bool> compaction_enforce_min_threshold;
     named_value<sstring> cluster_name;
@@ -270,6 +272,7 @@ class config : public utils::config_file {
     named_value<uint32_t> fd_max_interval_ms;
     named_value<uint32_t> fd_initial_value_ms;
     named_value<uint32_t> shutdown_announce_in_ms;
+    named_value<uint32_t> gossip_full_digest_interval;
     named_value<bool> developer_mode;
     named_value<int32_t> skip_wait_for_gossip_to_settle;
     named_value<bool> experimental;
@@ -289,6 +292,7 @@ class config : public utils::config_file {
     named_value<bool> enable_sstable_key_validation;
     named_value<bool> cpu_scheduler;
     named_value<bool> view_building;
+    named_value<bool> view_building_bulk_mode;
     named_value<bool> enable_sstables_mc_format;
     named_value<bool> enable_dangerous_direct_import_of_cassandra_counters;
     named_value<bool> enable_shard_aware_drivers;
@@ -25,6 +25,7 @@
 #include <seastar/core/seastar.hh>
 #include <seastar/core/gate.hh>
 #include <boost/range/adaptors.hpp>
+#include <boost/range/irange.hpp>
 #include "service/storage_service.hh"
 #include "utils/div_ceil.hh"
 #include "db/extensions.hh"
@@ -686,7 +687,12 @@ future<> manager::end_point_hints_manager::sender::send_one_mutation(frozen_muta
 }
 
 future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<send_one_file_ctx> ctx_ptr, fragmented_temporary_buffer buf, db::replay_position rp, gc_clock::duration secs_since_file_mod, const sstring& fname) {
-    return _resource_manager.get_send_units_for(buf.size_bytes()).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
+    size_t buf_size = buf.size_bytes();
+    // When draining we want to get rid of the hints as fast as possible - don't throttle.
+    future<> f = draining() ? make_ready_future<>() : _resource_manager.consume_replay_budget(buf_size);
+    return f.then([this, buf_size] {
+        return _resource_manager.get_send_units_for(buf_size);
+    }).then([this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] (auto units) mutable {
         // Future is waited on indirectly in `send_one_file()` (via `ctx_ptr->file_send_gate`).
         (void)with_gate(ctx_ptr->file_send_gate, [this, secs_since_file_mod, &fname, buf = std::move(buf), rp, ctx_ptr] () mutable {
             try {
@@ -738,10 +744,10 @@ future<> manager::end_point_hints_manager::sender::send_one_hint(lw_shared_ptr<s
 }
 
 // runs in a seastar::async context
-bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fname) {
+bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fname, replay_position& last_not_complete_rp, std::unordered_map<table_schema_version, column_mapping>& schema_ver_to_column_mapping) {
     timespec last_mod = get_last_file_modification(fname).get0();
     gc_clock::duration secs_since_file_mod = std::chrono::seconds(last_mod.tv_sec);
-    lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(_last_schema_ver_to_column_mapping);
+    lw_shared_ptr<send_one_file_ctx> ctx_ptr = make_lw_shared<send_one_file_ctx>(schema_ver_to_column_mapping);
 
     try {
         auto s = commitlog::read_log_file(fname, manager::FILENAME_PREFIX, service::get_local_streaming_read_priority(), [this, secs_since_file_mod, &fname, ctx_ptr] (commitlog::buffer_and_replay_position buf_rp) mutable {
@@ -761,7 +767,7 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
             return flush_maybe().finally([this, ctx_ptr, buf = std::move(buf), rp, secs_since_file_mod, &fname] () mutable {
                 return send_one_hint(std::move(ctx_ptr), std::move(buf), rp, secs_since_file_mod, fname);
             });
-        }, _last_not_complete_rp.pos, &_db.extensions()).get0();
+        }, last_not_complete_rp.pos, &_db.extensions()).get0();
 
         s->done().get();
     } catch (db::commitlog::segment_error& ex) {
@@ -786,12 +792,12 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
     if (ctx_ptr->state.contains(send_state::segment_replay_failed)) {
         if (ctx_ptr->state.contains(send_state::restart_segment)) {
             // if _rps_set contents is inconsistent simply re-start the current file from the beginning
-            _last_not_complete_rp = replay_position();
+            last_not_complete_rp = replay_position();
         } else if (!ctx_ptr->rps_set.empty()) {
-            _last_not_complete_rp = *std::min_element(ctx_ptr->rps_set.begin(), ctx_ptr->rps_set.end());
+            last_not_complete_rp = *std::min_element(ctx_ptr->rps_set.begin(), ctx_ptr->rps_set.end());
         }
 
-        manager_logger.trace("send_one_file(): error while sending hints from {}, last RP is {}", fname, _last_not_complete_rp);
+        manager_logger.trace("send_one_file(): error while sending hints from {}, last RP is {}", fname, last_not_complete_rp);
         return false;
     }
 
@@ -802,12 +808,71 @@ bool manager::end_point_hints_manager::sender::send_one_file(const sstring& fnam
     }).get();
 
     // clear the replay position - we are going to send the next segment...
-    _last_not_complete_rp = replay_position();
-    _last_schema_ver_to_column_mapping.clear();
+    last_not_complete_rp = replay_position();
+    schema_ver_to_column_mapping.clear();
     manager_logger.trace("send_one_file(): segment {} was sent in full and deleted", fname);
     return true;
 }
 
+std::vector<char> replay_segments_batch(std::list<sstring>& segments, size_t max_parallel, seastar::scheduling_group sg,
+        noncopyable_function<bool (size_t, const sstring&)> send_one) {
+    std::vector<sstring> batch;
+    for (auto it = segments.begin(); it != segments.end() && batch.size() < max_parallel; ++it) {
+        batch.push_back(*it);
+    }
+
+    std::vector<char> sent(batch.size(), false);
+    parallel_for_each(boost::irange<size_t>(0, batch.size()), [&] (size_t i) {
+        seastar::thread_attributes attr;
+
+        attr.sched_group = sg;
+        return seastar::async(std::move(attr), [&, i] {
+            // Don't let a failure of a single segment skip the bookkeeping of the ones that have been sent and deleted.
+            try {
+                sent[i] = send_one(i, batch[i]);
+            } catch (...) {
+                manager_logger.warn("Failed to replay hints from {}, going to retry: {}", batch[i], std::current_exception());
+            }
+        });
+    }).get();
+
+    auto it = segments.begin();
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (sent[i]) {
+            it = segments.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return sent;
+}
+
+// runs in a seastar::async context
+size_t manager::end_point_hints_manager::sender::send_segments_batch() {
+    size_t batch_size = std::min(_segments_to_replay.size(), max_parallel_segments);
+
+    // Segments other than the first one always start from the beginning, so they get their own (initially empty) state.
+    std::vector<replay_position> rps(batch_size);
+    std::vector<std::unordered_map<table_schema_version, column_mapping>> column_mappings(batch_size);
+
+    auto sent = replay_segments_batch(_segments_to_replay, max_parallel_segments, _hints_cpu_sched_group, [&] (size_t i, const sstring& fname) {
+        if (i == 0) {
+            return send_one_file(fname, _last_not_complete_rp, _last_schema_ver_to_column_mapping);
+        }
+        return send_one_file(fname, rps[i], column_mappings[i]);
+    });
+
+    // If the first segment has been sent but some other one hasn't, the latter is going to be the first one next time
+    // and it has to be replayed from the beginning.
+    if (sent[0]) {
+        _last_not_complete_rp = replay_position();
+        _last_schema_ver_to_column_mapping.clear();
+    }
+
+    return std::count(sent.begin(), sent.end(), true);
+}
+
 // Runs in the seastar::async context
 void manager::end_point_hints_manager::sender::send_hints_maybe() noexcept {
     using namespace std::literals::chrono_literals;
@@ -817,11 +882,12 @@ void manager::end_point_hints_manager::sender::send_hints_maybe() noexcept {
 
     try {
         while (replay_allowed() && have_segments()) {
-            if (!send_one_file(*_segments_to_replay.begin())) {
+            size_t batch_size = std::min(_segments_to_replay.size(), max_parallel_segments);
+            size_t sent_count = send_segments_batch();
+            replayed_segments_count += sent_count;
+            if (sent_count != batch_size) {
                 break;
             }
-            _segments_to_replay.pop_front();
-            ++replayed_segments_count;
         }
 
     // Ignore exceptions, we will retry sending this file from where we left off the next time.
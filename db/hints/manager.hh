@@ -31,6 +31,7 @@
 #include <seastar/core/timer.hh>
 #include <seastar/core/lowres_clock.hh>
 #include <seastar/core/shared_mutex.hh>
+#include <seastar/util/noncopyable_function.hh>
 #include "lister.hh"
 #include "gms/gossiper.hh"
 #include "locator/snitch_base.hh"
@@ -52,6 +53,20 @@ using hints_store_ptr = node_to_hint_store_factory_type::entry_ptr;
 using hint_entry_reader = commitlog_entry_reader;
 using timer_clock_type = seastar::lowres_clock;
 
+/// \brief Replay up to \ref max_parallel segments at the head of \ref segments concurrently.
+///
+/// Each segment is handed to \ref send_one in a seastar thread of its own running in \ref sg. A segment whose
+/// replay throws is treated as not sent, so the segments that have been sent are always accounted for.
+///
+/// Segments that have been sent in full are removed from \ref segments.
+///
+/// Runs in a seastar::async context.
+///
+/// \param send_one sends the segment at the given position of the batch; returns TRUE if it has been sent in full
+/// \return per segment of the batch: TRUE if it has been sent in full
+std::vector<char> replay_segments_batch(std::list<sstring>& segments, size_t max_parallel, seastar::scheduling_group sg,
+        noncopyable_function<bool (size_t, const sstring&)> send_one);
+
 class manager : public service::endpoint_lifecycle_subscriber {
 private:
     struct stats {
@@ -80,6 +95,11 @@ class manager : public service::endpoint_lifecycle_subscriber {
         using key_type = gms::inet_address;
 
         class sender {
+        public:
+            // Maximum number of hints files replayed concurrently to a single end point.
+            static constexpr size_t max_parallel_segments = 4;
+
+        private:
             // Important: clock::now() must be noexcept.
             // TODO: add the corresponding static_assert() when seastar::lowres_clock::now() is marked as "noexcept".
             using clock = seastar::lowres_clock;
@@ -213,8 +233,20 @@ class manager : public service::endpoint_lifecycle_subscriber {
             /// iteration from where we left in this one.
             ///
             /// \param fname file to send
+            /// \param last_not_complete_rp replay position to start from; updated with the position to resume from if sending fails
+            /// \param schema_ver_to_column_mapping column mappings read from this file so far
             /// \return TRUE if file has been successfully sent
-            bool send_one_file(const sstring& fname);
+            bool send_one_file(const sstring& fname, replay_position& last_not_complete_rp, std::unordered_map<table_schema_version, column_mapping>& schema_ver_to_column_mapping);
+
+            /// \brief Send the hints from up to \ref max_parallel_segments segments at the head of _segments_to_replay concurrently.
+            ///
+            /// Only the first segment resumes from _last_not_complete_rp. If any other segment fails it is going to be
+            /// re-sent from the beginning during the next attempt.
+            ///
+            /// Segments that have been sent in full are removed from _segments_to_replay.
+            ///
+            /// \return the number of segments that have been sent in full.
+            size_t send_segments_batch();
 
             /// \brief Checks if we can still send hints.
             /// \return TRUE if the destination Node is either ALIVE or has left the NORMAL state (e.g. has been decommissioned).
@@ -25,6 +25,7 @@
 #include <boost/range/algorithm/for_each.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include "disk-error-handler.hh"
+#include "service/priority_manager.hh"
 #include "seastarx.hh"
 #include <seastar/core/sleep.hh>
 
@@ -51,6 +52,46 @@ future<bool> is_mountpoint(const fs::path& path) {
     });
 }
 
+resource_manager::resource_manager(size_t max_send_in_flight_memory)
+    : _max_send_in_flight_memory(std::max(max_send_in_flight_memory, max_hints_send_queue_length))
+    , _min_send_hint_budget(_max_send_in_flight_memory / max_hints_send_queue_length)
+    , _send_limiter(_max_send_in_flight_memory, named_semaphore_exception_factory{"send limiter"})
+    , _space_watchdog(_shard_managers, _per_device_limits_map)
+    , _replay_budget(0, named_semaphore_exception_factory{"replay budget"})
+    , _replay_budget_timer([this] {
+        // Don't let the budget accumulate for more than a single second worth of replay, unless the oldest hint
+        // waiting for it needs more because the rate dropped after it started waiting.
+        size_t max_budget = std::max(max_replay_budget(), _replay_budget_waits.empty() ? 0 : _replay_budget_waits.front());
+        size_t available = std::max<ssize_t>(_replay_budget.available_units(), 0);
+        if (available < max_budget) {
+            _replay_budget.signal(std::min(_replay_budget_refill, max_budget - available));
+        }
+    })
+    , _replay_controller(default_scheduling_group(), service::get_local_streaming_read_priority(), std::chrono::milliseconds(1000),
+            [this] { return _space_watchdog.backlog(); },
+            [this] (float rate_mb_per_sec) {
+                size_t rate = rate_mb_per_sec * 1024 * 1024;
+                _replay_budget_refill = rate / (std::chrono::milliseconds(1000) / replay_budget_refill_period);
+                resource_manager_logger.trace("replay rate: {} bytes/s", rate);
+            })
+{
+    _replay_budget_timer.arm_periodic(replay_budget_refill_period);
+}
+
+size_t resource_manager::max_replay_budget() const noexcept {
+    return std::max<size_t>(_replay_budget_refill * (std::chrono::milliseconds(1000) / replay_budget_refill_period), 1);
+}
+
+future<> resource_manager::consume_replay_budget(size_t buf_size) {
+    // A hint bigger than the maximum budget would never be admitted - let it consume the whole budget instead.
+    size_t units = std::min(buf_size, max_replay_budget());
+    // The semaphore admits waiters in order, so the front of _replay_budget_waits is always the oldest waiter.
+    _replay_budget_waits.push_back(units);
+    return _replay_budget.wait(units).finally([this] {
+        _replay_budget_waits.pop_front();
+    });
+}
+
 future<semaphore_units<named_semaphore::exception_factory>> resource_manager::get_send_units_for(size_t buf_size) {
     // Let's approximate the memory size the mutation is going to consume by the size of its serialized form
     size_t hint_memory_budget = std::max(_min_send_hint_budget, buf_size);
@@ -133,6 +174,7 @@ void space_watchdog::on_timer() {
     //    |  |- ...
     //
 
+    float backlog = 0;
     for (auto& per_device_limits : _per_device_limits_map | boost::adaptors::map_values) {
         _total_size = 0;
         for (manager& shard_manager : per_device_limits.managers) {
@@ -169,7 +211,9 @@ void space_watchdog::on_timer() {
         for (manager& shard_manager : per_device_limits.managers) {
             shard_manager.update_backlog(_total_size, adjusted_quota);
         }
+        backlog = std::max(backlog, adjusted_quota ? float(_total_size) / adjusted_quota : 1.0f);
     }
+    _backlog = backlog;
 }
 
 future<> resource_manager::start(shared_ptr<service::storage_proxy> proxy_ptr, shared_ptr<gms::gossiper> gossiper_ptr, shared_ptr<service::storage_service> ss_ptr) {
@@ -187,8 +231,13 @@ void resource_manager::allow_replaying() noexcept {
 }
 
 future<> resource_manager::stop() noexcept {
+    // Draining senders don't consume the replay budget, so it's safe to break it before stopping the managers.
+    _replay_budget_timer.cancel();
+    _replay_budget.broken();
     return parallel_for_each(_shard_managers, [](manager& m) {
         return m.stop();
+    }).finally([this]() {
+        return _replay_controller.shutdown();
     }).finally([this]() {
         return _space_watchdog.stop();
     });
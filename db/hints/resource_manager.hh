@@ -28,10 +28,12 @@
 #include <seastar/core/memory.hh>
 #include <seastar/core/future.hh>
 #include "seastarx.hh"
+#include <deque>
 #include <unordered_set>
 #include <gms/gossiper.hh>
 #include "utils/small_vector.hh"
 #include "lister.hh"
+#include "backlog_controller.hh"
 
 namespace service {
 class storage_proxy;
@@ -82,12 +84,20 @@ class space_watchdog {
     future<> _started = make_ready_future<>();
     seastar::abort_source _as;
     int _files_count = 0;
+    float _backlog = 0;
 
 public:
     space_watchdog(shard_managers_set& managers, per_device_limits_map& per_device_limits_map);
     void start();
     future<> stop() noexcept;
 
+    /// \brief The fraction of the hints disk space quota consumed by hints files, as seen by the last scan.
+    ///
+    /// If managers share more than one device the most loaded device is reported.
+    float backlog() const noexcept {
+        return _backlog;
+    }
+
 private:
     /// \brief Check that hints don't occupy too much disk space.
     ///
@@ -123,24 +133,41 @@ class resource_manager {
     space_watchdog::per_device_limits_map _per_device_limits_map;
     space_watchdog _space_watchdog;
 
+    // Byte budget for hints replay: replenished every replay_budget_refill_period at the rate chosen by _replay_controller.
+    seastar::named_semaphore _replay_budget;
+    size_t _replay_budget_refill = 0;
+    // Units requested by the consume_replay_budget() calls which are waiting for the budget, oldest first.
+    std::deque<size_t> _replay_budget_waits;
+    timer<timer_clock_type> _replay_budget_timer;
+    hints_replay_controller _replay_controller;
+
 public:
     static constexpr size_t hint_segment_size_in_mb = 32;
     static constexpr size_t max_hints_per_ep_size_mb = 128; // 4 files 32MB each
     static constexpr size_t max_hints_send_queue_length = 128;
+    static constexpr std::chrono::milliseconds replay_budget_refill_period = std::chrono::milliseconds(100);
 
 public:
-    resource_manager(size_t max_send_in_flight_memory)
-        : _max_send_in_flight_memory(std::max(max_send_in_flight_memory, max_hints_send_queue_length))
-        , _min_send_hint_budget(_max_send_in_flight_memory / max_hints_send_queue_length)
-        , _send_limiter(_max_send_in_flight_memory, named_semaphore_exception_factory{"send limiter"})
-        , _space_watchdog(_shard_managers, _per_device_limits_map)
-    {}
+    resource_manager(size_t max_send_in_flight_memory);
 
     resource_manager(resource_manager&&) = delete;
     resource_manager& operator=(resource_manager&&) = delete;
 
     future<semaphore_units<named_semaphore::exception_factory>> get_send_units_for(size_t buf_size);
 
+    /// \brief Consume \ref buf_size bytes of the hints replay byte-rate budget.
+    ///
+    /// The budget is replenished periodically at the rate set by the hints replay controller, which grows
+    /// with the amount of hints pending on disk. This keeps a replay after a long outage from competing
+    /// with the user traffic while still making sure hints don't pile up until we run out of space.
+    ///
+    /// \param buf_size size of the hint that is about to be sent
+    /// \return future that resolves when the hint may be sent
+    future<> consume_replay_budget(size_t buf_size);
+
+    /// \return the most the replay budget accumulates to at the current replay rate: a single second worth of replay.
+    size_t max_replay_budget() const noexcept;
+
     future<> start(shared_ptr<service::storage_proxy> proxy_ptr, shared_ptr<gms::gossiper> gossiper_ptr, shared_ptr<service::storage_service> ss_ptr);
     void allow_replaying() noexcept;
     future<> stop() noexcept;
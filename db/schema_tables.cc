@@ -839,16 +839,71 @@ static utils::UUID table_id_from_mutations(const schema_mutations& sm) {
     return table_row.get_nonnull<utils::UUID>("id");
 }
 
+// Names of the tables and views whose definitions are touched by a set of
+// schema mutations, per keyspace. A keyspace maps to std::nullopt when the
+// mutations may affect definitions they don't name (e.g. a keyspace drop
+// deletes whole partitions), in which case all of its tables are compared.
+using affected_tables = std::map<sstring, std::optional<std::set<sstring>>>;
+
+// Schema tables which hold per-table definitions, clustered by the table name.
+static bool is_per_table_schema_table(const utils::UUID& id) {
+    static thread_local const std::unordered_set<utils::UUID> ids = {
+        tables()->id(), scylla_tables()->id(), columns()->id(), view_virtual_columns()->id(),
+        computed_columns()->id(), dropped_columns()->id(), indexes()->id(), views()->id(), triggers()->id(),
+    };
+    return ids.count(id);
+}
+
+static void collect_affected_tables(affected_tables& affected, const sstring& keyspace_name, const mutation& m) {
+    auto& names = affected.try_emplace(keyspace_name, std::set<sstring>()).first->second;
+    if (!names || !is_per_table_schema_table(m.column_family_id())) {
+        return;
+    }
+    const schema& s = *m.schema();
+    auto& p = m.partition();
+    if (p.partition_tombstone()) {
+        names = std::nullopt;
+        return;
+    }
+    auto table_name = [&s] (const clustering_key_prefix& ck) -> std::optional<sstring> {
+        if (ck.is_empty(s)) {
+            return std::nullopt;
+        }
+        return value_cast<sstring>(utf8_type->deserialize(*ck.begin(s)));
+    };
+    for (auto&& rt : p.row_tombstones()) {
+        // Dropping a table deletes its columns etc. with a range tombstone
+        // covering the table name prefix.
+        auto start = table_name(rt.start);
+        if (!start || start != table_name(rt.end)) {
+            names = std::nullopt;
+            return;
+        }
+        names->emplace(std::move(*start));
+    }
+    for (auto&& row : p.clustered_rows()) {
+        names->emplace(*table_name(row.key()));
+    }
+}
+
 // Call inside a seastar thread
 static
 std::map<utils::UUID, schema_mutations>
-read_tables_for_keyspaces(distributed<service::storage_proxy>& proxy, const std::set<sstring>& keyspace_names, schema_ptr s)
+read_tables_for_keyspaces(distributed<service::storage_proxy>& proxy, const affected_tables& affected, schema_ptr s)
 {
     std::map<utils::UUID, schema_mutations> result;
-    for (auto&& keyspace_name : keyspace_names) {
-        for (auto&& table_name : read_table_names_of_keyspace(proxy, keyspace_name, s).get0()) {
+    for (auto&& [keyspace_name, affected_names] : affected) {
+        auto table_names = affected_names
+                ? boost::copy_range<std::vector<sstring>>(*affected_names)
+                : read_table_names_of_keyspace(proxy, keyspace_name, s).get0();
+        for (auto&& table_name : table_names) {
             auto qn = qualified_name(keyspace_name, table_name);
             auto muts = read_table_mutations(proxy, qn, s).get0();
+            // Affected names may belong to the other kind (a table when
+            // reading views, or vice versa), or to a dropped definition.
+            if (!muts.columnfamilies_mutation().live_row_count()) {
+                continue;
+            }
             auto id = table_id_from_mutations(muts);
             result.emplace(std::move(id), std::move(muts));
         }
@@ -898,8 +953,13 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
        // compare before/after schemas of the affected keyspaces only
        std::set<sstring> keyspaces;
        std::set<utils::UUID> column_families;
+       // Only definitions named by the mutations can change, so compare
+       // those rather than every table of the affected keyspaces.
+       affected_tables affected;
        for (auto&& mutation : mutations) {
-           keyspaces.emplace(value_cast<sstring>(utf8_type->deserialize(mutation.key().get_component(*s, 0))));
+           auto keyspace_name = value_cast<sstring>(utf8_type->deserialize(mutation.key().get_component(*s, 0)));
+           collect_affected_tables(affected, keyspace_name, mutation);
+           keyspaces.emplace(std::move(keyspace_name));
            column_families.emplace(mutation.column_family_id());
            // We must force recalculation of schema version after the merge, since the resulting
            // schema may be a mix of the old and new schemas.
@@ -908,9 +968,9 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
 
        // current state of the schema
        auto&& old_keyspaces = read_schema_for_keyspaces(proxy, KEYSPACES, keyspaces).get0();
-       auto&& old_column_families = read_tables_for_keyspaces(proxy, keyspaces, tables());
+       auto&& old_column_families = read_tables_for_keyspaces(proxy, affected, tables());
        auto&& old_types = read_schema_for_keyspaces(proxy, TYPES, keyspaces).get0();
-       auto&& old_views = read_tables_for_keyspaces(proxy, keyspaces, views());
+       auto&& old_views = read_tables_for_keyspaces(proxy, affected, views());
        auto old_functions = read_schema_for_keyspaces(proxy, FUNCTIONS, keyspaces).get0();
 #if 0 // not in 2.1.8
        /*auto& old_aggregates = */read_schema_for_keyspaces(proxy, AGGREGATES, keyspaces).get0();
@@ -929,9 +989,9 @@ static future<> do_merge_schema(distributed<service::storage_proxy>& proxy, std:
 
        // with new data applied
        auto&& new_keyspaces = read_schema_for_keyspaces(proxy, KEYSPACES, keyspaces).get0();
-       auto&& new_column_families = read_tables_for_keyspaces(proxy, keyspaces, tables());
+       auto&& new_column_families = read_tables_for_keyspaces(proxy, affected, tables());
        auto&& new_types = read_schema_for_keyspaces(proxy, TYPES, keyspaces).get0();
-       auto&& new_views = read_tables_for_keyspaces(proxy, keyspaces, views());
+       auto&& new_views = read_tables_for_keyspaces(proxy, affected, views());
        auto new_functions = read_schema_for_keyspaces(proxy, FUNCTIONS, keyspaces).get0();
 #if 0 // not in 2.1.8
        /*auto& new_aggregates = */read_schema_for_keyspaces(proxy, AGGREGATES, keyspaces).get0();
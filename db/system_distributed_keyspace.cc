@@ -32,6 +32,7 @@
 #include <seastar/core/reactor.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
 #include <optional>
@@ -54,9 +55,35 @@ schema_ptr view_build_status() {
     return schema;
 }
 
+schema_ptr service_levels() {
+    static thread_local auto schema = [] {
+        auto id = generate_legacy_id(system_distributed_keyspace::NAME, system_distributed_keyspace::SERVICE_LEVELS);
+        return schema_builder(system_distributed_keyspace::NAME, system_distributed_keyspace::SERVICE_LEVELS, std::make_optional(id))
+                .with_column("service_level", utf8_type, column_kind::partition_key)
+                .with_column("shares", int32_type)
+                .with_version(system_keyspace::generate_schema_version(id))
+                .build();
+    }();
+    return schema;
+}
+
+schema_ptr role_service_levels() {
+    static thread_local auto schema = [] {
+        auto id = generate_legacy_id(system_distributed_keyspace::NAME, system_distributed_keyspace::ROLE_SERVICE_LEVELS);
+        return schema_builder(system_distributed_keyspace::NAME, system_distributed_keyspace::ROLE_SERVICE_LEVELS, std::make_optional(id))
+                .with_column("role", utf8_type, column_kind::partition_key)
+                .with_column("service_level", utf8_type)
+                .with_version(system_keyspace::generate_schema_version(id))
+                .build();
+    }();
+    return schema;
+}
+
 static std::vector<schema_ptr> all_tables() {
     return {
         view_build_status(),
+        service_levels(),
+        role_service_levels(),
     };
 }
 
@@ -151,4 +178,39 @@ future<> system_distributed_keyspace::remove_view(sstring ks_name, sstring view_
             false).discard_result();
 }
 
+future<std::unordered_map<sstring, std::optional<int32_t>>> system_distributed_keyspace::service_levels() const {
+    return _qp.process(
+            format("SELECT service_level, shares FROM {}.{}", NAME, SERVICE_LEVELS),
+            db::consistency_level::ONE,
+            internal_distributed_timeout_config,
+            { },
+            false).then([] (::shared_ptr<cql3::untyped_result_set> cql_result) {
+        return boost::copy_range<std::unordered_map<sstring, std::optional<int32_t>>>(*cql_result
+                | boost::adaptors::transformed([] (const cql3::untyped_result_set::row& row) {
+                    auto name = row.get_as<sstring>("service_level");
+                    auto shares = row.get_opt<int32_t>("shares");
+                    return std::pair(std::move(name), std::move(shares));
+                }));
+    });
+}
+
+future<std::unordered_map<sstring, sstring>> system_distributed_keyspace::role_service_levels() const {
+    return _qp.process(
+            format("SELECT role, service_level FROM {}.{}", NAME, ROLE_SERVICE_LEVELS),
+            db::consistency_level::ONE,
+            internal_distributed_timeout_config,
+            { },
+            false).then([] (::shared_ptr<cql3::untyped_result_set> cql_result) {
+        return boost::copy_range<std::unordered_map<sstring, sstring>>(*cql_result
+                | boost::adaptors::filtered([] (const cql3::untyped_result_set::row& row) {
+                    return row.has("service_level");
+                })
+                | boost::adaptors::transformed([] (const cql3::untyped_result_set::row& row) {
+                    auto role = row.get_as<sstring>("role");
+                    auto service_level = row.get_as<sstring>("service_level");
+                    return std::pair(std::move(role), std::move(service_level));
+                }));
+    });
+}
+
 }
@@ -38,6 +38,8 @@ class system_distributed_keyspace {
 public:
     static constexpr auto NAME = "system_distributed";
     static constexpr auto VIEW_BUILD_STATUS = "view_build_status";
+    static constexpr auto SERVICE_LEVELS = "service_levels";
+    static constexpr auto ROLE_SERVICE_LEVELS = "role_service_levels";
 
 private:
     cql3::query_processor& _qp;
@@ -53,6 +55,11 @@ class system_distributed_keyspace {
     future<> start_view_build(sstring ks_name, sstring view_name) const;
     future<> finish_view_build(sstring ks_name, sstring view_name) const;
     future<> remove_view(sstring ks_name, sstring view_name) const;
+
+    // Service level name to its CPU and I/O shares, missing shares are disengaged.
+    future<std::unordered_map<sstring, std::optional<int32_t>>> service_levels() const;
+    // Role name to the name of the service level attached to it.
+    future<std::unordered_map<sstring, sstring>> role_service_levels() const;
 };
 
 }
\ No newline at end of file
@@ -1806,6 +1806,7 @@ void make(database& db, bool durable, bool volatile_testing_only) {
             kscfg.enable_cache = true;
             // don't make system keyspace reads wait for user reads
             kscfg.read_concurrency_semaphore = &db._system_read_concurrency_sem;
+            kscfg.service_level_read_concurrency_semaphores = nullptr;
             // don't make system keyspace writes wait for user writes (if under pressure)
             kscfg.dirty_memory_manager = &db._system_dirty_memory_manager;
             keyspace _ks{ksm, std::move(kscfg)};
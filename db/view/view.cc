@@ -60,6 +60,7 @@
 #include "db/view/view_builder.hh"
 #include "db/system_keyspace_view_types.hh"
 #include "db/system_keyspace.hh"
+#include "db/config.hh"
 #include "frozen_mutation.hh"
 #include "gms/inet_address.hh"
 #include "keys.hh"
@@ -67,6 +68,7 @@
 #include "mutation.hh"
 #include "mutation_partition.hh"
 #include "service/migration_manager.hh"
+#include "service/priority_manager.hh"
 #include "service/storage_service.hh"
 #include "view_info.hh"
 #include "view_update_checks.hh"
@@ -915,6 +917,38 @@ future<std::vector<frozen_mutation_and_schema>> generate_view_updates(
     return f.finally([builder = std::move(builder)] { });
 }
 
+std::vector<frozen_mutation_and_schema> merge_view_updates(std::vector<frozen_mutation_and_schema> updates) {
+    if (updates.size() < 2) {
+        return updates;
+    }
+    using partition_index = std::unordered_map<partition_key, size_t, partition_key::hashing, partition_key::equality>;
+    // Keyed by schema version, updates are only merged when they were generated
+    // with the same one.
+    std::unordered_map<const schema*, partition_index> index;
+    std::vector<frozen_mutation_and_schema> merged;
+    // Unfrozen merge results, for the entries of `merged` more than one update went into.
+    std::unordered_map<size_t, mutation> unfrozen;
+    merged.reserve(updates.size());
+    for (auto& u : updates) {
+        auto& partitions = index.try_emplace(u.s.get(), 0, partition_key::hashing(*u.s), partition_key::equality(*u.s)).first->second;
+        auto [it, inserted] = partitions.try_emplace(u.fm.key(*u.s), merged.size());
+        if (inserted) {
+            merged.push_back(std::move(u));
+            continue;
+        }
+        auto& target = merged[it->second];
+        auto m = unfrozen.find(it->second);
+        if (m == unfrozen.end()) {
+            m = unfrozen.emplace(it->second, target.fm.unfreeze(target.s)).first;
+        }
+        m->second.apply(u.fm.unfreeze(u.s));
+    }
+    for (auto& [i, m] : unfrozen) {
+        merged[i].fm = freeze(m);
+    }
+    return merged;
+}
+
 query::clustering_row_ranges calculate_affected_clustering_ranges(const schema& base,
         const dht::decorated_key& key,
         const mutation_partition& mp,
@@ -1160,7 +1194,8 @@ future<> mutate_MV(
 view_builder::view_builder(database& db, db::system_distributed_keyspace& sys_dist_ks, service::migration_manager& mm)
         : _db(db)
         , _sys_dist_ks(sys_dist_ks)
-        , _mm(mm) {
+        , _mm(mm)
+        , _bulk_mode(db.get_config().view_building_bulk_mode()) {
 }
 
 future<> view_builder::start() {
@@ -1233,7 +1268,7 @@ void view_builder::initialize_reader_at_current_token(build_step& step) {
             make_lw_shared(sstables::sstable_set(step.base->get_sstable_set())),
             step.prange,
             step.pslice,
-            default_priority_class(),
+            _bulk_mode ? service::get_local_compaction_priority() : default_priority_class(),
             no_resource_tracking(),
             nullptr,
             streamed_mutation::forwarding::no,
@@ -1635,13 +1670,17 @@ class view_builder::consumer {
     }
 
     void check_for_built_views() {
+        if (_builder._bulk_mode && boost::algorithm::any_of(_step.build_status, [this] (const view_build_status& vs) { return is_built(vs); })) {
+            // Don't let a view be marked as built before its last updates are.
+            _builder.wait_for_pending_populates(_step);
+        }
         for (auto it = _step.build_status.begin(); it != _step.build_status.end();) {
             // A view starts being built at token t1. Due to resharding, that may not necessarily be a
             // shard-owned token. We finish building the view when the next_token to build is just before
             // (or at) the first token, but the shard-owned current token is after (or at) the first token.
             // In the system tables, we set first_token = next_token to signal the completion of the build
             // process in case of a restart.
-            if (it->next_token && *it->next_token <= it->first_token && _step.current_token() >= it->first_token) {
+            if (is_built(*it)) {
                 _built_views.views.push_back(std::move(*it));
                 it = _step.build_status.erase(it);
             } else {
@@ -1650,6 +1689,10 @@ class view_builder::consumer {
         }
     }
 
+    bool is_built(const view_build_status& vs) const {
+        return vs.next_token && *vs.next_token <= vs.first_token && _step.current_token() >= vs.first_token;
+    }
+
     stop_iteration consume_new_partition(const dht::decorated_key& dk) {
         _step.current_key = std::move(dk);
         check_for_built_views();
@@ -1691,10 +1734,12 @@ class view_builder::consumer {
         _builder._as.check();
         if (!_fragments.empty()) {
             _fragments.push_front(partition_start(_step.current_key, tombstone()));
-            _step.base->populate_views(
-                    _views_to_build,
-                    _step.current_token(),
-                    make_flat_mutation_reader_from_fragments(_step.base->schema(), std::move(_fragments))).get();
+            auto reader = make_flat_mutation_reader_from_fragments(_step.base->schema(), std::move(_fragments));
+            if (_builder._bulk_mode) {
+                _builder.populate_views_in_background(_step, _views_to_build, std::move(reader));
+            } else {
+                _step.base->populate_views(_views_to_build, _step.current_token(), std::move(reader)).get();
+            }
             _fragments.clear();
             _fragments_memory_usage = 0;
         }
@@ -1726,17 +1771,66 @@ class view_builder::consumer {
     }
 };
 
+void view_builder::populate_views_in_background(build_step& step, std::vector<view_ptr> views, flat_mutation_reader reader) {
+    auto units = get_units(_pending_populates, 1).get0();
+    auto token = step.current_token();
+    // The step's base table is pinned by the step until the populates in flight are waited for.
+    (void)step.base->populate_views(std::move(views), token, std::move(reader)).then_wrapped([this, token, units = std::move(units)] (future<> f) {
+        if (f.failed()) {
+            auto ep = f.get_exception();
+            if (!_populate_error || token < _populate_error_token) {
+                _populate_error = std::move(ep);
+                _populate_error_token = token;
+            }
+        }
+    });
+}
+
+// Waits for the populates in flight. If one of them failed, rewinds the step to
+// the base partition it was for, so that it is built again, and throws.
+// Called in the context of a seastar::thread.
+void view_builder::wait_for_pending_populates(build_step& step) {
+    get_units(_pending_populates, max_pending_populates).get();
+    if (!_populate_error) {
+        return;
+    }
+    auto ep = std::exchange(_populate_error, nullptr);
+    auto& token = _populate_error_token;
+    step.current_key = dht::decorated_key{token, partition_key::make_empty()};
+    for (auto& vs : step.build_status) {
+        if (vs.next_token && *vs.next_token > token) {
+            vs.next_token = token;
+        }
+    }
+    std::rethrow_exception(std::move(ep));
+}
+
 // Called in the context of a seastar::thread.
 void view_builder::execute(build_step& step, exponential_backoff_retry r) {
     auto consumer = compact_for_query<emit_only_live_rows::yes, view_builder::consumer>(
             *step.reader.schema(),
             gc_clock::now(),
             step.pslice,
-            batch_size,
+            _bulk_mode ? bulk_batch_size : batch_size,
             query::max_partitions,
             view_builder::consumer{*this, step});
     consumer.consume_new_partition(step.current_key); // Initialize the state in case we're resuming a partition
-    auto built = step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+    auto built = [&] {
+        if (!_bulk_mode) {
+            return step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+        }
+        try {
+            auto built = step.reader.consume_in_thread(std::move(consumer), db::no_timeout);
+            wait_for_pending_populates(step);
+            return built;
+        } catch (...) {
+            // The populates still in flight are for base partitions before the
+            // failure. If one of them failed too, the step is rewound to it.
+            wait_for_pending_populates(step);
+            throw;
+        }
+    }();
+    ++step.base->cf_stats()->view_building_steps;
 
     _as.check();
 
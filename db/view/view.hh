@@ -48,6 +48,10 @@ struct stats : public service::storage_proxy_stats::write_stats {
     int64_t view_updates_pushed_remote = 0;
     int64_t view_updates_failed_local = 0;
     int64_t view_updates_failed_remote = 0;
+    // Reads of existing base rows done to generate view updates, and how many
+    // of them were saved by sharing a read with other writes to the same partition.
+    int64_t view_update_base_reads = 0;
+    int64_t view_update_base_reads_coalesced = 0;
 
     stats(const sstring& category) : service::storage_proxy_stats::write_stats(category, false) { }
 };
@@ -105,6 +109,12 @@ future<std::vector<frozen_mutation_and_schema>> generate_view_updates(
         flat_mutation_reader&& updates,
         flat_mutation_reader_opt&& existings);
 
+/**
+ * Merges the view updates which pertain to the same view partition, so that
+ * each of them is sent to the paired view replica as a single mutation.
+ */
+std::vector<frozen_mutation_and_schema> merge_view_updates(std::vector<frozen_mutation_and_schema> updates);
+
 query::clustering_row_ranges calculate_affected_clustering_ranges(
         const schema& base,
         const dht::decorated_key& key,
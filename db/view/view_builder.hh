@@ -70,6 +70,13 @@ namespace db::view {
  * the same time, or consume more rows per batch), and also which would apply backpressure, so we
  * could, for example, delay executing a build step.
  *
+ * In bulk mode (the view_building_bulk_mode option), a build step consumes bulk_batch_size rows, and
+ * the view updates of up to max_pending_populates base partitions are generated and sent concurrently,
+ * while the step keeps reading the base sstables with the compaction priority class. All of them
+ * complete before the step's progress is recorded, and before a view is considered built, so the
+ * progress in the system tables never gets ahead of the view updates. Backpressure comes from the
+ * base table's view update concurrency semaphore.
+ *
  * View building is necessarily a sharded process. That means that on restart, if the number of shards
  * has changed, we need to calculate the most conservative token range that has been built, and build
  * the remainder.
@@ -164,6 +171,15 @@ class view_builder final : public service::migration_listener::only_view_notific
     seastar::shared_promise<> _shards_finished_read_promise;
     // Used for testing.
     std::unordered_map<std::pair<sstring, sstring>, seastar::shared_promise<>, utils::tuple_hash> _build_notifiers;
+    // Whether build steps are consumed and populated in bulk, from the
+    // view_building_bulk_mode option.
+    bool _bulk_mode;
+    // Populates of view updates in flight, in bulk mode.
+    seastar::semaphore _pending_populates{max_pending_populates};
+    // The first failure among the populates in flight, and the token of the
+    // base partition it was for.
+    std::exception_ptr _populate_error;
+    dht::token _populate_error_token;
 
 public:
     // The view builder processes the base table in steps of batch_size rows.
@@ -172,6 +188,9 @@ class view_builder final : public service::migration_listener::only_view_notific
     // collected batch_memory_max bytes, we can process the rows read so far.
     static constexpr size_t batch_size = 128;
     static constexpr size_t batch_memory_max = 1024*1024;
+    // Rows per build step, and populates in flight, in bulk mode.
+    static constexpr size_t bulk_batch_size = 2048;
+    static constexpr size_t max_pending_populates = 16;
 
 public:
     view_builder(database&, db::system_distributed_keyspace&, service::migration_manager&);
@@ -206,6 +225,8 @@ class view_builder final : public service::migration_listener::only_view_notific
     future<> do_build_step();
     void execute(build_step&, exponential_backoff_retry);
     future<> maybe_mark_view_as_built(view_ptr, dht::token);
+    void populate_views_in_background(build_step&, std::vector<view_ptr>, flat_mutation_reader);
+    void wait_for_pending_populates(build_step&);
 
     struct consumer;
 };
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "gms/gossip_digest.hh"
+#include "gms/inet_address.hh"
+#include "utils/chunked_vector.hh"
+
+namespace gms {
+
+/**
+ * Decides which digests a gossip round sends to each peer.
+ *
+ * A full digest carries one entry per endpoint in the cluster, which makes
+ * gossip traffic quadratic in the cluster size. The tracker remembers, per
+ * endpoint, the round in which its digest last changed, and per peer, the
+ * round in which we last sent to it, so a round can carry only the digests
+ * which changed since the previous exchange with that peer.
+ *
+ * Leaving digests out is safe on the wire: a receiver only compares the
+ * digests it was sent. It does mean that a peer which has newer state about
+ * an endpoint we consider unchanged won't hear about it from us, so every
+ * full_digest_interval-th exchange with a peer sends a full digest anyway.
+ */
+class digest_tracker {
+public:
+    using round_type = uint64_t;
+private:
+    struct endpoint_digest {
+        int32_t generation;
+        int32_t max_version;
+        round_type changed_at;
+    };
+    struct peer_state {
+        round_type last_sent;
+        unsigned deltas_since_full;
+    };
+
+    unsigned _full_digest_interval;
+    round_type _round = 0;
+    std::unordered_map<inet_address, endpoint_digest> _endpoints;
+    std::unordered_map<inet_address, peer_state> _peers;
+public:
+    // Every full_digest_interval-th exchange with a peer carries a full
+    // digest; with 1, all of them do.
+    explicit digest_tracker(unsigned full_digest_interval)
+        : _full_digest_interval(std::max(full_digest_interval, 1u)) {
+    }
+
+    // Starts a new round. Digests updated from now on count as changed in it.
+    void new_round() {
+        ++_round;
+    }
+
+    round_type current_round() const {
+        return _round;
+    }
+
+    // Records the current digest of an endpoint.
+    void update(const gossip_digest& d) {
+        auto [it, inserted] = _endpoints.try_emplace(d.get_endpoint(), endpoint_digest{d.get_generation(), d.get_max_version(), _round});
+        if (inserted) {
+            return;
+        }
+        auto& e = it->second;
+        if (e.generation != d.get_generation()) {
+            // The endpoint restarted and lost whatever we told it before.
+            _peers.erase(d.get_endpoint());
+        }
+        if (e.generation != d.get_generation() || e.max_version != d.get_max_version()) {
+            e = endpoint_digest{d.get_generation(), d.get_max_version(), _round};
+        }
+    }
+
+    // Makes the next digest sent to peer a full one, e.g. because it may
+    // have missed the previous ones while it was down, or because sending
+    // the last one failed.
+    void forget_peer(inet_address peer) {
+        _peers.erase(peer);
+    }
+
+    void remove(inet_address ep) {
+        _endpoints.erase(ep);
+        _peers.erase(ep);
+    }
+
+    // Picks, out of all digests of the current round, the ones to send to
+    // peer, and records the exchange. If the send fails, the caller must
+    // call forget_peer(), or the digests which changed before this round
+    // would not be sent to peer until the next full digest. Returns at least
+    // one digest when all isn't empty, since an empty syn asks for
+    // everything the receiver knows.
+    utils::chunked_vector<gossip_digest> digests_for(inet_address peer, const utils::chunked_vector<gossip_digest>& all) {
+        auto [it, first] = _peers.try_emplace(peer, peer_state{_round, 0});
+        auto& p = it->second;
+        auto last_sent = std::exchange(p.last_sent, _round);
+        if (first || ++p.deltas_since_full >= _full_digest_interval) {
+            p.deltas_since_full = 0;
+            return all;
+        }
+        utils::chunked_vector<gossip_digest> ret;
+        for (auto& d : all) {
+            auto e = _endpoints.find(d.get_endpoint());
+            if (e == _endpoints.end() || e->second.changed_at > last_sent) {
+                ret.push_back(d);
+            }
+        }
+        if (ret.empty() && !all.empty()) {
+            ret.push_back(all.front());
+        }
+        return ret;
+    }
+};
+
+} // namespace gms
@@ -128,7 +128,8 @@ class feature_enabler : public i_endpoint_state_change_subscriber {
 gossiper::gossiper(feature_service& features, db::config& cfg)
         : _feature_service(features)
         , _cfg(cfg)
-        , _fd(cfg.phi_convict_threshold()) {
+        , _fd(cfg.phi_convict_threshold())
+        , _digest_tracker(cfg.gossip_full_digest_interval()) {
     // Gossiper's stuff below runs only on CPU0
     if (engine().cpu_id() != 0) {
         return;
@@ -513,12 +514,10 @@ future<> gossiper::send_gossip(gossip_digest_syn message, std::set<inet_address>
     auto id = get_msg_addr(to);
     logger.trace("Sending a GossipDigestSyn to {} ...", id);
     _gossiped_to_seed = _seeds.count(to);
-    return ms().send_gossip_digest_syn(id, std::move(message)).handle_exception([id] (auto ep) {
-        // It is normal to reach here because it is normal that a node
-        // tries to send a SYN message to a peer node which is down before
-        // failure_detector thinks that peer node is down.
-        logger.trace("Fail to send GossipDigestSyn to {}: {}", id, ep);
-    });
+    // Failures are left to the callers. It is normal for a send to fail,
+    // because a node may send a SYN message to a peer node which is down
+    // before failure_detector thinks that peer node is down.
+    return ms().send_gossip_digest_syn(id, std::move(message));
 }
 
 
@@ -760,9 +759,12 @@ void gossiper::run() {
                 }
                 logger.debug("Talk to {} live nodes: {}", nr_live_nodes, live_nodes);
                 for (auto& ep: live_nodes) {
+                    gossip_digest_syn delta(get_cluster_name(), get_partitioner_name(), _digest_tracker.digests_for(ep, g_digests));
                     // Do it in the background.
-                    (void)do_gossip_to_live_member(message, ep).handle_exception([] (auto ep) {
-                        logger.trace("Failed to do_gossip_to_live_member: {}", ep);
+                    (void)do_gossip_to_live_member(std::move(delta), ep).handle_exception([this, ep, g = this->shared_from_this()] (auto ex) {
+                        // The peer didn't get the digests this exchange was recorded with.
+                        _digest_tracker.forget_peer(ep);
+                        logger.trace("Failed to do_gossip_to_live_member: {}", ex);
                     });
                 }
 
@@ -980,6 +982,7 @@ void gossiper::evict_from_membership(inet_address endpoint) {
         g.endpoint_state_map.erase(endpoint);
     }).get();
     _expire_time_endpoint_map.erase(endpoint);
+    _digest_tracker.remove(endpoint);
     fd().remove(endpoint);
     quarantine_endpoint(endpoint);
     logger.debug("evicting {} from gossip", endpoint);
@@ -1016,6 +1019,7 @@ void gossiper::make_random_gossip_digest(utils::chunked_vector<gossip_digest>& g
         endpoints.push_back(x.first);
     }
     std::shuffle(endpoints.begin(), endpoints.end(), _random_engine);
+    _digest_tracker.new_round();
     for (auto& endpoint : endpoints) {
         auto es = get_endpoint_state_for_endpoint_ptr(endpoint);
         if (es) {
@@ -1024,6 +1028,7 @@ void gossiper::make_random_gossip_digest(utils::chunked_vector<gossip_digest>& g
             max_version = get_max_endpoint_state_version(eps);
         }
         g_digests.push_back(gossip_digest(endpoint, generation, max_version));
+        _digest_tracker.update(g_digests.back());
     }
 #if 0
     if (logger.isTraceEnabled()) {
@@ -1442,6 +1447,8 @@ void gossiper::real_mark_alive(inet_address addr, endpoint_state& local_state) {
 
     local_state.mark_alive();
     local_state.update_timestamp(); // prevents do_status_check from racing us and evicting if it was down > A_VERY_LONG_TIME
+    // It may have missed our delta digests while it was down.
+    _digest_tracker.forget_peer(addr);
 
     logger.debug("removing expire time for endpoint : {}", addr);
     _unreachable_endpoints.erase(addr);
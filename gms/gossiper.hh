@@ -52,6 +52,7 @@
 #include "gms/feature.hh"
 #include "gms/gossip_digest_syn.hh"
 #include "gms/gossip_digest.hh"
+#include "gms/digest_tracker.hh"
 #include "utils/loading_shared_values.hh"
 #include "utils/in.hh"
 #include "message/messaging_service_fwd.hh"
@@ -595,6 +596,8 @@ class gossiper : public i_failure_detection_event_listener, public seastar::asyn
     feature_service& _feature_service;
     db::config& _cfg;
     failure_detector _fd;
+    // Decides which digests each live peer gets in a gossip round.
+    digest_tracker _digest_tracker;
     friend class feature;
     // Get features supported by a particular node
     std::set<sstring> get_supported_features(inet_address endpoint) const;
@@ -22,11 +22,17 @@
 #include "locator/abstract_replication_strategy.hh"
 #include "utils/class_registrator.hh"
 #include "exceptions/exceptions.hh"
+#include "to_string.hh"
+#include <seastar/core/thread.hh>
 
 namespace locator {
 
 logging::logger abstract_replication_strategy::logger("replication_strategy");
 
+std::ostream& operator<<(std::ostream& os, const endpoint_range& r) {
+    return os << "{" << ::join(", ", r) << "}";
+}
+
 abstract_replication_strategy::abstract_replication_strategy(
     const sstring& ks_name,
     token_metadata& token_metadata,
@@ -73,6 +79,11 @@ void abstract_replication_strategy::validate_replication_strategy(const sstring&
 }
 
 std::vector<inet_address> abstract_replication_strategy::get_natural_endpoints(const token& search_token) {
+    if (auto map = get_replication_map()) {
+        auto endpoints = map->natural_endpoints(search_token);
+        return std::vector<inet_address>(endpoints.begin(), endpoints.end());
+    }
+
     const token& key_token = _token_metadata.first_token(search_token);
     auto& cached_endpoints = get_cached_endpoints();
     auto res = cached_endpoints.find(key_token);
@@ -88,6 +99,96 @@ std::vector<inet_address> abstract_replication_strategy::get_natural_endpoints(c
     return res->second;
 }
 
+replication_map::endpoint_range abstract_replication_strategy::get_natural_endpoints_range(const token& search_token) {
+    if (auto map = get_replication_map()) {
+        return map->natural_endpoints(search_token);
+    }
+
+    const token& key_token = _token_metadata.first_token(search_token);
+    auto& cached_endpoints = get_cached_endpoints();
+    auto res = cached_endpoints.find(key_token);
+
+    if (res == cached_endpoints.end()) {
+        res = cached_endpoints.emplace(key_token, calculate_natural_endpoints(search_token, _token_metadata)).first;
+    } else {
+        ++_cache_hits_count;
+    }
+    auto& endpoints = res->second;
+    return endpoint_range(endpoints.data(), endpoints.data() + endpoints.size());
+}
+
+std::vector<inet_address> abstract_replication_strategy::get_pending_endpoints(const token& search_token) {
+    if (auto map = get_replication_map()) {
+        auto endpoints = map->pending_endpoints(search_token);
+        if (endpoints.empty()) {
+            return {};
+        }
+        return std::vector<inet_address>(endpoints.begin(), endpoints.end());
+    }
+    return _token_metadata.pending_endpoints_for(search_token, _ks_name);
+}
+
+const replication_map* abstract_replication_strategy::get_replication_map() const {
+    if (_replication_map && _replication_map->is_current(_token_metadata)) {
+        return _replication_map.get();
+    }
+    return nullptr;
+}
+
+future<replication_map> replication_map::build(const abstract_replication_strategy& rs, token_metadata& tm) {
+    return seastar::async([&rs, &tm] {
+        auto& ks_name = rs.get_keyspace_name();
+        replication_map map(ks_name, tm.get_ring_version(), tm.get_pending_ranges_version(ks_name));
+
+        map._tokens = tm.sorted_tokens();
+        map._offsets.reserve(map._tokens.size() + 1);
+        map._offsets.push_back(0);
+        for (auto& t : map._tokens) {
+            auto endpoints = rs.calculate_natural_endpoints(t, tm);
+            map._endpoints.insert(map._endpoints.end(), endpoints.begin(), endpoints.end());
+            map._offsets.push_back(map._endpoints.size());
+            seastar::thread::maybe_yield();
+        }
+
+        if (auto pending = tm.get_pending_ranges_interval_map(ks_name)) {
+            map._pending.reserve(pending->iterative_size());
+            for (auto& [interval, endpoints] : *pending) {
+                uint32_t begin = map._pending_endpoints.size();
+                map._pending_endpoints.insert(map._pending_endpoints.end(), endpoints.begin(), endpoints.end());
+                map._pending.push_back(pending_segment{interval, begin, uint32_t(map._pending_endpoints.size())});
+            }
+        }
+        return map;
+    });
+}
+
+replication_map::endpoint_range replication_map::natural_endpoints(const token& search_token) const {
+    if (_tokens.empty()) {
+        return endpoint_range(nullptr, nullptr);
+    }
+    // Same as token_metadata::first_token(): the first ring token not
+    // smaller than search_token, wrapping around past the last one.
+    auto it = std::lower_bound(_tokens.begin(), _tokens.end(), search_token);
+    size_t idx = it == _tokens.end() ? 0 : std::distance(_tokens.begin(), it);
+    auto data = _endpoints.data();
+    return endpoint_range(data + _offsets[idx], data + _offsets[idx + 1]);
+}
+
+replication_map::endpoint_range replication_map::pending_endpoints(const token& search_token) const {
+    if (_pending.empty()) {
+        return endpoint_range(nullptr, nullptr);
+    }
+    auto point = token_metadata::range_to_interval(range<token>(search_token));
+    auto it = std::partition_point(_pending.begin(), _pending.end(), [&point] (const pending_segment& s) {
+        return boost::icl::exclusive_less(s.interval, point);
+    });
+    if (it == _pending.end() || !boost::icl::contains(it->interval, search_token)) {
+        return endpoint_range(nullptr, nullptr);
+    }
+    auto data = _pending_endpoints.data();
+    return endpoint_range(data + it->begin, data + it->end);
+}
+
 void abstract_replication_strategy::validate_replication_factor(sstring rf) const
 {
     try {
@@ -24,6 +24,7 @@
 #include <memory>
 #include <functional>
 #include <unordered_map>
+#include <boost/range/iterator_range.hpp>
 #include "gms/inet_address.hh"
 #include "dht/i_partitioner.hh"
 #include "token_metadata.hh"
@@ -44,11 +45,70 @@ enum class replication_strategy_type {
     everywhere_topology,
 };
 
+class abstract_replication_strategy;
+
+// A view of a replica set, owned by whoever handed it out.
+class endpoint_range : public boost::iterator_range<const inet_address*> {
+public:
+    using iterator_range::iterator_range;
+};
+
+std::ostream& operator<<(std::ostream& os, const endpoint_range& r);
+
+// An immutable snapshot of the replicas of a keyspace: the natural endpoints
+// of every ring token and the pending endpoints of every pending range, as of
+// one ring version. It is built once per topology change, away from the
+// request path, and lookups into it return ranges over its own storage
+// instead of copying.
+class replication_map {
+public:
+    using endpoint_range = locator::endpoint_range;
+private:
+    struct pending_segment {
+        boost::icl::interval<token>::interval_type interval;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    sstring _keyspace_name;
+    long _ring_version;
+    long _pending_ranges_version;
+    std::vector<token> _tokens;
+    // Replicas of _tokens[i] are _endpoints[_offsets[i]] .. _endpoints[_offsets[i + 1]].
+    std::vector<uint32_t> _offsets;
+    std::vector<inet_address> _endpoints;
+    // Disjoint, sorted segments of the pending ranges interval map.
+    std::vector<pending_segment> _pending;
+    std::vector<inet_address> _pending_endpoints;
+
+    replication_map(sstring keyspace_name, long ring_version, long pending_ranges_version)
+        : _keyspace_name(std::move(keyspace_name))
+        , _ring_version(ring_version)
+        , _pending_ranges_version(pending_ranges_version) {
+    }
+public:
+    // Computes the replicas of every token of tm's ring. Runs
+    // calculate_natural_endpoints() once per ring token, so it is not meant
+    // for the fast path, and yields between tokens. rs and tm must not
+    // change or go away until the returned future resolves.
+    static future<replication_map> build(const abstract_replication_strategy& rs, token_metadata& tm);
+
+    // Whether this snapshot still describes tm.
+    bool is_current(const token_metadata& tm) const {
+        return _ring_version == tm.get_ring_version()
+                && _pending_ranges_version == tm.get_pending_ranges_version(_keyspace_name);
+    }
+
+    endpoint_range natural_endpoints(const token& search_token) const;
+    endpoint_range pending_endpoints(const token& search_token) const;
+};
+
 class abstract_replication_strategy {
 private:
     long _last_invalidated_ring_version = 0;
     std::unordered_map<token, std::vector<inet_address>> _cached_endpoints;
     uint64_t _cache_hits_count = 0;
+    lw_shared_ptr<const replication_map> _replication_map;
 
     static logging::logger logger;
 
@@ -95,6 +155,21 @@ class abstract_replication_strategy {
                                               token_metadata& token_metadata,
                                               const std::map<sstring, sstring>& config_options);
     virtual std::vector<inet_address> get_natural_endpoints(const token& search_token);
+    // Like get_natural_endpoints(), but doesn't copy the replica set. The
+    // returned range is valid until the next call, a ring change or the
+    // installation of a new replication map, so it must not be held across
+    // a preemption point.
+    virtual replication_map::endpoint_range get_natural_endpoints_range(const token& search_token);
+    // Returns the endpoints which are about to become replicas of search_token.
+    // Doesn't allocate unless there are any.
+    std::vector<inet_address> get_pending_endpoints(const token& search_token);
+
+    const sstring& get_keyspace_name() const { return _ks_name; }
+    // Installs a precomputed replica snapshot. Lookups are served from it for
+    // as long as it matches the token metadata; once it doesn't, they fall
+    // back to calculating and caching replica sets one ring token at a time.
+    void set_replication_map(lw_shared_ptr<const replication_map> map) { _replication_map = std::move(map); }
+    const replication_map* get_replication_map() const;
     virtual void validate_options() const = 0;
     virtual std::optional<std::set<sstring>> recognized_options() const = 0;
     virtual size_t get_replication_factor() const = 0;
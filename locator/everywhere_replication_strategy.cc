@@ -53,6 +53,11 @@ std::vector<inet_address> everywhere_replication_strategy::get_natural_endpoints
     return calculate_natural_endpoints(search_token, _token_metadata);
 }
 
+replication_map::endpoint_range everywhere_replication_strategy::get_natural_endpoints_range(const token& search_token) {
+    _natural_endpoints = get_natural_endpoints(search_token);
+    return endpoint_range(_natural_endpoints.data(), _natural_endpoints.data() + _natural_endpoints.size());
+}
+
 using registry = class_registrator<abstract_replication_strategy, everywhere_replication_strategy, const sstring&, token_metadata&, snitch_ptr&, const std::map<sstring, sstring>&>;
 static registry registrator("org.apache.cassandra.locator.EverywhereStrategy");
 static registry registrator_short_name("EverywhereStrategy");
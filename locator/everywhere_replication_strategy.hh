@@ -50,6 +50,7 @@ class everywhere_replication_strategy : public abstract_replication_strategy {
         return tm.get_all_endpoints();
     }
     std::vector<inet_address> get_natural_endpoints(const token& search_token) override;
+    replication_map::endpoint_range get_natural_endpoints_range(const token& search_token) override;
 
     virtual void validate_options() const override { /* noop */ }
 
@@ -61,5 +62,8 @@ class everywhere_replication_strategy : public abstract_replication_strategy {
     virtual size_t get_replication_factor() const override {
         return _token_metadata.get_all_endpoints_count();
     }
+private:
+    // Backs the range returned by get_natural_endpoints_range().
+    std::vector<inet_address> _natural_endpoints;
 };
 }
@@ -34,6 +34,11 @@ std::vector<inet_address> local_strategy::get_natural_endpoints(const token& t)
     return calculate_natural_endpoints(t, _token_metadata);
 }
 
+replication_map::endpoint_range local_strategy::get_natural_endpoints_range(const token& t) {
+    _natural_endpoints = get_natural_endpoints(t);
+    return endpoint_range(_natural_endpoints.data(), _natural_endpoints.data() + _natural_endpoints.size());
+}
+
 std::vector<inet_address> local_strategy::calculate_natural_endpoints(const token& t, token_metadata& tm) const {
     return std::vector<inet_address>({utils::fb_utilities::get_broadcast_address()});
 }
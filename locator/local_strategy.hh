@@ -47,10 +47,14 @@ class local_strategy : public abstract_replication_strategy {
      * LocalStrategy may be used before tokens are set up.
      */
     std::vector<inet_address> get_natural_endpoints(const token& search_token) override;
+    replication_map::endpoint_range get_natural_endpoints_range(const token& search_token) override;
 
     virtual void validate_options() const override;
 
     virtual std::optional<std::set<sstring>> recognized_options() const override;
+private:
+    // Backs the range returned by get_natural_endpoints_range().
+    std::vector<inet_address> _natural_endpoints;
 };
 
 }
@@ -416,6 +416,13 @@ token_metadata::interval_to_range(boost::icl::interval<token>::interval_type i)
 
 void token_metadata::set_pending_ranges(const sstring& keyspace_name,
         std::unordered_multimap<range<token>, inet_address> new_pending_ranges) {
+    // Pending ranges are recalculated for every keyspace at once, but usually
+    // change for few of them, if any. Don't invalidate the others' snapshots.
+    auto old = _pending_ranges.find(keyspace_name);
+    if (old == _pending_ranges.end() ? new_pending_ranges.empty() : old->second == new_pending_ranges) {
+        return;
+    }
+    _keyspace_pending_ranges_version[keyspace_name] = ++_pending_ranges_version;
     if (new_pending_ranges.empty()) {
         _pending_ranges.erase(keyspace_name);
         _pending_ranges_map.erase(keyspace_name);
@@ -447,6 +454,15 @@ token_metadata::get_pending_ranges(sstring keyspace_name) {
     return _pending_ranges_map[keyspace_name];
 }
 
+const boost::icl::interval_map<token, std::unordered_set<inet_address>>*
+token_metadata::get_pending_ranges_interval_map(const sstring& keyspace_name) const {
+    auto it = _pending_ranges_interval_map.find(keyspace_name);
+    if (it == _pending_ranges_interval_map.end() || it->second.empty()) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
 std::vector<range<token>>
 token_metadata::get_pending_ranges(sstring keyspace_name, inet_address endpoint) {
     std::vector<range<token>> ret;
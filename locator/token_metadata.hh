@@ -159,6 +159,9 @@ class token_metadata final {
     topology _topology;
 
     long _ring_version = 0;
+    long _pending_ranges_version = 0;
+    // The _pending_ranges_version at which each keyspace's pending ranges last changed.
+    std::unordered_map<sstring, long> _keyspace_pending_ranges_version;
 
     std::vector<token> sort_tokens();
 
@@ -607,6 +610,11 @@ class token_metadata final {
     const std::unordered_map<range<token>, std::unordered_set<inet_address>>& get_pending_ranges(sstring keyspace_name);
 
     std::vector<range<token>> get_pending_ranges(sstring keyspace_name, inet_address endpoint);
+
+    // Returns the pending ranges of keyspace_name as an interval map, or
+    // nullptr if the keyspace has none.
+    const boost::icl::interval_map<token, std::unordered_set<inet_address>>*
+    get_pending_ranges_interval_map(const sstring& keyspace_name) const;
      /**
      * Calculate pending ranges according to bootsrapping and leaving nodes. Reasoning is:
      *
@@ -1011,6 +1019,14 @@ class token_metadata final {
         ++_ring_version;
         //cachedTokenMap.set(null);
     }
+
+    // Bumped whenever the pending ranges of keyspace_name change. Pending
+    // ranges are recalculated without changing the ring, so snapshots of
+    // them can't rely on the ring version alone.
+    long get_pending_ranges_version(const sstring& keyspace_name) const {
+        auto it = _keyspace_pending_ranges_version.find(keyspace_name);
+        return it == _keyspace_pending_ranges_version.end() ? 0 : it->second;
+    }
 };
 
 }
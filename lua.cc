@@ -60,6 +60,10 @@ class lua_slice_state {
         : a_state(std::move(a_state))
         , _l(std::move(l)) {}
     operator lua_State*() { return _l.get(); }
+    void set_limits(size_t max, size_t max_contiguous) {
+        a_state->max = max;
+        a_state->max_contiguous = max_contiguous;
+    }
 };
 }
 
@@ -422,6 +426,20 @@ static int load_script_l(lua_State* l) {
     lua_setfield(l, -2, "__index");
     luaL_setfuncs(l, decimal_methods, 0);
 
+    // The state is reused by later calls, see new_call_l(). Hide the
+    // metatables all calls share, through which a call could change
+    // what the next ones see.
+    lua_pushboolean(l, false);
+    lua_setfield(l, -2, "__metatable");
+    lua_pop(l, 1);
+    lua_pushliteral(l, "");
+    if (lua_getmetatable(l, -1)) {
+        lua_pushboolean(l, false);
+        lua_setfield(l, -2, "__metatable");
+        lua_pop(l, 1);
+    }
+    lua_pop(l, 1);
+
     if (luaL_loadbufferx(l, binary.data(), binary.size(), "<internal>", "b")) {
         lua_error(l);
     }
@@ -469,7 +487,7 @@ static sstring get_string(lua_State *l, int index) {
         }));
 }
 
-static data_value convert_from_lua(lua_slice_state &l, const data_type& type);
+static data_value convert_from_lua(lua_State* l, const data_type& type);
 
 namespace {
 struct lua_date_table {
@@ -576,7 +594,7 @@ struct timestamp_return_visitor {
 };
 
 struct from_lua_visitor {
-    lua_slice_state& l;
+    lua_State* l;
 
     data_value operator()(const reversed_type_impl& t) {
         // This is unreachable since reversed_type_impl is used only
@@ -887,11 +905,11 @@ db_clock::time_point timestamp_return_visitor::operator()(const lua_table&) {
 }
 }
 
-static data_value convert_from_lua(lua_slice_state &l, const data_type& type) {
+static data_value convert_from_lua(lua_State* l, const data_type& type) {
     return ::visit(*type, from_lua_visitor{l});
 }
 
-static bytes convert_return(lua_slice_state &l, const data_type& return_type) {
+static bytes convert_return(lua_State* l, const data_type& return_type) {
     int num_return_vals = lua_gettop(l);
     if (num_return_vals != 1) {
         throw exceptions::invalid_request_exception(
@@ -904,15 +922,15 @@ static bytes convert_return(lua_slice_state &l, const data_type& return_type) {
     return convert_from_lua(l, return_type).serialize();
 }
 
-static void push_sstring(lua_slice_state& l, const sstring& v) {
+static void push_sstring(lua_State* l, const sstring& v) {
     lua_pushlstring(l, v.c_str(), v.size());
 }
 
-static void push_argument(lua_slice_state& l, const data_value& arg);
+static void push_argument(lua_State* l, const data_value& arg);
 
 namespace {
 struct to_lua_visitor {
-    lua_slice_state& l;
+    lua_State* l;
 
     void operator()(const varint_type_impl& t, const emptyable<boost::multiprecision::cpp_int>* v) {
         push_cpp_int(l, *v);
@@ -1048,7 +1066,7 @@ struct to_lua_visitor {
 };
 }
 
-static void push_argument(lua_slice_state& l, const data_value& arg) {
+static void push_argument(lua_State* l, const data_value& arg) {
     if (arg.is_null()) {
         lua_pushnil(l);
         return;
@@ -1064,15 +1082,115 @@ lua::runtime_config lua::make_runtime_config(const db::config& config) {
     return lua::runtime_config{std::move(timeout_in_ms), std::move(max_bytes), std::move(max_contiguous)};
 }
 
-// run the script for at most max_instructions
-future<bytes> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
-    lua_slice_state l = load_script(cfg, bitcode);
+namespace {
+// Idle Lua states with the bitcode of a UDF already loaded, by bitcode.
+//
+// Creating a state, opening the libraries and loading the bitcode costs far
+// more than running a typical UDF, which a SELECT runs for every row. The
+// pool is bounded, since nothing tells it when a function is dropped.
+class lua_state_pool {
+    static constexpr size_t max_functions = 64;
+    static constexpr size_t max_idle_states_per_function = 4;
+    struct function_states {
+        // Tells the function apart from one whose bitcode was later
+        // allocated at the same address, after the first was dropped.
+        sstring bitcode;
+        std::vector<lua_slice_state> idle;
+    };
+    // Keyed by the address of the bitcode, which the function owns, so
+    // that a lookup needn't copy or hash it.
+    std::unordered_map<const char*, function_states> _functions;
+public:
+    lua_slice_state get(const lua::runtime_config& cfg, lua::bitcode_view bitcode) {
+        auto i = _functions.find(bitcode.bitcode.data());
+        if (i == _functions.end() || i->second.idle.empty() || std::string_view(i->second.bitcode) != bitcode.bitcode) {
+            return load_script(cfg, bitcode);
+        }
+        auto l = std::move(i->second.idle.back());
+        i->second.idle.pop_back();
+        // The limits may have changed since the state was created.
+        l.set_limits(cfg.max_bytes, cfg.max_contiguous);
+        return l;
+    }
+    void put(lua::bitcode_view bitcode, lua_slice_state l) {
+        auto i = _functions.find(bitcode.bitcode.data());
+        if (i == _functions.end()) {
+            if (_functions.size() >= max_functions) {
+                _functions.erase(_functions.begin());
+            }
+            i = _functions.emplace(bitcode.bitcode.data(), function_states{sstring(bitcode.bitcode), {}}).first;
+        } else if (std::string_view(i->second.bitcode) != bitcode.bitcode) {
+            i->second = function_states{sstring(bitcode.bitcode), {}};
+        }
+        if (i->second.idle.size() < max_idle_states_per_function) {
+            i->second.idle.push_back(std::move(l));
+        }
+    }
+};
+
+thread_local lua_state_pool state_pool;
+}
+
+// Replaces the table at the top of the stack with a shallow copy of it.
+static void copy_table(lua_State* l) {
+    int src = lua_gettop(l);
+    lua_newtable(l);
+    lua_pushnil(l);
+    while (lua_next(l, src)) {
+        lua_pushvalue(l, -2);
+        lua_insert(l, -2);
+        lua_rawset(l, -4);
+    }
+    lua_replace(l, src);
+}
+
+// Creates a thread to run the loaded chunk, passed as the only argument, in
+// a sandbox of its own: a fresh global environment, with copies of the
+// library tables and with _G pointing to it. Whatever one call changes is
+// thus not seen by the next one run in the same state.
+static int new_call_l(lua_State* l) {
+    lua_State* thread = lua_newthread(l);
+    lua_pushvalue(l, 1);
+    lua_newtable(l);
+    int env = lua_gettop(l);
+    lua_pushglobaltable(l);
+    int globals = lua_gettop(l);
+    lua_pushnil(l);
+    while (lua_next(l, globals)) {
+        if (lua_rawequal(l, -1, globals)) {
+            lua_pop(l, 1);
+            lua_pushvalue(l, env);
+        } else if (lua_istable(l, -1)) {
+            copy_table(l);
+        }
+        lua_pushvalue(l, -2);
+        lua_insert(l, -2);
+        lua_rawset(l, env);
+    }
+    lua_pop(l, 1);
+    // The only upvalue of a main chunk is its _ENV.
+    lua_setupvalue(l, -2, 1);
+    lua_xmove(l, thread, 1);
+    return 1;
+}
+
+// Runs the chunk loaded in l once. On success, l is left as it was, so it can
+// run the chunk again. On failure, l must not be reused.
+static future<bytes> run_in_state(lua_slice_state& l, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
+    // The loaded chunk is at the bottom of the stack.
+    lua_settop(l, 1);
+    lua_pushcfunction(l, new_call_l);
+    lua_pushvalue(l, 1);
+    if (lua_pcall(l, 1, 1, 0)) {
+        throw std::runtime_error(std::string("could not initiate: ") + lua_tostring(l, -1));
+    }
+    lua_State* thread = lua_tothread(l, -1);
     unsigned nargs = values.size();
-    if (!lua_checkstack(l, nargs)) {
+    if (!lua_checkstack(thread, nargs)) {
         throw std::runtime_error("could push args to the stack");
     }
     for (const data_value& arg : values) {
-        push_argument(l, arg);
+        push_argument(thread, arg);
     }
 
     // We don't update the timeout once we start executing the function
@@ -1080,15 +1198,18 @@ future<bytes> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_
     using duration = std::chrono::system_clock::duration;
     duration elapsed{0};
     duration timeout = std::chrono::duration_cast<duration>(millisecond(cfg.timeout_in_ms));
-    return repeat_until_value([l = std::move(l), elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
+    return repeat_until_value([&l, thread, elapsed, return_type, nargs, timeout = std::move(timeout)] () mutable {
         // Set the hook before resuming. We have to do it here since the hook can reset itself
         // if it detects we are spending too much time in C.
         // The hook will be called after 1000 instructions.
-        lua_sethook(l, debug_hook, LUA_MASKCALL | LUA_MASKCOUNT, 1000);
+        lua_sethook(thread, debug_hook, LUA_MASKCALL | LUA_MASKCOUNT, 1000);
         auto start = ::now();
-        switch (lua_resume(l, nullptr, nargs)) {
-        case LUA_OK:
-            return make_ready_future<bytes_opt>(convert_return(l, return_type));
+        switch (lua_resume(thread, nullptr, nargs)) {
+        case LUA_OK: {
+            auto ret = convert_return(thread, return_type);
+            lua_settop(l, 1);
+            return make_ready_future<bytes_opt>(std::move(ret));
+        }
         case LUA_YIELD: {
             nargs = 0;
             elapsed += ::now() - start;
@@ -1100,7 +1221,18 @@ future<bytes> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_
         }
         default:
             throw exceptions::invalid_request_exception(std::string("lua execution failed: ") +
-                                                        lua_tostring(l, -1));
+                                                        lua_tostring(thread, -1));
         }
     });
 }
+
+// run the script for at most max_instructions
+future<bytes> lua::run_script(lua::bitcode_view bitcode, const std::vector<data_value>& values, data_type return_type, const lua::runtime_config& cfg) {
+    auto l = state_pool.get(cfg, bitcode);
+    return do_with(std::move(l), [bitcode, &values, return_type = std::move(return_type), &cfg] (lua_slice_state& l) {
+        return run_in_state(l, values, return_type, cfg).then([bitcode, &l] (bytes ret) {
+            state_pool.put(bitcode, std::move(l));
+            return ret;
+        });
+    });
+}
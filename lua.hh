@@ -41,6 +41,7 @@ struct runtime_config {
 runtime_config make_runtime_config(const db::config& config);
 
 sstring compile(const runtime_config& cfg, const std::vector<sstring>& arg_names, sstring script);
+// The bitcode, values and cfg must be kept alive until the returned future resolves.
 seastar::future<bytes> run_script(bitcode_view bitcode, const std::vector<data_value>& values,
                                   data_type return_type, const runtime_config& cfg);
 }
@@ -42,6 +42,7 @@
 #include "db/hints/manager.hh"
 #include "db/commitlog/commitlog_replayer.hh"
 #include "db/view/view_builder.hh"
+#include "db/cache_warmer.hh"
 #include "utils/runtime.hh"
 #include "log.hh"
 #include "utils/directories.hh"
@@ -65,6 +66,7 @@
 
 #include "db/view/view_update_generator.hh"
 #include "service/cache_hitrate_calculator.hh"
+#include "service/qos/service_level_controller.hh"
 #include "sstables/compaction_manager.hh"
 #include "sstables/sstables.hh"
 #include "gms/feature_service.hh"
@@ -935,6 +937,17 @@ int main(int ac, char** av) {
             auto max_memory_repair = db.local().get_available_memory() * 0.1;
             repair_service rs(gossiper, max_memory_repair);
             repair_init_messaging_service_handler(rs, sys_dist_ks, view_update_generator).get();
+            static sharded<db::cache_warmer> cache_warmer;
+            if (cfg->row_cache_save_period()) {
+                // Starts reading the saved hot partitions into cache in the background,
+                // so that the node has some of them cached by the time it joins.
+                supervisor::notify("starting cache warm-up");
+                cache_warmer.start(std::ref(db), std::cref(*cfg)).get();
+                cache_warmer.invoke_on_all(&db::cache_warmer::start).get();
+            }
+            auto stop_cache_warmer = defer_verbose_shutdown("cache warmer", [] {
+                cache_warmer.stop().get();
+            });
             supervisor::notify("starting storage service", true);
             auto& ss = service::get_local_storage_service();
             ss.init_messaging_service_part().get();
@@ -995,6 +1008,19 @@ int main(int ac, char** av) {
             // Truncate `clients' CF - this table should not persist between server restarts.
             clear_clientlist().get();
 
+            if (cfg->cpu_scheduler()) {
+                supervisor::notify("starting service level controller");
+                auto& sl_controller = qos::get_service_level_controller();
+                sl_controller.start(std::ref(db), dbcfg.statement_scheduling_group).get();
+                sl_controller.invoke_on_all(&qos::service_level_controller::start, std::ref(sys_dist_ks.local())).get();
+            }
+            auto stop_service_level_controller = defer_verbose_shutdown("service level controller", [] {
+                auto& sl_controller = qos::get_service_level_controller();
+                if (sl_controller.local_is_initialized()) {
+                    sl_controller.stop().get();
+                }
+            });
+
             supervisor::notify("starting native transport");
             with_scheduling_group(dbcfg.statement_scheduling_group, [] {
                 return service::get_local_storage_service().start_native_transport();
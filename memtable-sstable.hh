@@ -44,3 +44,15 @@ write_memtable_to_sstable(memtable& mt,
 future<>
 write_memtable_to_sstable(memtable& mt,
         sstables::shared_sstable sst);
+
+// Writes the part of mt within range, which must be kept alive until the
+// write completes, as a member of the sstable run identified by run_id.
+future<>
+write_memtable_to_sstable(memtable& mt,
+        sstables::shared_sstable sst,
+        sstables::write_monitor& mon,
+        const dht::partition_range& range,
+        uint64_t estimated_partitions,
+        utils::UUID run_id,
+        bool backup,
+        const io_priority_class& pc);
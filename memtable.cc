@@ -554,9 +554,9 @@ class flush_reader final : public flat_mutation_reader::impl, private iterator_r
     flat_mutation_reader_opt _partition_reader;
     flush_memory_accounter _flushed_memory;
 public:
-    flush_reader(schema_ptr s, lw_shared_ptr<memtable> m)
+    flush_reader(schema_ptr s, lw_shared_ptr<memtable> m, const dht::partition_range& range)
         : impl(s)
-        , iterator_reader(std::move(s), m, query::full_partition_range)
+        , iterator_reader(std::move(s), m, range)
         , _flushed_memory(*m)
     {}
     flush_reader(const flush_reader&) = delete;
@@ -676,16 +676,60 @@ memtable::make_flat_reader(schema_ptr s,
 }
 
 flat_mutation_reader
-memtable::make_flush_reader(schema_ptr s, const io_priority_class& pc) {
+memtable::make_flush_reader(schema_ptr s, const io_priority_class& pc, const dht::partition_range& range) {
     if (group()) {
-        return make_flat_mutation_reader<flush_reader>(s, shared_from_this());
+        return make_flat_mutation_reader<flush_reader>(s, shared_from_this(), range);
     } else {
         auto& full_slice = s->full_slice();
         return make_flat_mutation_reader<scanning_reader>(std::move(s), shared_from_this(),
-            query::full_partition_range, full_slice, pc, mutation_reader::forwarding::no);
+            range, full_slice, pc, mutation_reader::forwarding::no);
     }
 }
 
+dht::partition_range_vector
+memtable::split_for_flush(unsigned n) {
+    std::vector<dht::token> bounds;
+    {
+        logalloc::reclaim_lock rl(*this);
+        if (n < 2 || partitions.size() < n) {
+            return {query::full_partition_range};
+        }
+        bounds.push_back(partitions.begin()->key().token());
+        bounds.push_back(std::prev(partitions.end())->key().token());
+    }
+    // Bisect the span until there are n pieces, or the pieces can't be split further.
+    auto& partitioner = dht::global_partitioner();
+    while ((bounds.size() - 1) * 2 <= n) {
+        std::vector<dht::token> split;
+        split.reserve(bounds.size() * 2 - 1);
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            split.push_back(bounds[i]);
+            auto mid = partitioner.midpoint(bounds[i], bounds[i + 1]);
+            if (bounds[i] < mid && mid < bounds[i + 1]) {
+                split.push_back(std::move(mid));
+            }
+        }
+        split.push_back(bounds.back());
+        if (split.size() == bounds.size()) {
+            break;
+        }
+        bounds = std::move(split);
+    }
+
+    // The first and last bounds belong to partitions, so only the ones in
+    // between separate ranges; the outermost ranges are left unbounded.
+    dht::partition_range_vector ranges;
+    ranges.reserve(bounds.size() - 1);
+    std::optional<dht::partition_range::bound> start;
+    for (size_t i = 1; i + 1 < bounds.size(); ++i) {
+        dht::partition_range::bound end(dht::ring_position::starting_at(bounds[i]), false);
+        ranges.emplace_back(std::move(start), end);
+        start = dht::partition_range::bound(end.value(), true);
+    }
+    ranges.emplace_back(std::move(start), std::nullopt);
+    return ranges;
+}
+
 void
 memtable::update(db::rp_handle&& h) {
     db::replay_position rp = h;
@@ -261,7 +261,15 @@ class memtable final : public enable_lw_shared_from_this<memtable>, private loga
         return make_flat_reader(s, range, full_slice);
     }
 
-    flat_mutation_reader make_flush_reader(schema_ptr, const io_priority_class& pc);
+    // The range, if given, must be kept alive by the caller for as long as the reader is used.
+    flat_mutation_reader make_flush_reader(schema_ptr, const io_priority_class& pc,
+                                           const dht::partition_range& range = query::full_partition_range);
+
+    // Splits the token span of the memtable into at most n partition ranges,
+    // which together cover the whole ring and, tokens being uniformly
+    // distributed, hold roughly the same number of partitions. Lets a large
+    // memtable be flushed into several sstables written in parallel.
+    dht::partition_range_vector split_for_flush(unsigned n);
 
     mutation_source as_data_source();
 
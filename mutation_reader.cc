@@ -687,8 +687,8 @@ class restricting_mutation_reader : public flat_mutation_reader::impl {
         flat_mutation_reader reader;
     };
     std::variant<pending_state, admitted_state> _state;
-
-    static const ssize_t new_reader_base_cost{16 * 1024};
+    reader_concurrency_semaphore::admission_cost _cost;
+    utils::estimated_histogram* _admission_wait;
 
     template<typename Function>
     GCC6_CONCEPT(
@@ -702,8 +702,11 @@ class restricting_mutation_reader : public flat_mutation_reader::impl {
             return fn(state->reader);
         }
 
-        return std::get<pending_state>(_state).semaphore.wait_admission(new_reader_base_cost,
-                timeout).then([this, fn = std::move(fn)] (lw_shared_ptr<reader_concurrency_semaphore::reader_permit> permit) mutable {
+        return std::get<pending_state>(_state).semaphore.wait_admission(_cost,
+                timeout).then([this, fn = std::move(fn), wait_start = std::chrono::steady_clock::now()] (lw_shared_ptr<reader_concurrency_semaphore::reader_permit> permit) mutable {
+            if (_admission_wait) {
+                _admission_wait->add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wait_start).count());
+            }
             auto reader_factory = std::move(std::get<pending_state>(_state).reader_factory);
             _state.emplace<admitted_state>(admitted_state{permit, reader_factory(reader_resource_tracker(permit))});
             return fn(std::get<admitted_state>(_state).reader);
@@ -718,10 +721,14 @@ class restricting_mutation_reader : public flat_mutation_reader::impl {
             const io_priority_class& pc,
             tracing::trace_state_ptr trace_state,
             streamed_mutation::forwarding fwd,
-            mutation_reader::forwarding fwd_mr)
+            mutation_reader::forwarding fwd_mr,
+            reader_concurrency_semaphore::admission_cost cost,
+            utils::estimated_histogram* admission_wait)
         : impl(s)
         , _state(pending_state{semaphore,
-                mutation_source_and_params{std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr}}) {
+                mutation_source_and_params{std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr}})
+        , _cost(cost)
+        , _admission_wait(admission_wait) {
     }
 
     virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
@@ -773,8 +780,10 @@ make_restricted_flat_reader(reader_concurrency_semaphore& semaphore,
                        const io_priority_class& pc,
                        tracing::trace_state_ptr trace_state,
                        streamed_mutation::forwarding fwd,
-                       mutation_reader::forwarding fwd_mr) {
-    return make_flat_mutation_reader<restricting_mutation_reader>(semaphore, std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr);
+                       mutation_reader::forwarding fwd_mr,
+                       reader_concurrency_semaphore::admission_cost cost,
+                       utils::estimated_histogram* admission_wait) {
+    return make_flat_mutation_reader<restricting_mutation_reader>(semaphore, std::move(ms), std::move(s), range, slice, pc, std::move(trace_state), fwd, fwd_mr, cost, admission_wait);
 }
 
 
@@ -1665,6 +1674,9 @@ class inactive_shard_read : public reader_concurrency_semaphore::inactive_read {
     virtual void evict() override {
         _reader = {};
     }
+    virtual size_t memory_usage() const override {
+        return _reader ? _reader->buffer_size() : 0;
+    }
 };
 
 }
@@ -31,6 +31,7 @@
 #include "tracing/trace_state.hh"
 #include "flat_mutation_reader.hh"
 #include "reader_concurrency_semaphore.hh"
+#include "utils/estimated_histogram.hh"
 
 namespace mutation_reader {
     // mutation_reader::forwarding determines whether fast_forward_to() may
@@ -331,6 +332,9 @@ snapshot_source make_empty_snapshot_source();
 // a semaphore to track and limit the memory usage of readers. It also
 // contains a timeout and a maximum queue size for inactive readers
 // whose construction is blocked.
+// The reader is admitted according to `cost`, see reader_concurrency_semaphore.
+// If `admission_wait` is not null, the time the reader waited for the admission
+// is added to it, in microseconds. It has to outlive the reader.
 flat_mutation_reader make_restricted_flat_reader(reader_concurrency_semaphore& semaphore,
         mutation_source ms,
         schema_ptr s,
@@ -339,7 +343,9 @@ flat_mutation_reader make_restricted_flat_reader(reader_concurrency_semaphore& s
         const io_priority_class& pc = default_priority_class(),
         tracing::trace_state_ptr trace_state = nullptr,
         streamed_mutation::forwarding fwd = streamed_mutation::forwarding::no,
-        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes);
+        mutation_reader::forwarding fwd_mr = mutation_reader::forwarding::yes,
+        reader_concurrency_semaphore::admission_cost cost = {},
+        utils::estimated_histogram* admission_wait = nullptr);
 
 inline flat_mutation_reader make_restricted_flat_reader(reader_concurrency_semaphore& semaphore,
                                               mutation_source ms,
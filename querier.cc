@@ -241,6 +241,9 @@ class querier_inactive_read : public reader_concurrency_semaphore::inactive_read
         ++_stats.resource_based_evictions;
         --_stats.population;
     }
+    virtual size_t memory_usage() const override {
+        return _pos->memory_usage();
+    }
 };
 
 template <typename Querier>
@@ -24,20 +24,58 @@
 
 #include "reader_concurrency_semaphore.hh"
 
-void reader_concurrency_semaphore::signal(const resources& r) {
-    _resources += r;
-    while (!_wait_list.empty() && has_available_units(_wait_list.front().res)) {
-        auto& x = _wait_list.front();
+void reader_concurrency_semaphore::on_admitted(read_class cls, wait_clock::duration waited) {
+    auto waited_us = std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+    if (cls == read_class::short_read) {
+        _admission_stats.short_read_wait.add(waited_us);
+        // Also forgets about long reads that timed out while waiting.
+        _long_read_bypassed = _long_wait_list.empty() ? 0 : _long_read_bypassed + 1;
+    } else {
+        _admission_stats.long_read_wait.add(waited_us);
+        _long_read_bypassed = 0;
+    }
+}
+
+void reader_concurrency_semaphore::maybe_admit_waiters() {
+    while (auto wl = next_wait_list()) {
+        auto& x = wl->front();
+        if (!has_available_units(x.res)) {
+            // Inactive reads are only evicted for the waiter that is
+            // admitted next, as long as it doesn't fit. The released
+            // resources get here again through signal().
+            if (_inactive_reads.empty()) {
+                return;
+            }
+            evict(pick_inactive_read_to_evict(x.res));
+            continue;
+        }
+        auto cls = wl == &_short_wait_list ? read_class::short_read : read_class::long_read;
+        if (long_read_starved()) {
+            ++_admission_stats.long_read_promotions;
+        }
         _resources -= x.res;
+        on_admitted(cls, wait_clock::now() - x.enqueued);
         x.pr.set_value(make_lw_shared<reader_permit>(*this, x.res));
-        _wait_list.pop_front();
+        wl->pop_front();
     }
 }
 
+void reader_concurrency_semaphore::signal(const resources& r) {
+    _resources += r;
+    maybe_admit_waiters();
+}
+
+void reader_concurrency_semaphore::set_total_resources(resources r) {
+    auto delta = r;
+    delta -= _total_resources;
+    _total_resources = r;
+    signal(delta);
+}
+
 reader_concurrency_semaphore::inactive_read_handle reader_concurrency_semaphore::register_inactive_read(std::unique_ptr<inactive_read> ir) {
-    // Implies _inactive_reads.empty(), we don't queue new readers before
-    // evicting all inactive reads.
-    if (_wait_list.empty()) {
+    // Queued readers don't fit, otherwise they would have been admitted, so
+    // a new inactive read would be evicted for them right away.
+    if (_short_wait_list.empty() && _long_wait_list.empty()) {
         const auto [it, _] = _inactive_reads.emplace(_next_id++, std::move(ir));
         (void)_;
         ++_inactive_read_stats.population;
@@ -65,19 +103,43 @@ bool reader_concurrency_semaphore::try_evict_one_inactive_read() {
     if (_inactive_reads.empty()) {
         return false;
     }
-    auto it = _inactive_reads.begin();
-    it->second->evict();
-    _inactive_reads.erase(it);
+    evict(_inactive_reads.begin());
+    return true;
+}
 
+void reader_concurrency_semaphore::evict(std::map<uint64_t, std::unique_ptr<inactive_read>>::iterator it) {
+    // Erase first, evicting releases the read's resources, which may get
+    // back here to evict more.
+    auto ir = std::move(it->second);
+    _inactive_reads.erase(it);
     ++_inactive_read_stats.permit_based_evictions;
     --_inactive_read_stats.population;
+    ir->evict();
+}
 
-    return true;
+std::map<uint64_t, std::unique_ptr<reader_concurrency_semaphore::inactive_read>>::iterator
+reader_concurrency_semaphore::pick_inactive_read_to_evict(const resources& r) {
+    auto it = _inactive_reads.begin();
+    if (_resources.count < r.count) {
+        // Any eviction releases a count unit, evict by age.
+        return it;
+    }
+    // Short on memory only, evict the read that releases the most of it, so
+    // that as few reads as possible are lost.
+    auto largest = it;
+    size_t largest_size = largest->second->memory_usage();
+    for (++it; it != _inactive_reads.end(); ++it) {
+        if (auto size = it->second->memory_usage(); size > largest_size) {
+            largest = it;
+            largest_size = size;
+        }
+    }
+    return largest;
 }
 
-future<lw_shared_ptr<reader_concurrency_semaphore::reader_permit>> reader_concurrency_semaphore::wait_admission(size_t memory,
+future<lw_shared_ptr<reader_concurrency_semaphore::reader_permit>> reader_concurrency_semaphore::wait_admission(admission_cost cost,
         db::timeout_clock::time_point timeout) {
-    if (_wait_list.size() >= _max_queue_length) {
+    if (waiters() >= _max_queue_length) {
         if (_prethrow_action) {
             _prethrow_action();
         }
@@ -85,23 +147,24 @@ future<lw_shared_ptr<reader_concurrency_semaphore::reader_permit>> reader_concur
                 std::make_exception_ptr(std::runtime_error(
                         format("{}: restricted mutation reader queue overload", _name))));
     }
-    auto r = resources(1, static_cast<ssize_t>(memory));
-    auto it = _inactive_reads.begin();
-    while (!may_proceed(r) && it != _inactive_reads.end()) {
-        auto ir = std::move(it->second);
-        it = _inactive_reads.erase(it);
-        ir->evict();
-
-        ++_inactive_read_stats.permit_based_evictions;
-        --_inactive_read_stats.population;
+    auto r = resources(1, cost.memory);
+    // When other reads are admitted first, this one just queues up: inactive
+    // reads are evicted for the waiters ahead of it, by maybe_admit_waiters(),
+    // and only as long as the next of them doesn't fit.
+    if (goes_first(cost.cls)) {
+        while (!has_available_units(r) && !_inactive_reads.empty()) {
+            evict(pick_inactive_read_to_evict(r));
+        }
     }
-    if (may_proceed(r)) {
+    if (goes_first(cost.cls) && has_available_units(r)) {
         _resources -= r;
+        on_admitted(cost.cls, wait_clock::duration::zero());
         return make_ready_future<lw_shared_ptr<reader_permit>>(make_lw_shared<reader_permit>(*this, r));
     }
     promise<lw_shared_ptr<reader_permit>> pr;
     auto fut = pr.get_future();
-    _wait_list.push_back(entry(std::move(pr), r), timeout);
+    auto& wl = cost.cls == read_class::short_read ? _short_wait_list : _long_wait_list;
+    wl.push_back(entry(std::move(pr), r), timeout);
     return fut;
 }
 
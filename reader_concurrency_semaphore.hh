@@ -25,6 +25,7 @@
 #include <seastar/core/file.hh>
 #include <seastar/core/future.hh>
 #include "db/timeout_clock.hh"
+#include "utils/estimated_histogram.hh"
 #include "seastarx.hh"
 
 /// Specific semaphore for controlling reader concurrency
@@ -37,8 +38,14 @@
 /// Reader concurrency is dual limited by count and memory.
 /// The semaphore can be configured with the desired limits on
 /// construction. New readers will only be admitted when there is both
-/// enough count and memory units available. Readers are admitted in
-/// FIFO order.
+/// enough count and memory units available.
+/// Readers are admitted according to their estimated cost (see
+/// `admission_cost`). Short reads and long reads wait in separate FIFO
+/// queues, short reads being admitted first, so that a long read that
+/// doesn't fit yet doesn't hold up the cheap reads queued behind it. To
+/// keep long reads from starving, a long read can be bypassed by at most
+/// `max_long_read_bypass` short reads, after which it is admitted before
+/// any further short read.
 /// Semaphore's `name` must be provided in ctor and its only purpose is
 /// to increase readability of exceptions: both timeout exceptions and
 /// queue overflow exceptions (read below) include this `name` in messages.
@@ -83,6 +90,27 @@ class reader_concurrency_semaphore {
         }
     };
 
+    /// The base memory cost of a reader, covering its initial buffers.
+    static constexpr ssize_t new_reader_base_cost = 16 * 1024;
+
+    /// A short read is expected to finish quickly and cheaply (a single
+    /// partition with a narrow slice); a long read is anything that can
+    /// keep its permit for a long time (range scans, full partitions).
+    enum class read_class {
+        short_read,
+        long_read,
+    };
+
+    /// The estimated cost of admitting a reader.
+    struct admission_cost {
+        ssize_t memory = new_reader_base_cost;
+        read_class cls = read_class::short_read;
+    };
+
+    /// Short reads admitted ahead of a queued long read before the long
+    /// read is given precedence.
+    static constexpr unsigned max_long_read_bypass = 64;
+
     class reader_permit {
         reader_concurrency_semaphore& _semaphore;
         const resources _base_cost;
@@ -114,6 +142,10 @@ class reader_concurrency_semaphore {
     class inactive_read {
     public:
         virtual void evict() = 0;
+        /// The memory that evicting this read is expected to release.
+        virtual size_t memory_usage() const {
+            return 0;
+        }
         virtual ~inactive_read() = default;
     };
 
@@ -145,11 +177,25 @@ class reader_concurrency_semaphore {
         uint64_t population = 0;
     };
 
+    struct admission_stats {
+        // Time spent waiting for admission, in microseconds. Reads admitted
+        // without waiting are accounted as zero.
+        utils::estimated_histogram short_read_wait;
+        utils::estimated_histogram long_read_wait;
+        // The number of times a starving long read was given precedence
+        // over queued short reads.
+        uint64_t long_read_promotions = 0;
+    };
+
 private:
+    using wait_clock = utils::estimated_histogram::clock;
+
     struct entry {
         promise<lw_shared_ptr<reader_permit>> pr;
         resources res;
-        entry(promise<lw_shared_ptr<reader_permit>>&& pr, resources r) : pr(std::move(pr)), res(r) {}
+        wait_clock::time_point enqueued;
+        entry(promise<lw_shared_ptr<reader_permit>>&& pr, resources r)
+            : pr(std::move(pr)), res(r), enqueued(wait_clock::now()) {}
     };
 
     class expiry_handler {
@@ -164,8 +210,16 @@ class reader_concurrency_semaphore {
 
 private:
     resources _resources;
+    // What _resources is when no read is admitted, see set_total_resources().
+    resources _total_resources;
 
-    expiring_fifo<entry, expiry_handler, db::timeout_clock> _wait_list;
+    using wait_list = expiring_fifo<entry, expiry_handler, db::timeout_clock>;
+
+    wait_list _short_wait_list;
+    wait_list _long_wait_list;
+    // Short reads admitted while the long read at the front of
+    // _long_wait_list was waiting.
+    unsigned _long_read_bypassed = 0;
 
     sstring _name;
     size_t _max_queue_length = std::numeric_limits<size_t>::max();
@@ -173,16 +227,47 @@ class reader_concurrency_semaphore {
     uint64_t _next_id = 1;
     std::map<uint64_t, std::unique_ptr<inactive_read>> _inactive_reads;
     inactive_read_stats _inactive_read_stats;
+    admission_stats _admission_stats;
 
 private:
     bool has_available_units(const resources& r) const {
         return bool(_resources) && _resources >= r;
     }
 
-    bool may_proceed(const resources& r) const {
-        return has_available_units(r) && _wait_list.empty();
+    bool long_read_starved() const {
+        return !_long_wait_list.empty() && _long_read_bypassed >= max_long_read_bypass;
+    }
+
+    // Whether a new read of class `cls` is admitted ahead of all waiters.
+    bool goes_first(read_class cls) const {
+        if (!_short_wait_list.empty()) {
+            return false;
+        }
+        return cls == read_class::short_read ? !long_read_starved() : _long_wait_list.empty();
+    }
+
+    // The queue whose front waiter is admitted next, nullptr if none.
+    wait_list* next_wait_list() {
+        if (long_read_starved()) {
+            return &_long_wait_list;
+        }
+        if (!_short_wait_list.empty()) {
+            return &_short_wait_list;
+        }
+        return _long_wait_list.empty() ? nullptr : &_long_wait_list;
     }
 
+    void on_admitted(read_class cls, wait_clock::duration waited);
+
+    void maybe_admit_waiters();
+
+    // Picks the inactive read to evict to make room for `r`: the oldest one
+    // when short on count, the largest one (oldest among equals) when only
+    // short on memory.
+    std::map<uint64_t, std::unique_ptr<inactive_read>>::iterator pick_inactive_read_to_evict(const resources& r);
+
+    void evict(std::map<uint64_t, std::unique_ptr<inactive_read>>::iterator it);
+
     void consume_memory(size_t memory) {
         _resources.memory -= memory;
     }
@@ -201,7 +286,9 @@ class reader_concurrency_semaphore {
             size_t max_queue_length = std::numeric_limits<size_t>::max(),
             std::function<void()> prethrow_action = nullptr)
         : _resources(count, memory)
-        , _wait_list(expiry_handler(name))
+        , _total_resources(count, memory)
+        , _short_wait_list(expiry_handler(name))
+        , _long_wait_list(expiry_handler(name))
         , _name(std::move(name))
         , _max_queue_length(max_queue_length)
         , _prethrow_action(std::move(prethrow_action)) {}
@@ -254,7 +341,15 @@ class reader_concurrency_semaphore {
         return _inactive_read_stats;
     }
 
-    future<lw_shared_ptr<reader_permit>> wait_admission(size_t memory, db::timeout_clock::time_point timeout = db::no_timeout);
+    const admission_stats& get_admission_stats() const {
+        return _admission_stats;
+    }
+
+    future<lw_shared_ptr<reader_permit>> wait_admission(size_t memory, db::timeout_clock::time_point timeout = db::no_timeout) {
+        return wait_admission(admission_cost{static_cast<ssize_t>(memory), read_class::short_read}, timeout);
+    }
+
+    future<lw_shared_ptr<reader_permit>> wait_admission(admission_cost cost, db::timeout_clock::time_point timeout = db::no_timeout);
 
     /// Consume the specific amount of resources without waiting.
     lw_shared_ptr<reader_permit> consume_resources(resources r);
@@ -263,8 +358,22 @@ class reader_concurrency_semaphore {
         return _resources;
     }
 
+    const resources total_resources() const {
+        return _total_resources;
+    }
+
+    /// Change the resources reads are admitted against.
+    ///
+    /// Shrinking doesn't affect reads that were already admitted, it only
+    /// holds back further admissions until enough of them finish.
+    void set_total_resources(resources r);
+
     size_t waiters() const {
-        return _wait_list.size();
+        return _short_wait_list.size() + _long_wait_list.size();
+    }
+
+    size_t waiters(read_class cls) const {
+        return cls == read_class::short_read ? _short_wait_list.size() : _long_wait_list.size();
     }
 };
 
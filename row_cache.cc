@@ -744,6 +744,7 @@ row_cache::make_reader(schema_ptr s,
     auto ctx = make_lw_shared<read_context>(*this, s, range, slice, pc, trace_state, fwd_mr);
 
     if (!ctx->is_range_query() && !fwd_mr) {
+        sample_key(ctx->range().start()->value());
         auto mr = _read_section(_tracker.region(), [&] {
             return with_linearized_managed_bytes([&] {
                 cache_entry::compare cmp(_schema);
@@ -779,6 +780,54 @@ row_cache::make_reader(schema_ptr s,
 }
 
 
+void row_cache::sample_key(const dht::ring_position& pos) {
+    if (++_reads_since_key_sample < key_sample_period || !pos.has_key()) {
+        return;
+    }
+    _reads_since_key_sample = 0;
+    if (_sampled_keys.size() < max_sampled_keys) {
+        _sampled_keys.push_back(pos.as_decorated_key());
+    } else {
+        _sampled_keys[_next_sampled_key] = pos.as_decorated_key();
+        _next_sampled_key = (_next_sampled_key + 1) % max_sampled_keys;
+    }
+}
+
+std::vector<dht::decorated_key> row_cache::hot_keys(size_t max_keys) const {
+    std::vector<const dht::decorated_key*> sorted;
+    sorted.reserve(_sampled_keys.size());
+    for (auto& key : _sampled_keys) {
+        sorted.push_back(&key);
+    }
+    dht::decorated_key::less_comparator less(_schema);
+    std::sort(sorted.begin(), sorted.end(), [&less] (const dht::decorated_key* a, const dht::decorated_key* b) {
+        return less(*a, *b);
+    });
+
+    // Frequent keys show up in the sample many times.
+    std::vector<std::pair<const dht::decorated_key*, size_t>> counts;
+    for (auto* key : sorted) {
+        if (!counts.empty() && counts.back().first->equal(*_schema, *key)) {
+            ++counts.back().second;
+        } else {
+            counts.emplace_back(key, 1);
+        }
+    }
+    std::stable_sort(counts.begin(), counts.end(), [] (const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+    if (max_keys && counts.size() > max_keys) {
+        counts.resize(max_keys);
+    }
+
+    std::vector<dht::decorated_key> ret;
+    ret.reserve(counts.size());
+    for (auto& c : counts) {
+        ret.push_back(*c.first);
+    }
+    return ret;
+}
+
 row_cache::~row_cache() {
     with_allocator(_tracker.allocator(), [this] {
         _partitions.clear_and_dispose([this, deleter = current_deleter<cache_entry>()] (auto&& p) mutable {
@@ -940,6 +989,7 @@ future<> row_cache::do_update(external_updater eu, memtable& m, Updater updater)
         });
         coroutine update; // Destroy before cleanup to release snapshots before invalidating.
         partition_presence_checker is_present = _prev_snapshot->make_partition_presence_checker();
+        update_lookup_hint hint;
         while (!m.partitions.empty()) {
             with_allocator(_tracker.allocator(), [&] () {
                 auto cmp = cache_entry::compare(_schema);
@@ -957,7 +1007,12 @@ future<> row_cache::do_update(external_updater eu, memtable& m, Updater updater)
                                 _update_section(_tracker.region(), [&] {
                                     memtable_entry& mem_e = *m.partitions.begin();
                                     size_entry = mem_e.size_in_allocator_without_rows(_tracker.allocator());
-                                    auto cache_i = _partitions.lower_bound(mem_e.key(), cmp);
+                                    auto hinted = hint.lower_bound(partitions_end(), _tracker.region(), mem_e.key(), cmp);
+                                    auto cache_i = hinted ? *hinted : _partitions.lower_bound(mem_e.key(), cmp);
+                                    // The updater may evict an entry with the same key, but not the ones after it.
+                                    // Taken before the updater runs, so that a reclaim it causes invalidates the hint.
+                                    hint.set(cache_i != partitions_end() && cache_i->key().equal(*_schema, mem_e.key())
+                                            ? std::next(cache_i) : cache_i, _tracker.region());
                                     update = updater(_update_section, cache_i, mem_e, is_present, real_dirty_acc);
                                 });
                             }
@@ -980,6 +1035,7 @@ future<> row_cache::do_update(external_updater eu, memtable& m, Updater updater)
                           });
                           STAP_PROBE(scylla, row_cache_update_partition_end);
                         } while (!m.partitions.empty() && !need_preempt());
+                        hint.invalidate();
                         with_allocator(standard_allocator(), [&] {
                             if (m.partitions.empty()) {
                                 _prev_snapshot_pos = {};
@@ -388,6 +388,15 @@ class row_cache final {
     logalloc::allocating_section _update_section;
     logalloc::allocating_section _populate_section;
     logalloc::allocating_section _read_section;
+
+    // Ring buffer with the keys of every key_sample_period-th single-partition
+    // read, from which hot_keys() are picked. Lives in the standard allocator.
+    static constexpr unsigned key_sample_period = 16;
+    std::vector<dht::decorated_key> _sampled_keys;
+    size_t _next_sampled_key = 0;
+    unsigned _reads_since_key_sample = 0;
+    void sample_key(const dht::ring_position&);
+
     flat_mutation_reader create_underlying_reader(cache::read_context&, mutation_source&, const dht::partition_range&);
     flat_mutation_reader make_scanning_reader(const dht::partition_range&, lw_shared_ptr<cache::read_context>);
     void on_partition_hit();
@@ -454,6 +463,47 @@ class row_cache final {
     //
     snapshot_and_phase snapshot_of(dht::ring_position_view pos);
 
+    // How far do_update() walks the cache forward from the previous partition's position
+    // before falling back to a lookup from the root.
+    static constexpr unsigned max_update_lookup_steps = 16;
+
+    // The position in _partitions past the previous memtable partition merged by
+    // do_update(). Memtable partitions are visited in ring order, so the next one
+    // is usually at most a few entries further. The position is usable only as
+    // long as the region wasn't compacted or evicted from, and only within a
+    // batch, since cache readers may modify the tree when the update yields.
+    class update_lookup_hint {
+        partitions_type::iterator _pos;
+        std::optional<uint64_t> _reclaim_counter;
+    public:
+        void set(partitions_type::iterator pos, const logalloc::region& r) {
+            _pos = pos;
+            _reclaim_counter = r.reclaim_counter();
+        }
+        void invalidate() {
+            _reclaim_counter = {};
+        }
+        bool usable(const logalloc::region& r) const {
+            return _reclaim_counter == r.reclaim_counter();
+        }
+        // Walks forward from the hint to the lower bound of key. Returns a disengaged
+        // optional if the hint is not usable, or the key is too far away.
+        std::optional<partitions_type::iterator> lower_bound(partitions_type::iterator end, const logalloc::region& r,
+                const dht::decorated_key& key, const cache_entry::compare& cmp) const {
+            if (!usable(r)) {
+                return {};
+            }
+            auto i = _pos;
+            for (unsigned steps = 0; steps < max_update_lookup_steps; ++steps) {
+                if (i == end || !cmp(*i, key)) {
+                    return i;
+                }
+                ++i;
+            }
+            return {};
+        }
+    };
+
     // Merges the memtable into cache with configurable logic for handling memtable entries.
     // The Updater gets invoked for every entry in the memtable with a lower bound iterator
     // into _partitions (cache_i), and the memtable entry.
@@ -504,6 +554,14 @@ class row_cache final {
     }
 
     const stats& stats() const { return _stats; }
+
+    static constexpr size_t max_sampled_keys = 4096;
+    // Returns the keys which single-partition reads asked for most often
+    // recently, most frequent first, at most max_keys of them unless it is 0,
+    // and never more than max_sampled_keys.
+    // The keys are picked from a sample of the reads, so rarely read
+    // partitions are unlikely to be included.
+    std::vector<dht::decorated_key> hot_keys(size_t max_keys = 0) const;
 public:
     // Populate cache from given mutation, which must be fully continuous.
     // Intended to be used only in tests.
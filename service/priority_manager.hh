@@ -23,6 +23,10 @@
 #include <seastar/core/future.hh>
 #include <seastar/core/distributed.hh>
 #include <seastar/core/reactor.hh>
+#include <seastar/core/scheduling.hh>
+
+#include <array>
+#include <optional>
 
 #include "seastarx.hh"
 
@@ -34,6 +38,10 @@ class priority_manager {
     ::io_priority_class _stream_write_priority;
     ::io_priority_class _sstable_query_read;
     ::io_priority_class _compaction_priority;
+    // Statements of a service level run in its scheduling group and read with its
+    // own priority class, see qos::service_level_controller.
+    // Indexed by scheduling group, as it is looked up for every sstable read.
+    std::array<std::optional<::io_priority_class>, max_scheduling_groups()> _query_read_priority_by_group;
 
 public:
     const ::io_priority_class&
@@ -58,7 +66,12 @@ class priority_manager {
 
     const ::io_priority_class&
     sstable_query_read_priority() const {
-        return _sstable_query_read;
+        auto& pc = _query_read_priority_by_group[internal::scheduling_group_index(current_scheduling_group())];
+        return pc ? *pc : _sstable_query_read;
+    }
+
+    void set_query_read_priority(scheduling_group sg, const ::io_priority_class& pc) {
+        _query_read_priority_by_group[internal::scheduling_group_index(sg)] = pc;
     }
 
     const ::io_priority_class&
@@ -66,6 +79,16 @@ class priority_manager {
         return _compaction_priority;
     }
 
+    // Whether the class is used for background work, rather than for
+    // serving user requests.
+    bool is_maintenance_priority(const ::io_priority_class& pc) const {
+        return pc.id() == _compaction_priority.id()
+                || pc.id() == _stream_read_priority.id()
+                || pc.id() == _stream_write_priority.id()
+                || pc.id() == _mt_flush_priority.id()
+                || pc.id() == _commitlog_priority.id();
+    }
+
     priority_manager()
         : _commitlog_priority(engine().register_one_priority_class("commitlog", 1000))
         , _mt_flush_priority(engine().register_one_priority_class("memtable_flush", 1000))
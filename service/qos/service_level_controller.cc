@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "service/qos/service_level_controller.hh"
+#include "service/priority_manager.hh"
+#include "db/system_distributed_keyspace.hh"
+#include "database.hh"
+#include "log.hh"
+
+#include <algorithm>
+
+namespace qos {
+
+static logging::logger sl_logger("service_level_controller");
+
+distributed<service_level_controller> _the_service_level_controller;
+
+constexpr std::chrono::seconds service_level_controller::update_interval;
+constexpr int32_t service_level_controller::default_shares;
+
+service_level_controller::service_level_controller(distributed<database>& db, scheduling_group default_scheduling_group)
+        : _db(db)
+        , _default_scheduling_group(default_scheduling_group) {
+}
+
+future<> service_level_controller::start(db::system_distributed_keyspace& sys_dist_ks) {
+    if (engine().cpu_id() != 0) {
+        return make_ready_future<>();
+    }
+    _sys_dist_ks = &sys_dist_ks;
+    _update_timer.set_callback([this] {
+        (void)with_gate(_update_gate, [this] {
+            // The tables are created by the storage service when the node
+            // joins the cluster, which may be after we are started.
+            auto& db = _db.local();
+            if (!db.has_schema(db::system_distributed_keyspace::NAME, db::system_distributed_keyspace::SERVICE_LEVELS)
+                    || !db.has_schema(db::system_distributed_keyspace::NAME, db::system_distributed_keyspace::ROLE_SERVICE_LEVELS)) {
+                sl_logger.debug("Service level tables don't exist yet, not updating service levels");
+                _update_timer.arm(update_interval);
+                return make_ready_future<>();
+            }
+            return update_from_distributed_data().handle_exception([] (std::exception_ptr ep) {
+                sl_logger.warn("Failed to update service levels: {}", ep);
+            }).finally([this] {
+                if (!_update_gate.is_closed()) {
+                    _update_timer.arm(update_interval);
+                }
+            });
+        });
+    });
+    _update_timer.arm(lowres_clock::now());
+    return make_ready_future<>();
+}
+
+future<> service_level_controller::stop() {
+    _update_timer.cancel();
+    return _update_gate.close();
+}
+
+future<> service_level_controller::update_from_distributed_data() {
+    return _sys_dist_ks->service_levels().then([this] (std::unordered_map<sstring, std::optional<int32_t>> levels) {
+        return do_with(std::move(levels), [this] (std::unordered_map<sstring, std::optional<int32_t>>& levels) {
+            return do_for_each(levels, [this] (auto& level) {
+                service_level_options slo;
+                if (level.second) {
+                    slo.shares = *level.second;
+                }
+                return add_service_level(level.first, slo);
+            }).then([this, &levels] {
+                std::vector<sstring> dropped;
+                for (auto& [name, sl] : _service_levels) {
+                    if (!sl.dropped && !levels.count(name)) {
+                        dropped.push_back(name);
+                    }
+                }
+                return do_with(std::move(dropped), [this] (std::vector<sstring>& dropped) {
+                    return do_for_each(dropped, [this] (const sstring& name) {
+                        return drop_service_level(name);
+                    });
+                });
+            });
+        });
+    }).then([this] {
+        return _sys_dist_ks->role_service_levels();
+    }).then([this] (std::unordered_map<sstring, sstring> role_service_levels) {
+        return set_role_service_levels(std::move(role_service_levels));
+    });
+}
+
+future<> service_level_controller::add_service_level(sstring name, service_level_options slo) {
+    assert(engine().cpu_id() == 0);
+    if (slo.shares <= 0) {
+        sl_logger.warn("Ignoring service level {}: shares must be positive, got {}", name, slo.shares);
+        return make_ready_future<>();
+    }
+    auto it = _service_levels.find(name);
+    if (it != _service_levels.end()) {
+        if (!it->second.dropped && it->second.options == slo) {
+            return make_ready_future<>();
+        }
+        // Only the CPU shares can be changed at runtime, the I/O shares
+        // are fixed when the priority class is registered.
+        sl_logger.info("Updating service level {}: shares={}", name, slo.shares);
+        return container().invoke_on_all([name, slo] (service_level_controller& slc) {
+            auto& sl = slc._service_levels.at(name);
+            if (sl.dropped) {
+                slc._db.local().register_service_level_read_metrics(sl.pc, name);
+            }
+            sl.options = slo;
+            sl.dropped = false;
+            sl.sg.set_shares(slo.shares);
+            slc.update_read_shares();
+        });
+    }
+    auto active = std::count_if(_service_levels.begin(), _service_levels.end(), [] (auto& sl) { return !sl.second.dropped; });
+    if (size_t(active) >= max_service_levels) {
+        sl_logger.warn("Ignoring service level {}: at most {} service levels are supported", name, max_service_levels);
+        return make_ready_future<>();
+    }
+    if (_service_levels.size() >= max_service_levels) {
+        // All scheduling groups are taken, but some belong to dropped
+        // service levels, so hand one of those over.
+        auto dropped = std::find_if(_service_levels.begin(), _service_levels.end(), [] (auto& sl) { return sl.second.dropped; });
+        sl_logger.info("Creating service level {} in place of dropped service level {}: shares={}", name, dropped->first, slo.shares);
+        return container().invoke_on_all([old_name = dropped->first, name, slo] (service_level_controller& slc) {
+            slc.do_replace_service_level(old_name, name, slo);
+        });
+    }
+    // The group, class and read queue are named after their slot rather than
+    // after the service level, as they are handed over when it is dropped.
+    auto group_name = format("sl_{}", _service_levels.size());
+    sl_logger.info("Creating service level {} in group {}: shares={}", name, group_name, slo.shares);
+    return create_scheduling_group(group_name, slo.shares).then([this, name, group_name, slo] (scheduling_group sg) {
+        return container().invoke_on_all([name, group_name, slo, sg] (service_level_controller& slc) {
+            slc.do_add_service_level(name, group_name, slo, sg);
+        });
+    });
+}
+
+void service_level_controller::do_add_service_level(const sstring& name, const sstring& group_name, service_level_options slo, scheduling_group sg) {
+    // Registering the same name on every shard yields the same class.
+    auto pc = engine().register_one_priority_class(group_name, slo.shares);
+    _db.local().add_service_level_read_concurrency_semaphore(pc, group_name);
+    _db.local().register_service_level_read_metrics(pc, name);
+    service::get_local_priority_manager().set_query_read_priority(sg, pc);
+    _service_levels.emplace(name, service_level{slo, sg, pc});
+    update_read_shares();
+}
+
+void service_level_controller::do_replace_service_level(const sstring& old_name, const sstring& name, service_level_options slo) {
+    auto nh = _service_levels.extract(old_name);
+    nh.key() = name;
+    auto& sl = nh.mapped();
+    sl.options = slo;
+    sl.dropped = false;
+    sl.sg.set_shares(slo.shares);
+    _db.local().register_service_level_read_metrics(sl.pc, name);
+    _service_levels.insert(std::move(nh));
+    update_read_shares();
+}
+
+void service_level_controller::update_read_shares() {
+    std::unordered_map<unsigned, int32_t> shares_by_class;
+    for (auto& [name, sl] : _service_levels) {
+        if (!sl.dropped) {
+            shares_by_class.emplace(sl.pc.id(), sl.options.shares);
+        }
+    }
+    _db.local().set_user_read_shares(default_shares, shares_by_class);
+}
+
+future<> service_level_controller::drop_service_level(sstring name) {
+    assert(engine().cpu_id() == 0);
+    sl_logger.info("Dropping service level {}", name);
+    return container().invoke_on_all([name] (service_level_controller& slc) {
+        auto it = slc._service_levels.find(name);
+        if (it != slc._service_levels.end()) {
+            it->second.dropped = true;
+            slc._db.local().unregister_service_level_read_metrics(it->second.pc);
+            slc.update_read_shares();
+        }
+    });
+}
+
+future<> service_level_controller::set_role_service_levels(std::unordered_map<sstring, sstring> role_service_levels) {
+    assert(engine().cpu_id() == 0);
+    if (role_service_levels == _role_service_levels) {
+        return make_ready_future<>();
+    }
+    return container().invoke_on_all([role_service_levels = std::move(role_service_levels)] (service_level_controller& slc) {
+        slc._role_service_levels = role_service_levels;
+    });
+}
+
+const service_level_controller::service_level* service_level_controller::find_service_level(const sstring& name) const {
+    auto it = _service_levels.find(name);
+    if (it == _service_levels.end() || it->second.dropped) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+scheduling_group service_level_controller::get_scheduling_group(const std::optional<sstring>& role) const {
+    if (role) {
+        auto it = _role_service_levels.find(*role);
+        if (it != _role_service_levels.end()) {
+            if (auto* sl = find_service_level(it->second)) {
+                return sl->sg;
+            }
+        }
+    }
+    return _default_scheduling_group;
+}
+
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <seastar/core/distributed.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/timer.hh>
+#include <seastar/core/lowres_clock.hh>
+
+#include <optional>
+#include <unordered_map>
+
+#include "seastarx.hh"
+
+class database;
+
+namespace db {
+class system_distributed_keyspace;
+}
+
+namespace qos {
+
+struct service_level_options {
+    // CPU and I/O shares, relative to the 1000 shares of the default statement group.
+    int32_t shares = 1000;
+
+    bool operator==(const service_level_options& o) const {
+        return shares == o.shares;
+    }
+    bool operator!=(const service_level_options& o) const {
+        return !(*this == o);
+    }
+};
+
+/*
+ * Service levels isolate workloads from each other. Each service level runs
+ * its statements in its own scheduling group, issues its reads with its own
+ * io priority class and admits them through its own reader queue, so that a
+ * heavy workload can't starve the others of CPU, disk or read permits.
+ *
+ * Service levels are defined in system_distributed.service_levels and attached
+ * to roles in system_distributed.role_service_levels. Shard 0 polls both tables
+ * and propagates changes to all shards. Connections of roles without a service
+ * level use the default statement scheduling group.
+ */
+class service_level_controller : public peering_sharded_service<service_level_controller> {
+public:
+    // Seastar supports a small, fixed number of scheduling groups, and they
+    // can't be destroyed, so the number of service levels is capped.
+    static constexpr unsigned max_service_levels = 4;
+    static constexpr std::chrono::seconds update_interval{10};
+    // Shares of the default statement group, which the reads of roles
+    // without a service level compete with.
+    static constexpr int32_t default_shares = 1000;
+
+    struct service_level {
+        service_level_options options;
+        scheduling_group sg;
+        io_priority_class pc;
+        // Dropped service levels keep their scheduling group and priority
+        // class until restart, and are revived when defined again. They
+        // don't count towards max_service_levels, a new service level takes
+        // over the group and class of a dropped one when all are taken.
+        // Their read queue metrics are only exported while they are defined.
+        bool dropped = false;
+    };
+private:
+    distributed<database>& _db;
+    scheduling_group _default_scheduling_group;
+    std::unordered_map<sstring, service_level> _service_levels;
+    std::unordered_map<sstring, sstring> _role_service_levels;
+
+    // Shard 0 only.
+    db::system_distributed_keyspace* _sys_dist_ks = nullptr;
+    timer<lowres_clock> _update_timer;
+    seastar::gate _update_gate;
+public:
+    service_level_controller(distributed<database>& db, scheduling_group default_scheduling_group);
+
+    // Starts polling the service level definitions, on shard 0.
+    future<> start(db::system_distributed_keyspace& sys_dist_ks);
+    future<> stop();
+
+    // Must be called on shard 0.
+    future<> add_service_level(sstring name, service_level_options slo);
+    future<> drop_service_level(sstring name);
+    future<> set_role_service_levels(std::unordered_map<sstring, sstring> role_service_levels);
+
+    const service_level* find_service_level(const sstring& name) const;
+    // The scheduling group statements of the given role should run in.
+    scheduling_group get_scheduling_group(const std::optional<sstring>& role) const;
+private:
+    future<> update_from_distributed_data();
+    void do_add_service_level(const sstring& name, const sstring& group_name, service_level_options slo, scheduling_group sg);
+    void do_replace_service_level(const sstring& old_name, const sstring& name, service_level_options slo);
+    // Splits the user read budget of this shard between the active service levels.
+    void update_read_shares();
+};
+
+extern distributed<service_level_controller> _the_service_level_controller;
+
+inline distributed<service_level_controller>& get_service_level_controller() {
+    return _the_service_level_controller;
+}
+
+}
@@ -25,6 +25,7 @@
 
 #include "service/client_state.hh"
 #include "tracing/tracing.hh"
+#include "tracing/query_profile.hh"
 #include "service_permit.hh"
 
 namespace service {
@@ -34,6 +35,7 @@ class query_state final {
     client_state& _client_state;
     tracing::trace_state_ptr _trace_state_ptr;
     service_permit _permit;
+    tracing::query_profile _profile;
 
 public:
     query_state(client_state& client_state, service_permit permit)
@@ -75,6 +77,14 @@ class query_state final {
         return std::move(_permit);
     }
 
+    tracing::query_profile& get_query_profile() {
+        return _profile;
+    }
+
+    const tracing::query_profile& get_query_profile() const {
+        return _profile;
+    }
+
 };
 
 }
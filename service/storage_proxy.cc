@@ -1653,9 +1653,9 @@ storage_proxy::create_write_response_handler_helper(schema_ptr s, const dht::tok
     auto keyspace_name = s->ks_name();
     keyspace& ks = _db.local().find_keyspace(keyspace_name);
     auto& rs = ks.get_replication_strategy();
-    std::vector<gms::inet_address> natural_endpoints = rs.get_natural_endpoints(token);
-    std::vector<gms::inet_address> pending_endpoints =
-        get_local_storage_service().get_token_metadata().pending_endpoints_for(token, keyspace_name);
+    // Not copied: only valid until the next preemption point.
+    auto natural_endpoints = rs.get_natural_endpoints_range(token);
+    std::vector<gms::inet_address> pending_endpoints = rs.get_pending_endpoints(token);
 
     slogger.trace("creating write handler for token: {} natural: {} pending: {}", token, natural_endpoints, pending_endpoints);
     tracing::trace(tr_state, "Creating write handler for token: {} natural: {} pending: {}", token, natural_endpoints ,pending_endpoints);
@@ -1677,7 +1677,7 @@ storage_proxy::create_write_response_handler_helper(schema_ptr s, const dht::tok
     });
     pending_endpoints.erase(itend, pending_endpoints.end());
 
-    auto all = boost::range::join(natural_endpoints, pending_endpoints);
+    auto all = boost::range::join(std::as_const(natural_endpoints), std::as_const(pending_endpoints));
 
     if (cannot_hint(all, type)) {
         // avoid OOMing due to excess hints.  we need to do this check even for "live" nodes, since we can
@@ -3058,6 +3058,7 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     using digest_resolver_ptr = ::shared_ptr<digest_read_resolver>;
     using data_resolver_ptr = ::shared_ptr<data_read_resolver>;
     using clock_type = storage_proxy::clock_type;
+    using latency_clock = utils::estimated_histogram::clock;
 
     schema_ptr _schema;
     shared_ptr<storage_proxy> _proxy;
@@ -3154,10 +3155,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     future<> make_mutation_data_requests(lw_shared_ptr<query::read_command> cmd, data_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         return parallel_for_each(begin, end, [this, &cmd, resolver = std::move(resolver), timeout] (gms::inet_address ep) {
-            return make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
+            auto start = latency_clock::now();
+            return make_mutation_data_request(cmd, ep, timeout).then_wrapped([this, resolver, ep, start] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<reconcilable_result>>, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
+                    _cf->add_replica_read_latency(ep, replica_read_kind::mutation_data, latency_clock::now() - start);
                     resolver->add_mutate_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->_stats.mutation_data_read_completed.get_ep_stat(ep);
                 } catch(...) {
@@ -3169,10 +3172,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     future<> make_data_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout, bool want_digest) {
         return parallel_for_each(begin, end, [this, resolver = std::move(resolver), timeout, want_digest] (gms::inet_address ep) {
-            return make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
+            auto start = latency_clock::now();
+            return make_data_request(ep, timeout, want_digest).then_wrapped([this, resolver, ep, start] (future<rpc::tuple<foreign_ptr<lw_shared_ptr<query::result>>, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<1>(v));
+                    _cf->add_replica_read_latency(ep, replica_read_kind::data, latency_clock::now() - start);
                     resolver->add_data(ep, std::get<0>(std::move(v)));
                     ++_proxy->_stats.data_read_completed.get_ep_stat(ep);
                     _used_targets.push_back(ep);
@@ -3185,10 +3190,12 @@ class abstract_read_executor : public enable_shared_from_this<abstract_read_exec
     }
     future<> make_digest_requests(digest_resolver_ptr resolver, targets_iterator begin, targets_iterator end, clock_type::time_point timeout) {
         return parallel_for_each(begin, end, [this, resolver = std::move(resolver), timeout] (gms::inet_address ep) {
-            return make_digest_request(ep, timeout).then_wrapped([this, resolver, ep] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> f) {
+            auto start = latency_clock::now();
+            return make_digest_request(ep, timeout).then_wrapped([this, resolver, ep, start] (future<rpc::tuple<query::result_digest, api::timestamp_type, cache_temperature>> f) {
                 try {
                     auto v = f.get0();
                     _cf->set_hit_rate(ep, std::get<2>(v));
+                    _cf->add_replica_read_latency(ep, replica_read_kind::digest, latency_clock::now() - start);
                     resolver->add_digest(ep, std::get<0>(v), std::get<1>(v));
                     ++_proxy->_stats.digest_read_completed.get_ep_stat(ep);
                     _used_targets.push_back(ep);
@@ -3393,9 +3400,51 @@ class always_speculating_read_executor : public abstract_read_executor {
     }
 };
 
+std::optional<std::chrono::microseconds> prioritize_targets_by_latency(std::vector<gms::inet_address>& targets, size_t waited_for, size_t data_targets,
+        const std::function<std::optional<std::chrono::microseconds> (gms::inet_address, replica_read_kind)>& estimate) {
+    auto best = targets.begin();
+    std::optional<std::chrono::microseconds> best_latency;
+    for (auto it = targets.begin(); it != targets.begin() + waited_for; ++it) {
+        auto latency = estimate(*it, replica_read_kind::data);
+        if (latency && (!best_latency || *latency < *best_latency)) {
+            best_latency = latency;
+            best = it;
+        }
+    }
+    if (best_latency) {
+        std::iter_swap(targets.begin(), best);
+    }
+    auto slowest = std::chrono::microseconds(0);
+    for (size_t i = 0; i < waited_for; ++i) {
+        auto latency = estimate(targets[i], i < data_targets ? replica_read_kind::data : replica_read_kind::digest);
+        if (!latency) {
+            return std::nullopt;
+        }
+        slowest = std::max(slowest, *latency);
+    }
+    return slowest;
+}
+
 // this executor sends request to an additional replica after some time below timeout
 class speculating_read_executor : public abstract_read_executor {
     timer<storage_proxy::clock_type> _speculate_timer;
+
+    // The coordinator-wide percentile mixes the latencies of all replicas. When we know how fast the replicas we are
+    // about to wait for are, and they are faster than that, speculate as soon as the slowest of them is late.
+    std::chrono::milliseconds percentile_speculation_delay(double percentile) {
+        auto table_delay = _cf->get_coordinator_read_latency_percentile(percentile);
+        // The last target is the extra one, and with read repair the first two get data requests, see make_requests().
+        size_t data_targets = _block_for < _targets.size() - 1 ? 2 : 1;
+        auto replicas_delay = prioritize_targets_by_latency(_targets, _targets.size() - 1, data_targets,
+                [this, percentile] (gms::inet_address ep, replica_read_kind kind) {
+            return _cf->estimate_replica_read_latency(ep, kind, percentile);
+        });
+        if (replicas_delay && *replicas_delay < table_delay) {
+            tracing::trace(_trace_state, "Speculating after {} us based on replica latencies", replicas_delay->count());
+            return std::max(std::chrono::duration_cast<std::chrono::milliseconds>(*replicas_delay), std::chrono::milliseconds(1));
+        }
+        return table_delay;
+    }
 public:
     using abstract_read_executor::abstract_read_executor;
     virtual future<> make_requests(digest_resolver_ptr resolver, storage_proxy::clock_type::time_point timeout) {
@@ -3417,9 +3466,12 @@ class speculating_read_executor : public abstract_read_executor {
             }
         });
         auto& sr = _schema->speculative_retry();
-        auto t = (sr.get_type() == speculative_retry::type::PERCENTILE) ?
-            std::min(_cf->get_coordinator_read_latency_percentile(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2)) :
-            std::chrono::milliseconds(unsigned(sr.get_value()));
+        std::chrono::milliseconds t;
+        if (sr.get_type() == speculative_retry::type::PERCENTILE) {
+            t = std::min(percentile_speculation_delay(sr.get_value()), std::chrono::milliseconds(_proxy->get_db().local().get_config().read_request_timeout_in_ms()/2));
+        } else {
+            t = std::chrono::milliseconds(unsigned(sr.get_value()));
+        }
         _speculate_timer.arm(t);
 
         // if CL + RR result in covering all replicas, getReadExecutor forces AlwaysSpeculating.  So we know
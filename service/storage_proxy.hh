@@ -651,4 +651,10 @@ inline shared_ptr<storage_proxy> get_local_shared_storage_proxy() {
 dht::partition_range_vector get_restricted_ranges(locator::token_metadata&,
     const schema&, dht::partition_range);
 
+// Moves the target with the lowest estimated data read latency among the first waited_for targets to the front,
+// so that it serves the data request. Returns the latest time by which we expect all of them to reply, the first
+// data_targets ones to data requests and the rest to digest requests, if every one of them has an estimation.
+std::optional<std::chrono::microseconds> prioritize_targets_by_latency(std::vector<gms::inet_address>& targets, size_t waited_for, size_t data_targets,
+        const std::function<std::optional<std::chrono::microseconds> (gms::inet_address, replica_read_kind)>& estimate);
+
 }
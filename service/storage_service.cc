@@ -77,6 +77,7 @@
 #include "auth/common.hh"
 #include "distributed_loader.hh"
 #include "database.hh"
+#include "service/qos/service_level_controller.hh"
 #include <seastar/core/metrics.hh>
 
 using token = dht::token;
@@ -115,6 +116,7 @@ static const sstring COMPUTED_COLUMNS_FEATURE = "COMPUTED_COLUMNS";
 static const sstring CDC_FEATURE = "CDC";
 static const sstring NONFROZEN_UDTS_FEATURE = "NONFROZEN_UDTS";
 static const sstring HINTED_HANDOFF_SEPARATE_CONNECTION_FEATURE = "HINTED_HANDOFF_SEPARATE_CONNECTION";
+static const sstring ALTERNATOR_ENCODED_VALUES_FEATURE = "ALTERNATOR_ENCODED_VALUES";
 
 static const sstring SSTABLE_FORMAT_PARAM_NAME = "sstable_format";
 
@@ -177,6 +179,7 @@ storage_service::storage_service(abort_source& abort_source, distributed<databas
         , _cdc_feature(_feature_service, CDC_FEATURE)
         , _nonfrozen_udts(_feature_service, NONFROZEN_UDTS_FEATURE)
         , _hinted_handoff_separate_connection(_feature_service, HINTED_HANDOFF_SEPARATE_CONNECTION_FEATURE)
+        , _alternator_encoded_values(_feature_service, ALTERNATOR_ENCODED_VALUES_FEATURE)
         , _la_feature_listener(*this, _feature_listeners_sem, sstables::sstable_version_types::la)
         , _mc_feature_listener(*this, _feature_listeners_sem, sstables::sstable_version_types::mc)
         , _replicate_action([this] { return do_replicate_to_all_cores(); })
@@ -237,7 +240,8 @@ void storage_service::enable_all_features() {
         std::ref(_computed_columns),
         std::ref(_cdc_feature),
         std::ref(_nonfrozen_udts),
-        std::ref(_hinted_handoff_separate_connection)
+        std::ref(_hinted_handoff_separate_connection),
+        std::ref(_alternator_encoded_values)
     })
     {
         if (features.count(f.name())) {
@@ -345,6 +349,7 @@ std::set<sstring> storage_service::get_config_supported_features_set() {
         COMPUTED_COLUMNS_FEATURE,
         NONFROZEN_UDTS_FEATURE,
         HINTED_HANDOFF_SEPARATE_CONNECTION_FEATURE,
+        ALTERNATOR_ENCODED_VALUES_FEATURE,
     };
 
     // Do not respect config in the case database is not started
@@ -1605,6 +1610,61 @@ future<> storage_service::replicate_tm_only() {
                 local_ss._token_metadata = tm;
             }
         });
+    }).then([this] {
+        return update_replication_maps();
+    });
+}
+
+future<> storage_service::update_replication_maps() {
+    return seastar::async([this] {
+        // Build against a private copy of the token metadata and of each strategy, so that neither a topology
+        // change nor a schema change can pull them from under us while the build yields.
+        auto tm = _token_metadata;
+        if (tm.sorted_tokens().empty()) {
+            return;
+        }
+        // Only keyspaces which are new, were altered, or whose ring or pending
+        // ranges changed lack a current map on some shard; leave the rest alone.
+        auto stale = _db.map_reduce0([] (database& db) {
+            std::set<sstring> stale;
+            for (auto& ks_name : db.get_non_system_keyspaces()) {
+                if (db.has_keyspace(ks_name) && !db.find_keyspace(ks_name).get_replication_strategy().get_replication_map()) {
+                    stale.insert(ks_name);
+                }
+            }
+            return stale;
+        }, std::set<sstring>(), [] (std::set<sstring> a, std::set<sstring> b) {
+            a.insert(b.begin(), b.end());
+            return a;
+        }).get0();
+        for (auto& ks_name : stale) {
+            if (!_db.local().has_keyspace(ks_name)) {
+                continue;
+            }
+            auto ks_meta = _db.local().find_keyspace(ks_name).metadata();
+            auto rs = locator::abstract_replication_strategy::create_replication_strategy(ks_name, ks_meta->strategy_name(), tm, ks_meta->strategy_options());
+            // Local and everywhere strategies don't depend on token placement.
+            if (rs->get_type() != locator::replication_strategy_type::simple
+                    && rs->get_type() != locator::replication_strategy_type::network_topology) {
+                continue;
+            }
+            auto map = make_lw_shared<const locator::replication_map>(locator::replication_map::build(*rs, tm).get0());
+            // Other shards get their own copy, since the map is reference
+            // counted per shard. Copying is much cheaper than recalculating.
+            // A shard which hasn't applied an alteration yet is skipped; its
+            // keyspace_changed() brings us back here once it has.
+            _db.invoke_on_all([&ks_name, &ks_meta, m = map.get()] (database& db) {
+                if (!db.has_keyspace(ks_name)) {
+                    return;
+                }
+                auto& ks = db.find_keyspace(ks_name);
+                if (ks.metadata()->strategy_name() != ks_meta->strategy_name()
+                        || ks.metadata()->strategy_options() != ks_meta->strategy_options()) {
+                    return;
+                }
+                ks.get_replication_strategy().set_replication_map(make_lw_shared<const locator::replication_map>(*m));
+            }).get();
+        }
     });
 }
 
@@ -2238,6 +2298,10 @@ future<> storage_service::start_native_transport() {
             cql_server_config.max_request_size = ss._service_memory_total;
             cql_server_config.get_service_memory_limiter_semaphore = [ss = std::ref(get_storage_service())] () -> semaphore& { return ss.get().local()._service_memory_limiter; };
             cql_server_config.allow_shard_aware_drivers = cfg.enable_shard_aware_drivers();
+            cql_server_config.get_scheduling_group_for_role = [] (const std::optional<sstring>& role) {
+                auto& slc = qos::get_service_level_controller();
+                return slc.local_is_initialized() ? slc.local().get_scheduling_group(role) : current_scheduling_group();
+            };
             smp_service_group_config cql_server_smp_service_group_config;
             cql_server_smp_service_group_config.max_nonlocal_requests = 5000;
             cql_server_config.bounce_request_smp_service_group = create_smp_service_group(cql_server_smp_service_group_config).get0();
@@ -3122,6 +3186,8 @@ future<> storage_service::update_pending_ranges() {
 
 future<> storage_service::keyspace_changed(const sstring& ks_name) {
     // Update pending ranges since keyspace can be changed after we calculate pending ranges.
+    // This also builds the replication map of a created or altered keyspace, whose new
+    // replication strategy starts out without one, once the pending ranges are replicated.
     return update_pending_ranges().handle_exception([ks_name] (auto ep) {
         slogger.warn("Failed to update pending ranges for ks = {}: {}", ks_name, ep);
     });
@@ -330,6 +330,7 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
     gms::feature _cdc_feature;
     gms::feature _nonfrozen_udts;
     gms::feature _hinted_handoff_separate_connection;
+    gms::feature _alternator_encoded_values;
 
     sstables::sstable_version_types _sstables_format = sstables::sstable_version_types::ka;
     seastar::named_semaphore _feature_listeners_sem = {1, named_semaphore_exception_factory{"feature listeners"}};
@@ -793,6 +794,16 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
      */
     future<> replicate_tm_only();
 
+    /**
+     * Precomputes the replicas of every non-system keyspace from shard0's
+     * token_metadata and installs a copy of the result on every shard, so
+     * that coordinators don't have to calculate them on the request path.
+     * Keyspaces whose map is still current on all shards are not rebuilt.
+     *
+     * Should run on shard 0 only, after replicate_tm_only().
+     */
+    future<> update_replication_maps();
+
     /**
      * Handle node bootstrap
      *
@@ -2367,6 +2378,10 @@ class storage_service : public service::migration_listener, public gms::i_endpoi
         return bool(_hinted_handoff_separate_connection);
     }
 
+    bool cluster_supports_alternator_encoded_values() const {
+        return bool(_alternator_encoded_values);
+    }
+
     // Returns schema features which all nodes in the cluster advertise as supported.
     db::schema_features cluster_schema_features() const;
 
@@ -41,7 +41,7 @@ concept bool ChecksumUtils = requires(const char* input, size_t size, uint32_t c
 };
 )
 
-struct adler32_utils {
+struct zlib_adler32_checksummer {
     inline static uint32_t init_checksum() {
         return adler32(0, Z_NULL, 0);
     }
@@ -64,6 +64,28 @@ struct adler32_utils {
     static constexpr bool prefer_combine() { return true; }
 };
 
+// libdeflate's adler32 is vectorized (SSE2/AVX2 on x86, NEON on aarch64),
+// selected at runtime, while zlib's processes a byte at a time.
+struct libdeflate_adler32_checksummer {
+    static uint32_t init_checksum() {
+        return 1;
+    }
+
+    static uint32_t checksum(const char* input, size_t input_len) {
+        return checksum(init_checksum(), input, input_len);
+    }
+
+    static uint32_t checksum(uint32_t prev, const char* input, size_t input_len) {
+        return libdeflate_adler32(prev, input, input_len);
+    }
+
+    static uint32_t checksum_combine(uint32_t first, uint32_t second, size_t input_len2) {
+        return zlib_adler32_checksummer::checksum_combine(first, second, input_len2);
+    }
+
+    static constexpr bool prefer_combine() { return true; }
+};
+
 struct zlib_crc32_checksummer {
     inline static uint32_t init_checksum() {
         return crc32(0, Z_NULL, 0);
@@ -135,3 +157,23 @@ struct crc32_utils {
         return fast_crc32_combine_optimized();
     }
 };
+
+struct adler32_utils {
+    static uint32_t init_checksum() { return libdeflate_adler32_checksummer::init_checksum(); }
+
+    static uint32_t checksum(const char* input, size_t input_len) {
+        return libdeflate_adler32_checksummer::checksum(input, input_len);
+    }
+
+    static uint32_t checksum(uint32_t prev, const char* input, size_t input_len) {
+        return libdeflate_adler32_checksummer::checksum(prev, input, input_len);
+    }
+
+    static uint32_t checksum_combine(uint32_t first, uint32_t second, size_t input_len2) {
+        return libdeflate_adler32_checksummer::checksum_combine(first, second, input_len2);
+    }
+
+    static constexpr bool prefer_combine() {
+        return libdeflate_adler32_checksummer::prefer_combine();
+    }
+};
@@ -657,6 +657,7 @@ void garbage_collected_sstable_writer::maybe_create_new_sstable_writer() {
         sstable_writer_config cfg;
         cfg.run_identifier = _run_identifier;
         cfg.monitor = &_active_write_monitors.back();
+        cfg.compression_chunk_length = _c->_cf.auto_compression_chunk_length();
         _writer.emplace(_sst->get_writer(*_c->schema(), _c->partitions_per_sstable(), cfg, _c->get_encoding_stats(), priority));
     }
 }
@@ -763,6 +764,7 @@ class regular_compaction : public compaction {
             cfg.max_sstable_size = _max_sstable_size;
             cfg.monitor = &_active_write_monitors.back();
             cfg.run_identifier = _run_identifier;
+            cfg.compression_chunk_length = _cf.auto_compression_chunk_length();
             _writer.emplace(_sst->get_writer(*_schema, partitions_per_sstable(), cfg, get_encoding_stats(), priority));
         }
         do_pending_replacements();
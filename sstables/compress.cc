@@ -19,6 +19,7 @@
  * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <stdexcept>
 #include <cstdlib>
 
@@ -323,6 +324,30 @@ compressor_ptr get_sstable_compressor(const compression& c) {
     return local_compression(c).compressor();
 }
 
+uint64_t compression::read_stats::median_consumed_bytes() const {
+    uint64_t seen = 0;
+    for (size_t i = 0; i < consumed_bytes.size(); ++i) {
+        seen += consumed_bytes[i];
+        if (seen * 2 >= sampled_reads && seen) {
+            return uint64_t(1) << i;
+        }
+    }
+    return 0;
+}
+
+std::optional<int32_t> chunk_length_for_reads(const compression::read_stats& stats) {
+    if (stats.sampled_reads < min_sampled_reads_for_auto_chunk_length) {
+        return std::nullopt;
+    }
+    // A read consuming less than a chunk decompresses data it doesn't need,
+    // while reads spanning many chunks are better off with large chunks,
+    // which compress better. So aim for chunks about as large as what a
+    // typical point read consumes. The median, unlike the mean, isn't
+    // dragged up by the occasional read of a huge partition.
+    // Clamp before narrowing: the top bucket's median, 2^31, doesn't fit in an int32_t.
+    return int32_t(std::clamp<uint64_t>(stats.median_consumed_bytes(), min_auto_chunk_length, max_auto_chunk_length));
+}
+
 // locate() takes a byte position in the uncompressed stream, and finds the
 // the location of the compressed chunk on disk which contains it, and the
 // offset in this chunk.
@@ -348,20 +373,42 @@ GCC6_CONCEPT(
     requires ChecksumUtils<ChecksumType>
 )
 class compressed_file_data_source_impl : public data_source_impl {
+    // Bounds the growth of _read_ahead_chunks; reads are bounded in bytes
+    // by _max_read_ahead_bytes anyway.
+    static constexpr unsigned max_read_ahead_chunks = 64;
+
     std::optional<input_stream<char>> _input_stream;
     sstables::compression* _compression_metadata;
     sstables::compression::segmented_offsets::accessor _offsets;
     sstables::local_compression _compression;
+    size_t _max_read_ahead_bytes;
+    // Position in the compressed file of the first chunk in _chunks.
     uint64_t _underlying_pos;
     uint64_t _pos;
     uint64_t _beg_pos;
     uint64_t _end_pos;
+    // Whole compressed chunks which were read, but not decompressed yet.
+    temporary_buffer<char> _chunks;
+    // The read of the chunks following _chunks. It is started when the last
+    // of _chunks is decompressed, so that its I/O overlaps with consuming
+    // that chunk.
+    std::optional<future<temporary_buffer<char>>> _next_chunks;
+    // How many chunks a read asks for. Starts with one, so that a single
+    // partition read doesn't read ahead what it won't need, and doubles
+    // every time the reader consumed all that was read without skipping.
+    unsigned _read_ahead_chunks = 1;
+    // Whether to record the bytes consumed from [_beg_pos, _end_pos) in the
+    // stats on close().
+    bool _sample_read_size;
+    uint64_t _consumed = 0;
 public:
     compressed_file_data_source_impl(file f, sstables::compression* cm,
-                uint64_t pos, size_t len, file_input_stream_options options)
+                uint64_t pos, size_t len, file_input_stream_options options, bool sample_read_size)
             : _compression_metadata(cm)
             , _offsets(_compression_metadata->offsets.get_accessor())
             , _compression(*cm)
+            , _max_read_ahead_bytes(options.buffer_size)
+            , _sample_read_size(sample_read_size)
     {
         _beg_pos = pos;
         if (pos > _compression_metadata->uncompressed_file_length()) {
@@ -388,44 +435,26 @@ class compressed_file_data_source_impl : public data_source_impl {
                 std::move(options));
         _underlying_pos = start.chunk_start;
         _pos = _beg_pos;
+        ++_compression_metadata->stats.reads;
+        _compression_metadata->stats.requested_bytes += _end_pos - _beg_pos;
     }
     virtual future<temporary_buffer<char>> get() override {
         if (_pos >= _end_pos) {
             return make_ready_future<temporary_buffer<char>>();
         }
-        auto addr = _compression_metadata->locate(_pos, _offsets);
-        // Uncompress the next chunk. We need to skip part of the first
-        // chunk, but then continue to read from beginning of chunks.
-        if (_pos != _beg_pos && addr.offset != 0) {
-            throw std::runtime_error("compressed reader out of sync");
+        if (!_chunks.empty()) {
+            return futurize_apply([this] { return uncompress_next(); });
         }
-        return _input_stream->read_exactly(addr.chunk_len).
-            then([this, addr](temporary_buffer<char> buf) {
-                // The last 4 bytes of the chunk are the adler32/crc32 checksum
-                // of the rest of the (compressed) chunk.
-                auto compressed_len = addr.chunk_len - 4;
-                // FIXME: Do not always calculate checksum - Cassandra has a
-                // probability (defaulting to 1.0, but still...)
-                auto checksum = read_be<uint32_t>(buf.get() + compressed_len);
-                if (checksum != ChecksumType::checksum(buf.get(), compressed_len)) {
-                    throw std::runtime_error("compressed chunk failed checksum");
-                }
-
-                // We know that the uncompressed data will take exactly
-                // chunk_length bytes (or less, if reading the last chunk).
-                temporary_buffer<char> out(
-                        _compression_metadata->uncompressed_chunk_length());
-                // The compressed data is the whole chunk, minus the last 4
-                // bytes (which contain the checksum verified above).
-
-                auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
-
-                out.trim(len);
-                out.trim_front(addr.offset);
-                _pos += out.size();
-                _underlying_pos += addr.chunk_len;
-
-                return out;
+        future<temporary_buffer<char>> f = make_ready_future<temporary_buffer<char>>();
+        if (_next_chunks) {
+            f = std::move(*_next_chunks);
+            _next_chunks = std::nullopt;
+        } else {
+            f = read_chunks(_pos);
+        }
+        return f.then([this] (temporary_buffer<char> chunks) {
+            _chunks = std::move(chunks);
+            return uncompress_next();
         });
     }
 
@@ -433,7 +462,19 @@ class compressed_file_data_source_impl : public data_source_impl {
         if (!_input_stream) {
             return make_ready_future<>();
         }
-        return _input_stream->close();
+        if (_sample_read_size) {
+            _compression_metadata->stats.sample_consumed_bytes(_consumed);
+            _sample_read_size = false;
+        }
+        // The stream can't be closed with a read in flight.
+        auto f = make_ready_future<>();
+        if (_next_chunks) {
+            f = std::move(*_next_chunks).discard_result().handle_exception([] (std::exception_ptr) { });
+            _next_chunks = std::nullopt;
+        }
+        return f.then([this] {
+            return _input_stream->close();
+        });
     }
 
     virtual future<temporary_buffer<char>> skip(uint64_t n) override {
@@ -443,13 +484,107 @@ class compressed_file_data_source_impl : public data_source_impl {
             return make_ready_future<temporary_buffer<char>>();
         }
         auto addr = _compression_metadata->locate(_pos, _offsets);
-        auto underlying_n = addr.chunk_start - _underlying_pos;
-        _underlying_pos = addr.chunk_start;
         _beg_pos = _pos;
-        return _input_stream->skip(underlying_n).then([] {
+        _read_ahead_chunks = 1;
+        if (addr.chunk_start < _underlying_pos + _chunks.size()) {
+            _chunks.trim_front(addr.chunk_start - _underlying_pos);
+            _underlying_pos = addr.chunk_start;
+            return make_ready_future<temporary_buffer<char>>();
+        }
+        _underlying_pos += _chunks.size();
+        _chunks = {};
+        future<temporary_buffer<char>> f = make_ready_future<temporary_buffer<char>>();
+        if (_next_chunks) {
+            f = std::move(*_next_chunks);
+            _next_chunks = std::nullopt;
+        }
+        return f.then([this, chunk_start = addr.chunk_start] (temporary_buffer<char> next_chunks) {
+            // next_chunks, if any, starts at _underlying_pos.
+            if (chunk_start < _underlying_pos + next_chunks.size()) {
+                next_chunks.trim_front(chunk_start - _underlying_pos);
+                _chunks = std::move(next_chunks);
+                _underlying_pos = chunk_start;
+                return make_ready_future<>();
+            }
+            auto underlying_n = chunk_start - _underlying_pos - next_chunks.size();
+            _underlying_pos = chunk_start;
+            return _input_stream->skip(underlying_n);
+        }).then([] {
             return make_ready_future<temporary_buffer<char>>();
         });
     }
+private:
+    // Reads up to _read_ahead_chunks whole chunks, starting with the one
+    // holding the uncompressed position pos, and not past the chunk holding
+    // _end_pos - 1. Reads more than _max_read_ahead_bytes only if the first
+    // chunk alone is larger.
+    future<temporary_buffer<char>> read_chunks(uint64_t pos) {
+        auto ucl = _compression_metadata->uncompressed_chunk_length();
+        pos -= pos % ucl;
+        size_t len = 0;
+        for (unsigned i = 0; i < _read_ahead_chunks && pos < _end_pos; ++i, pos += ucl) {
+            auto addr = _compression_metadata->locate(pos, _offsets);
+            if (len && len + addr.chunk_len > _max_read_ahead_bytes) {
+                break;
+            }
+            len += addr.chunk_len;
+        }
+        return _input_stream->read_exactly(len);
+    }
+
+    temporary_buffer<char> uncompress_next() {
+        auto addr = _compression_metadata->locate(_pos, _offsets);
+        // Uncompress the next chunk. We need to skip part of the first
+        // chunk, but then continue to read from beginning of chunks.
+        if ((_pos != _beg_pos && addr.offset != 0) || addr.chunk_start != _underlying_pos || _chunks.size() < addr.chunk_len) {
+            throw std::runtime_error("compressed reader out of sync");
+        }
+        auto buf = _chunks.share(0, addr.chunk_len);
+        _chunks.trim_front(addr.chunk_len);
+        _underlying_pos += addr.chunk_len;
+
+        if (_chunks.empty() && !_next_chunks) {
+            auto next_pos = _pos - addr.offset + _compression_metadata->uncompressed_chunk_length();
+            if (next_pos < _end_pos) {
+                // Everything read so far was consumed in order.
+                _read_ahead_chunks = std::min(_read_ahead_chunks * 2, max_read_ahead_chunks);
+                _next_chunks = read_chunks(next_pos);
+            }
+        }
+
+        // The last 4 bytes of the chunk are the adler32/crc32 checksum
+        // of the rest of the (compressed) chunk.
+        auto compressed_len = addr.chunk_len - 4;
+        // FIXME: Do not always calculate checksum - Cassandra has a
+        // probability (defaulting to 1.0, but still...)
+        auto checksum = read_be<uint32_t>(buf.get() + compressed_len);
+        if (checksum != ChecksumType::checksum(buf.get(), compressed_len)) {
+            throw std::runtime_error("compressed chunk failed checksum");
+        }
+
+        // We know that the uncompressed data will take exactly
+        // chunk_length bytes (or less, if reading the last chunk).
+        temporary_buffer<char> out(
+                _compression_metadata->uncompressed_chunk_length());
+        // The compressed data is the whole chunk, minus the last 4
+        // bytes (which contain the checksum verified above).
+
+        auto start = std::chrono::steady_clock::now();
+        auto len = _compression.uncompress(buf.get(), compressed_len, out.get_write(), out.size());
+        auto& stats = _compression_metadata->stats;
+        stats.decompression_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        ++stats.decompressed_chunks;
+        stats.decompressed_bytes += len;
+
+        out.trim(len);
+        out.trim_front(addr.offset);
+        _pos += out.size();
+        auto past_end = _pos > _end_pos ? _pos - _end_pos : 0;
+        stats.wasted_bytes += addr.offset + past_end;
+        _consumed += out.size() - past_end;
+
+        return out;
+    }
 };
 
 template <typename ChecksumType>
@@ -459,9 +594,9 @@ GCC6_CONCEPT(
 class compressed_file_data_source : public data_source {
 public:
     compressed_file_data_source(file f, sstables::compression* cm,
-            uint64_t offset, size_t len, file_input_stream_options options)
+            uint64_t offset, size_t len, file_input_stream_options options, bool sample_read_size)
         : data_source(std::make_unique<compressed_file_data_source_impl<ChecksumType>>(
-                std::move(f), cm, offset, len, std::move(options)))
+                std::move(f), cm, offset, len, std::move(options), sample_read_size))
         {}
 };
 
@@ -471,10 +606,10 @@ GCC6_CONCEPT(
 )
 inline input_stream<char> make_compressed_file_input_stream(
         file f, sstables::compression *cm, uint64_t offset, size_t len,
-        file_input_stream_options options)
+        file_input_stream_options options, bool sample_read_size)
 {
     return input_stream<char>(compressed_file_data_source<ChecksumType>(
-            std::move(f), cm, offset, len, std::move(options)));
+            std::move(f), cm, offset, len, std::move(options), sample_read_size));
 }
 
 // For SSTables 2.x (formats 'ka' and 'la'), the full checksum is a combination of checksums of compressed chunks.
@@ -589,9 +724,9 @@ inline output_stream<char> make_compressed_file_output_stream(file f, file_outpu
 
 input_stream<char> sstables::make_compressed_file_k_l_format_input_stream(file f,
         sstables::compression* cm, uint64_t offset, size_t len,
-        class file_input_stream_options options)
+        class file_input_stream_options options, bool sample_read_size)
 {
-    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options));
+    return make_compressed_file_input_stream<adler32_utils>(std::move(f), cm, offset, len, std::move(options), sample_read_size);
 }
 
 output_stream<char> sstables::make_compressed_file_k_l_format_output_stream(file f,
@@ -604,8 +739,8 @@ output_stream<char> sstables::make_compressed_file_k_l_format_output_stream(file
 
 input_stream<char> sstables::make_compressed_file_m_format_input_stream(file f,
         sstables::compression *cm, uint64_t offset, size_t len,
-        class file_input_stream_options options) {
-    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options));
+        class file_input_stream_options options, bool sample_read_size) {
+    return make_compressed_file_input_stream<crc32_utils>(std::move(f), cm, offset, len, std::move(options), sample_read_size);
 }
 
 output_stream<char> sstables::make_compressed_file_m_format_output_stream(file f,
@@ -47,6 +47,8 @@
 // level Cassandra rows, not disk blocks.
 
 #include <vector>
+#include <array>
+#include <optional>
 #include <cstdint>
 #include <iterator>
 
@@ -54,6 +56,7 @@
 #include <seastar/core/reactor.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/fstream.hh>
+#include <seastar/core/bitops.hh>
 
 #include "types.hh"
 #include "sstables/types.hh"
@@ -308,6 +311,49 @@ struct compression {
     uint64_t _compressed_file_length = 0;
     uint32_t _full_checksum = 0;
 public:
+    // Statistics of the reads of the data file, kept in memory only.
+    struct read_stats {
+        // Number of reads, and the uncompressed bytes they asked for.
+        uint64_t reads = 0;
+        uint64_t requested_bytes = 0;
+        uint64_t decompressed_chunks = 0;
+        uint64_t decompressed_bytes = 0;
+        // Decompressed bytes outside of the range a read asked for.
+        uint64_t wasted_bytes = 0;
+        uint64_t decompression_ns = 0;
+        // Single partition reads on behalf of users, and a histogram of the
+        // uncompressed bytes they consumed: bucket i counts the reads which
+        // consumed more than 2^(i-1) and up to 2^i bytes.
+        uint64_t sampled_reads = 0;
+        std::array<uint64_t, 32> consumed_bytes{};
+
+        void sample_consumed_bytes(uint64_t bytes) {
+            ++sampled_reads;
+            ++consumed_bytes[std::min<size_t>(bytes ? log2ceil(bytes) : 0, consumed_bytes.size() - 1)];
+        }
+        // The median of the bytes consumed by sampled reads, rounded up to a
+        // power of two. Zero if no reads were sampled.
+        uint64_t median_consumed_bytes() const;
+
+        read_stats& operator+=(const read_stats& o) {
+            reads += o.reads;
+            requested_bytes += o.requested_bytes;
+            decompressed_chunks += o.decompressed_chunks;
+            decompressed_bytes += o.decompressed_bytes;
+            wasted_bytes += o.wasted_bytes;
+            decompression_ns += o.decompression_ns;
+            sampled_reads += o.sampled_reads;
+            for (size_t i = 0; i < consumed_bytes.size(); ++i) {
+                consumed_bytes[i] += o.consumed_bytes[i];
+            }
+            return *this;
+        }
+        friend read_stats operator+(read_stats a, const read_stats& b) {
+            return a += b;
+        }
+    };
+    read_stats stats;
+
     // Set the compressor algorithm, please check the definition of enum compressor.
     void set_compressor(compressor_ptr c);
     // After changing _compression, update() must be called to update
@@ -370,6 +416,19 @@ struct compression {
 // for API query only. Free function just to distinguish it from an accessor in compression
 compressor_ptr get_sstable_compressor(const compression&);
 
+// The bounds of the chunk lengths chunk_length_for_reads() picks, and how
+// many reads it needs to have seen before picking one.
+constexpr int32_t min_auto_chunk_length = 4 * 1024;
+constexpr int32_t max_auto_chunk_length = 64 * 1024;
+constexpr uint64_t min_sampled_reads_for_auto_chunk_length = 1000;
+
+// The compression chunk length best suited to the reads described by the
+// stats, or nothing if too few reads were sampled to tell.
+std::optional<int32_t> chunk_length_for_reads(const compression::read_stats& stats);
+
+// With sample_read_size, the number of bytes consumed from the stream is
+// recorded in cm->stats when it is closed.
+//
 // Note: compression_metadata is passed by reference; The caller is
 // responsible for keeping the compression_metadata alive as long as there
 // are open streams on it. This should happen naturally on a higher level -
@@ -377,7 +436,7 @@ compressor_ptr get_sstable_compressor(const compression&);
 // sstable alive, and the compression metadata is only a part of it.
 input_stream<char> make_compressed_file_k_l_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options, bool sample_read_size = false);
 
 output_stream<char> make_compressed_file_k_l_format_output_stream(file f,
                 file_output_stream_options options,
@@ -386,7 +445,7 @@ output_stream<char> make_compressed_file_k_l_format_output_stream(file f,
 
 input_stream<char> make_compressed_file_m_format_input_stream(file f,
                 sstables::compression* cm, uint64_t offset, size_t len,
-                class file_input_stream_options options);
+                class file_input_stream_options options, bool sample_read_size = false);
 
 output_stream<char> make_compressed_file_m_format_output_stream(file f,
                 file_output_stream_options options,
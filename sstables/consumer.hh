@@ -30,6 +30,7 @@
 #include <seastar/util/variant_utils.hh>
 #include <seastar/net/byteorder.hh>
 #include "bytes.hh"
+#include "utils/fragmented_temporary_buffer.hh"
 
 #include <variant>
 
@@ -73,6 +74,7 @@ class continuous_data_consumer {
         READING_U32,
         READING_U64,
         READING_BYTES,
+        READING_FRAGMENTED_BYTES,
         READING_U16_BYTES,
         READING_UNSIGNED_VINT,
         READING_UNSIGNED_VINT_LENGTH_BYTES,
@@ -100,6 +102,10 @@ class continuous_data_consumer {
     // state for READING_BYTES prestate
     temporary_buffer<char> _read_bytes;
     temporary_buffer<char>* _read_bytes_where; // which temporary_buffer to set, _key or _val?
+    // state for READING_FRAGMENTED_BYTES prestate
+    std::vector<temporary_buffer<char>> _read_fragments;
+    uint32_t _read_fragments_size;
+    fragmented_temporary_buffer* _read_fragments_where;
 
     enum class read_status { ready, waiting };
 private:
@@ -201,6 +207,32 @@ class continuous_data_consumer {
             return read_status::waiting;
         }
     }
+    // Like read_bytes(), but a value which crosses input buffers is kept as
+    // shared fragments of them in fragmented_where instead of being copied
+    // into a contiguous buffer, so that large values don't need large
+    // allocations. Exactly one of where and fragmented_where is non-empty
+    // once the read is complete.
+    inline read_status read_fragmented_bytes(temporary_buffer<char>& data, uint32_t len,
+            temporary_buffer<char>& where, fragmented_temporary_buffer& fragmented_where) {
+        fragmented_where = fragmented_temporary_buffer();
+        if (data.size() >= len) {
+            where = data.share(0, len);
+            data.trim_front(len);
+            return read_status::ready;
+        } else {
+            where = temporary_buffer<char>();
+            _read_fragments.clear();
+            if (!data.empty()) {
+                _read_fragments.push_back(data.share());
+            }
+            _read_fragments_size = len;
+            _read_fragments_where = &fragmented_where;
+            _pos = data.size();
+            data.trim(0);
+            _prestate = prestate::READING_FRAGMENTED_BYTES;
+            return read_status::waiting;
+        }
+    }
     data_consumer::processing_result skip(temporary_buffer<char>& data, uint32_t len) {
         if (data.size() >= len) {
             data.trim_front(len);
@@ -331,6 +363,19 @@ class continuous_data_consumer {
             }
             break;
         }
+        case prestate::READING_FRAGMENTED_BYTES: {
+            auto n = std::min(size_t(_read_fragments_size - _pos), data.size());
+            if (n) {
+                _read_fragments.push_back(data.share(0, n));
+                data.trim_front(n);
+            }
+            _pos += n;
+            if (_pos == _read_fragments_size) {
+                *_read_fragments_where = fragmented_temporary_buffer(std::exchange(_read_fragments, {}), _read_fragments_size);
+                _prestate = prestate::NONE;
+            }
+            break;
+        }
         case prestate::READING_U8:
             if (process_int(data, sizeof(uint8_t))) {
                 _u8 = _read_int.uint8;
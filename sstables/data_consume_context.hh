@@ -187,7 +187,7 @@ inline data_consume_context<DataConsumeRowsContext> data_consume_rows(const sche
 template <typename DataConsumeRowsContext>
 inline data_consume_context<DataConsumeRowsContext> data_consume_single_partition(const schema& s, shared_sstable sst, typename DataConsumeRowsContext::consumer& consumer, sstable::disk_read_range toread) {
     auto input = sst->data_stream(toread.start, toread.end - toread.start, consumer.io_priority(),
-            consumer.resource_tracker(), consumer.trace_state(), sst->_single_partition_history);
+            consumer.resource_tracker(), consumer.trace_state(), sst->_single_partition_history, true);
     return {s, std::move(sst), consumer, std::move(input), toread.start, toread.end - toread.start };
 }
 
@@ -839,7 +839,7 @@ void writer::init_file_writers() {
                 std::move(_sst._data_file),
                 options,
                 &_sst._components->compression,
-                _schema.get_compressor_params()));
+                compression_params()));
     }
     _index_writer = std::make_unique<file_writer>(std::move(_sst._index_file), options);
 }
@@ -90,9 +90,11 @@ struct new_mutation {
     tombstone tomb;
 };
 
+// Value is either a bytes_view or a fragmented_temporary_buffer::view
+template <typename Value>
 inline atomic_cell make_atomic_cell(const abstract_type& type,
                                     api::timestamp_type timestamp,
-                                    bytes_view value,
+                                    const Value& value,
                                     gc_clock::duration ttl,
                                     gc_clock::time_point expiration,
                                     atomic_cell::collection_member cm) {
@@ -544,7 +546,7 @@ class mp_row_consumer_k_l : public row_consumer {
         });
     }
 
-    virtual proceed consume_cell(bytes_view col_name, bytes_view value, int64_t timestamp, int64_t ttl, int64_t expiration) override {
+    virtual proceed consume_cell(bytes_view col_name, fragmented_temporary_buffer::view value, int64_t timestamp, int64_t ttl, int64_t expiration) override {
         return do_consume_cell(col_name, timestamp, ttl, expiration, [&] (auto&& col) {
             bool is_multi_cell = col.collection_extra_data.size();
             if (is_multi_cell != col.cdef->is_multi_cell()) {
@@ -1192,14 +1194,14 @@ class mp_row_consumer_m : public consumer_m {
 
     virtual proceed consume_column(const column_translation::column_info& column_info,
                                    bytes_view cell_path,
-                                   bytes_view value,
+                                   fragmented_temporary_buffer::view value,
                                    api::timestamp_type timestamp,
                                    gc_clock::duration ttl,
                                    gc_clock::time_point local_deletion_time,
                                    bool is_deleted) override {
         const std::optional<column_id>& column_id = column_info.id;
-        sstlog.trace("mp_row_consumer_m {}: consume_column(id={}, path={}, value={}, ts={}, ttl={}, del_time={}, deleted={})", this,
-            column_id, cell_path, value, timestamp, ttl.count(), local_deletion_time.time_since_epoch().count(), is_deleted);
+        sstlog.trace("mp_row_consumer_m {}: consume_column(id={}, path={}, value_size={}, ts={}, ttl={}, del_time={}, deleted={})", this,
+            column_id, cell_path, value.size_bytes(), timestamp, ttl.count(), local_deletion_time.time_since_epoch().count(), is_deleted);
         check_column_missing_in_current_schema(column_info, timestamp);
         if (!column_id) {
             return proceed::yes;
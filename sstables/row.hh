@@ -63,7 +63,8 @@
 // wants to hold these strings longer, it must make a copy of the bytes_view's
 // contents. [Note, in reality, because our implementation reads the whole
 // row into one buffer, the byte_views remain valid until consume_row_end()
-// is called.]
+// is called.] Cell values, which can be large, are passed as a
+// fragmented_temporary_buffer::view instead, with the same lifetime.
 class row_consumer {
     reader_resource_tracker _resource_tracker;
     tracing::trace_state_ptr _trace_state;
@@ -100,7 +101,7 @@ class row_consumer {
     // (in seconds) originally set for this cell, and "expiration" is the
     // absolute time (in seconds since the UNIX epoch) when this cell will
     // expire. Typical cells, not set to expire, will get expiration = 0.
-    virtual proceed consume_cell(bytes_view col_name, bytes_view value,
+    virtual proceed consume_cell(bytes_view col_name, fragmented_temporary_buffer::view value,
             int64_t timestamp,
             int64_t ttl, int64_t expiration) = 0;
 
@@ -192,7 +193,7 @@ class consumer_m {
 
     virtual proceed consume_column(const sstables::column_translation::column_info& column_info,
                                    bytes_view cell_path,
-                                   bytes_view value,
+                                   fragmented_temporary_buffer::view value,
                                    api::timestamp_type timestamp,
                                    gc_clock::duration ttl,
                                    gc_clock::time_point local_deletion_time,
@@ -273,6 +274,8 @@ class data_consume_rows_context : public data_consumer::continuous_data_consumer
 
     temporary_buffer<char> _key;
     temporary_buffer<char> _val;
+    // Holds the cell value instead of _val when it crossed input buffers
+    fragmented_temporary_buffer _val_fragments;
 
     // state for reading a cell
     bool _deleted;
@@ -280,6 +283,12 @@ class data_consume_rows_context : public data_consumer::continuous_data_consumer
     uint32_t _ttl, _expiration;
 
     bool _shadowable;
+    fragmented_temporary_buffer::view cell_value() const {
+        if (!_val_fragments.empty()) {
+            return fragmented_temporary_buffer::view(_val_fragments);
+        }
+        return fragmented_temporary_buffer::view(to_bytes_view(_val));
+    }
 public:
     using consumer = row_consumer;
     bool non_consuming() const {
@@ -445,7 +454,7 @@ class data_consume_rows_context : public data_consumer::continuous_data_consumer
                 break;
             }
         case state::CELL_VALUE_BYTES:
-            if (read_bytes(data, _u32, _val) != read_status::ready) {
+            if (read_fragmented_bytes(data, _u32, _val, _val_fragments) != read_status::ready) {
                 _state = state::CELL_VALUE_BYTES_2;
                 break;
             }
@@ -453,24 +462,28 @@ class data_consume_rows_context : public data_consumer::continuous_data_consumer
         {
             row_consumer::proceed ret;
             if (_deleted) {
-                if (_val.size() != 4) {
+                if (cell_value().size_bytes() != 4) {
                     throw malformed_sstable_exception("deleted cell expects local_deletion_time value");
                 }
                 deletion_time del;
-                del.local_deletion_time = consume_be<uint32_t>(_val);
+                del.local_deletion_time = with_linearized(cell_value(), [] (bytes_view v) {
+                    return read_be<uint32_t>(reinterpret_cast<const char*>(v.data()));
+                });
                 del.marked_for_delete_at = _u64;
                 ret = _consumer.consume_deleted_cell(to_bytes_view(_key), del);
             } else if (_counter) {
-                ret = _consumer.consume_counter_cell(to_bytes_view(_key),
-                        to_bytes_view(_val), _u64);
+                ret = with_linearized(cell_value(), [&] (bytes_view value) {
+                    return _consumer.consume_counter_cell(to_bytes_view(_key), value, _u64);
+                });
             } else {
                 ret = _consumer.consume_cell(to_bytes_view(_key),
-                        to_bytes_view(_val), _u64, _ttl, _expiration);
+                        cell_value(), _u64, _ttl, _expiration);
             }
             // after calling the consume function, we can release the
             // buffers we held for it.
             _key.release();
             _val.release();
+            _val_fragments = fragmented_temporary_buffer();
             _state = state::ATOM_START;
             if (ret == row_consumer::proceed::no) {
                 return row_consumer::proceed::no;
@@ -606,6 +619,7 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         COLUMN_TTL_2,
         COLUMN_CELL_PATH,
         COLUMN_VALUE,
+        COLUMN_VALUE_BYTES,
         COLUMN_END,
         RANGE_TOMBSTONE_MARKER,
         RANGE_TOMBSTONE_KIND,
@@ -666,6 +680,8 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     gc_clock::duration _column_ttl;
     uint32_t _column_value_length;
     temporary_buffer<char> _column_value;
+    // Holds the value instead of _column_value when it crossed input buffers
+    fragmented_temporary_buffer _column_value_fragments;
     temporary_buffer<char> _cell_path;
     uint64_t _ck_blocks_header;
     uint32_t _ck_blocks_header_offset;
@@ -713,6 +729,13 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
     const column_translation::column_info& get_column_info() const {
         return _row->_columns.front();
     }
+    fragmented_temporary_buffer::view column_value() const {
+        if (!_column_value_fragments.empty()) {
+            return fragmented_temporary_buffer::view(_column_value_fragments);
+        }
+        return fragmented_temporary_buffer::view(to_bytes_view(_column_value));
+    }
+
     std::optional<uint32_t> get_column_value_length() const {
         return _row->_columns.front().value_length;
     }
@@ -1113,33 +1136,36 @@ class data_consume_rows_context_m : public data_consumer::continuous_data_consum
         {
             if (!_column_flags.has_value()) {
                 _column_value = temporary_buffer<char>(0);
+                _column_value_fragments = fragmented_temporary_buffer();
                 _state = state::COLUMN_END;
                 goto column_end_label;
             }
-            read_status status = read_status::waiting;
             if (auto len = get_column_value_length()) {
-                status = read_bytes(data, *len, _column_value);
-            } else {
-                status = read_unsigned_vint_length_bytes(data, _column_value);
+                _u64 = *len;
+            } else if (read_unsigned_vint(data) != read_status::ready) {
+                _state = state::COLUMN_VALUE_BYTES;
+                break;
             }
-            if (status != read_status::ready) {
+        }
+        case state::COLUMN_VALUE_BYTES:
+            if (read_fragmented_bytes(data, static_cast<uint32_t>(_u64), _column_value, _column_value_fragments) != read_status::ready) {
                 _state = state::COLUMN_END;
                 break;
             }
-        }
         case state::COLUMN_END:
         column_end_label:
             _state = state::NEXT_COLUMN;
             if (is_column_counter() && !_column_flags.is_deleted()) {
-                if (_consumer.consume_counter_column(get_column_info(),
-                                                     to_bytes_view(_column_value),
-                                                     _column_timestamp) == consumer_m::proceed::no) {
+                auto ret = with_linearized(column_value(), [&] (bytes_view value) {
+                    return _consumer.consume_counter_column(get_column_info(), value, _column_timestamp);
+                });
+                if (ret == consumer_m::proceed::no) {
                     return consumer_m::proceed::no;
                 }
             } else {
                 if (_consumer.consume_column(get_column_info(),
                                              to_bytes_view(_cell_path),
-                                             to_bytes_view(_column_value),
+                                             column_value(),
                                              _column_timestamp,
                                              _column_ttl,
                                              _column_local_deletion_time,
@@ -67,6 +67,7 @@
 #include "checked-file-impl.hh"
 #include "integrity_checked_file_impl.hh"
 #include "service/storage_service.hh"
+#include "service/priority_manager.hh"
 #include "db/extensions.hh"
 #include "unimplemented.hh"
 #include "vint-serialization.hh"
@@ -2289,7 +2290,7 @@ void sstable_writer_k_l::prepare_file_writer()
         _writer = std::make_unique<adler32_checksummed_file_writer>(std::move(_sst._data_file), std::move(options));
     } else {
         _writer = std::make_unique<file_writer>(make_compressed_file_k_l_format_output_stream(
-                std::move(_sst._data_file), std::move(options), &_sst._components->compression, _schema.get_compressor_params()));
+                std::move(_sst._data_file), std::move(options), &_sst._components->compression, compression_params()));
     }
 }
 
@@ -2789,7 +2790,8 @@ component_type sstable::component_from_sstring(version_types v, sstring &s) {
 }
 
 input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-        reader_resource_tracker resource_tracker, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history) {
+        reader_resource_tracker resource_tracker, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history,
+        bool single_partition) {
     file_input_stream_options options;
     options.buffer_size = sstable_buffer_size;
     options.io_priority_class = pc;
@@ -2803,12 +2805,14 @@ input_stream<char> sstable::data_stream(uint64_t pos, size_t len, const io_prior
 
     input_stream<char> stream;
     if (_components->compression) {
+        // Only user reads tell how the table is queried.
+        auto sample_read_size = single_partition && !service::get_local_priority_manager().is_maintenance_priority(pc);
         if (_version == sstable_version_types::mc) {
              return make_compressed_file_m_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), sample_read_size);
         } else {
             return make_compressed_file_k_l_format_input_stream(f, &_components->compression,
-                pos, len, std::move(options));
+                pos, len, std::move(options), sample_read_size);
         }
     }
 
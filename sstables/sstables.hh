@@ -122,6 +122,8 @@ struct sstable_writer_config {
     bool correctly_serialize_non_compound_range_tombstones = supports_correct_non_compound_range_tombstones();
     bool correctly_serialize_static_compact_in_mc = supports_correct_static_compact_in_mc();
     utils::UUID run_identifier = utils::make_random_uuid();
+    // Overrides the compression chunk length of the schema.
+    std::optional<int32_t> compression_chunk_length;
 };
 
 class sstable_tracker;
@@ -627,8 +629,12 @@ class sstable : public enable_lw_shared_from_this<sstable> {
     // of bytes to be read using this stream, we can make better choices
     // about the buffer size to read, and where exactly to stop reading
     // (even when a large buffer size is used).
+    // single_partition marks the read of one partition, whose size is
+    // sampled for the compression read stats unless it is done on behalf
+    // of compaction or streaming.
     input_stream<char> data_stream(uint64_t pos, size_t len, const io_priority_class& pc,
-            reader_resource_tracker resource_tracker, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history);
+            reader_resource_tracker resource_tracker, tracing::trace_state_ptr trace_state, lw_shared_ptr<file_input_stream_history> history,
+            bool single_partition = false);
 
     // Read exactly the specific byte range from the data file (after
     // uncompression, if the file is compressed). This can be used to read
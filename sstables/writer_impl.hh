@@ -40,6 +40,16 @@ struct sstable_writer::writer_impl {
         , _cfg(cfg)
     {}
 
+    // The compression parameters of the schema, with the chunk length
+    // overridden by the config, if it has one.
+    compression_parameters compression_params() const {
+        auto cp = _schema.get_compressor_params();
+        if (_cfg.compression_chunk_length) {
+            cp = cp.with_chunk_length(*_cfg.compression_chunk_length);
+        }
+        return cp;
+    }
+
     virtual void consume_new_partition(const dht::decorated_key& dk) = 0;
     virtual void consume(tombstone t) = 0;
     virtual stop_iteration consume(static_row&& sr) = 0;
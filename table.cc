@@ -42,6 +42,7 @@
 #include <boost/algorithm/cxx11/any_of.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/algorithm/sort.hpp>
 
 static logging::logger tlogger("table");
 
@@ -274,6 +275,301 @@ class incremental_reader_selector : public reader_selector {
     }
 };
 
+// Reads a single partition from several sstables, leaving out the ones
+// whose data is all shadowed by a partition tombstone from another sstable.
+//
+// An sstable can hold nothing newer than its max_timestamp, so once a
+// partition tombstone newer than that is known, none of its data for the
+// partition can be live. The partition headers are peeked from all sstables
+// concurrently, so the read isn't serialized, and only the sstables which
+// may hold live data go on to read rows. On time-series tables, where the
+// sstables of older time windows often hold only deleted data of a
+// partition, this avoids reading their rows altogether.
+class partition_tombstone_filtering_reader : public flat_mutation_reader::impl {
+    std::vector<sstables::shared_sstable> _sstables;
+    std::vector<flat_mutation_reader> _readers;
+    std::optional<flat_mutation_reader> _reader;
+    streamed_mutation::forwarding _fwd;
+    mutation_reader::forwarding _fwd_mr;
+    ::cf_stats& _stats;
+    utils::estimated_histogram& _sstable_histogram;
+private:
+    future<> ensure_reader(db::timeout_clock::time_point timeout) {
+        if (_reader) {
+            return make_ready_future<>();
+        }
+        auto tombstones = make_lw_shared<std::vector<tombstone>>(_readers.size());
+        return parallel_for_each(boost::irange<size_t>(0, _readers.size()), [this, tombstones, timeout] (size_t i) {
+            return _readers[i].peek(timeout).then([tombstones, i] (mutation_fragment* mf) {
+                if (mf && mf->is_partition_start()) {
+                    (*tombstones)[i] = mf->as_partition_start().partition_tombstone();
+                }
+            });
+        }).then([this, tombstones] {
+            auto newest = boost::accumulate(*tombstones, tombstone());
+            std::vector<flat_mutation_reader> readers;
+            readers.reserve(_readers.size());
+            for (size_t i = 0; i < _readers.size(); ++i) {
+                bool shadowed = newest && _sstables[i]->get_stats_metadata().max_timestamp <= newest.timestamp
+                        && (*tombstones)[i] != newest;
+                if (shadowed || (_readers[i].is_end_of_stream() && _readers[i].is_buffer_empty())) {
+                    _stats.sstables_skipped_by_partition_tombstone += shadowed;
+                    continue;
+                }
+                readers.push_back(std::move(_readers[i]));
+            }
+            _readers.clear();
+            _sstables.clear();
+            _sstable_histogram.add(readers.size());
+            _reader = make_combined_reader(_schema, std::move(readers), _fwd, _fwd_mr);
+        });
+    }
+public:
+    partition_tombstone_filtering_reader(schema_ptr s, std::vector<sstables::shared_sstable> sstables, std::vector<flat_mutation_reader> readers,
+            streamed_mutation::forwarding fwd, mutation_reader::forwarding fwd_mr, ::cf_stats& stats, utils::estimated_histogram& sstable_histogram)
+        : impl(std::move(s))
+        , _sstables(std::move(sstables))
+        , _readers(std::move(readers))
+        , _fwd(fwd)
+        , _fwd_mr(fwd_mr)
+        , _stats(stats)
+        , _sstable_histogram(sstable_histogram)
+    { }
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        return ensure_reader(timeout).then([this, timeout] {
+            return _reader->fill_buffer(timeout).then([this] {
+                _end_of_stream = _reader->is_end_of_stream();
+                _reader->move_buffer_content_to(*this);
+            });
+        });
+    }
+    virtual void next_partition() override {
+        clear_buffer_to_next_partition();
+        if (!is_buffer_empty()) {
+            return;
+        }
+        if (!_reader) {
+            // Nothing has been read yet, so the only partition is skipped as a whole.
+            _readers.clear();
+            _sstables.clear();
+            _reader = make_empty_flat_reader(_schema);
+            _end_of_stream = true;
+            return;
+        }
+        _reader->next_partition();
+        _end_of_stream = _reader->is_end_of_stream() && _reader->is_buffer_empty();
+    }
+    virtual future<> fast_forward_to(position_range pr, db::timeout_clock::time_point timeout) override {
+        _end_of_stream = false;
+        forward_buffer_to(pr.start());
+        return ensure_reader(timeout).then([this, pr = std::move(pr), timeout] () mutable {
+            return _reader->fast_forward_to(std::move(pr), timeout);
+        });
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        _end_of_stream = false;
+        clear_buffer();
+        return ensure_reader(timeout).then([this, &pr, timeout] {
+            return _reader->fast_forward_to(pr, timeout);
+        });
+    }
+    virtual size_t buffer_size() const override {
+        return flat_mutation_reader::impl::buffer_size() + (_reader ? _reader->buffer_size() : 0);
+    }
+};
+
+// Reads a single clustering row from several sstables, newest first, and
+// stops once the remaining sstables can't change it.
+//
+// An sstable holds nothing newer than its max_timestamp. Once the static
+// row, the row marker and every cell read so far are newer than the
+// max_timestamp of the next sstable, or a tombstone read so far covers that
+// timestamp, the remaining sstables can only hold superseded data. On
+// time-series tables, with an sstable per time window, a read of a recent
+// row thus only touches the sstables of the recent windows.
+//
+// The sstables are read one after another, so this is only used when the
+// newest sstables are likely enough: reads of a single full clustering key
+// of a table with atomic, non-counter columns.
+//
+// Readers with streamed_mutation::forwarding populate the cache, which keeps
+// the partition tombstone of a partition entry for all of its rows. Those
+// don't skip sstables which may hold tombstones, unless a partition tombstone
+// already read supersedes them.
+class timestamp_ordered_single_row_reader : public flat_mutation_reader::impl {
+    std::vector<sstables::shared_sstable> _sstables; // newest max_timestamp first
+    const dht::partition_range& _pr;
+    const query::partition_slice& _slice;
+    const io_priority_class& _pc;
+    reader_resource_tracker _resource_tracker;
+    tracing::trace_state_ptr _trace_state;
+    clustering_key _key;
+    streamed_mutation::forwarding _fwd;
+    ::cf_stats& _stats;
+    utils::estimated_histogram& _sstable_histogram;
+    std::optional<flat_mutation_reader> _reader;
+private:
+    bool all_cells_newer(const row& r, const schema::const_iterator_range_type& columns, api::timestamp_type ts) const {
+        return boost::algorithm::all_of(columns, [&] (const column_definition& cdef) {
+            auto* cell = r.find_cell(cdef.id);
+            return cell && cell->as_atomic_cell(cdef).timestamp() > ts;
+        });
+    }
+    // Whether data no newer than older_max can't change the row read so far.
+    bool supersedes(const mutation& m, api::timestamp_type older_max) const {
+        auto& p = m.partition();
+        if (p.partition_tombstone().timestamp >= older_max) {
+            return true;
+        }
+        if (!all_cells_newer(p.static_row().get(), _schema->static_columns(), older_max)) {
+            return false;
+        }
+        if (p.tombstone_for_row(*_schema, _key).tomb().timestamp >= older_max) {
+            return true;
+        }
+        auto rows = p.non_dummy_rows();
+        if (rows.empty()) {
+            return false;
+        }
+        auto& r = rows.begin()->row();
+        return r.marker().timestamp() > older_max && all_cells_newer(r.cells(), _schema->regular_columns(), older_max);
+    }
+    bool can_skip_from(const mutation& m, size_t first) const {
+        auto older_max = _sstables[first]->get_stats_metadata().max_timestamp;
+        if (m.partition().partition_tombstone().timestamp >= older_max) {
+            return true;
+        }
+        if (_fwd && !std::all_of(_sstables.begin() + first, _sstables.end(), [] (const sstables::shared_sstable& sst) {
+                return sst->get_stats_metadata().estimated_tombstone_drop_time.bin.empty();
+            })) {
+            return false;
+        }
+        return supersedes(m, older_max);
+    }
+    future<> ensure_reader(db::timeout_clock::time_point timeout) {
+        if (_reader) {
+            return make_ready_future<>();
+        }
+        return do_with(size_t(0), mutation_opt(), [this, timeout] (size_t& read, mutation_opt& result) {
+            return repeat([this, timeout, &read, &result] {
+                if (read == _sstables.size() || (result && can_skip_from(*result, read))) {
+                    return make_ready_future<stop_iteration>(stop_iteration::yes);
+                }
+                auto& sst = _sstables[read++];
+                tracing::trace(_trace_state, "Reading key {} from sstable {}", _pr, seastar::value_of([&sst] { return sst->get_filename(); }));
+                auto reader = sst->read_row_flat(_schema, _pr.start()->value(), _slice, _pc, _resource_tracker, _trace_state);
+                return do_with(std::move(reader), [&result, timeout] (flat_mutation_reader& reader) {
+                    return read_mutation_from_flat_mutation_reader(reader, timeout).then([&result] (mutation_opt mo) {
+                        if (mo && result) {
+                            result->apply(std::move(*mo));
+                        } else if (mo) {
+                            result = std::move(mo);
+                        }
+                        return stop_iteration::no;
+                    });
+                });
+            }).then([this, &read, &result] {
+                _stats.sstables_skipped_by_timestamp += _sstables.size() - read;
+                _sstable_histogram.add(read);
+                _sstables.clear();
+                if (result) {
+                    std::vector<mutation> ms;
+                    ms.push_back(std::move(*result));
+                    _reader = flat_mutation_reader_from_mutations(std::move(ms), _pr, _slice, _fwd);
+                } else {
+                    _reader = make_empty_flat_reader(_schema);
+                }
+            });
+        });
+    }
+public:
+    timestamp_ordered_single_row_reader(schema_ptr s, std::vector<sstables::shared_sstable> sstables, const dht::partition_range& pr,
+            const query::partition_slice& slice, const io_priority_class& pc, reader_resource_tracker resource_tracker,
+            tracing::trace_state_ptr trace_state, clustering_key key, streamed_mutation::forwarding fwd,
+            ::cf_stats& stats, utils::estimated_histogram& sstable_histogram)
+        : impl(std::move(s))
+        , _sstables(std::move(sstables))
+        , _pr(pr)
+        , _slice(slice)
+        , _pc(pc)
+        , _resource_tracker(resource_tracker)
+        , _trace_state(std::move(trace_state))
+        , _key(std::move(key))
+        , _fwd(fwd)
+        , _stats(stats)
+        , _sstable_histogram(sstable_histogram)
+    {
+        boost::sort(_sstables, [] (const sstables::shared_sstable& a, const sstables::shared_sstable& b) {
+            return a->get_stats_metadata().max_timestamp > b->get_stats_metadata().max_timestamp;
+        });
+    }
+    virtual future<> fill_buffer(db::timeout_clock::time_point timeout) override {
+        if (_end_of_stream) {
+            return make_ready_future<>();
+        }
+        return ensure_reader(timeout).then([this, timeout] {
+            return _reader->fill_buffer(timeout).then([this] {
+                _end_of_stream = _reader->is_end_of_stream();
+                _reader->move_buffer_content_to(*this);
+            });
+        });
+    }
+    virtual void next_partition() override {
+        clear_buffer_to_next_partition();
+        if (!is_buffer_empty()) {
+            return;
+        }
+        if (!_reader) {
+            // Nothing has been read yet, so the only partition is skipped as a whole.
+            _sstables.clear();
+            _reader = make_empty_flat_reader(_schema);
+            _end_of_stream = true;
+            return;
+        }
+        _reader->next_partition();
+        _end_of_stream = _reader->is_end_of_stream() && _reader->is_buffer_empty();
+    }
+    virtual future<> fast_forward_to(position_range pr, db::timeout_clock::time_point timeout) override {
+        _end_of_stream = false;
+        forward_buffer_to(pr.start());
+        return ensure_reader(timeout).then([this, pr = std::move(pr), timeout] () mutable {
+            return _reader->fast_forward_to(std::move(pr), timeout);
+        });
+    }
+    virtual future<> fast_forward_to(const dht::partition_range& pr, db::timeout_clock::time_point timeout) override {
+        _end_of_stream = false;
+        clear_buffer();
+        return ensure_reader(timeout).then([this, &pr, timeout] {
+            return _reader->fast_forward_to(pr, timeout);
+        });
+    }
+    virtual size_t buffer_size() const override {
+        return flat_mutation_reader::impl::buffer_size() + (_reader ? _reader->buffer_size() : 0);
+    }
+};
+
+// Returns the clustering key of the only row a read of the partition with the
+// given slice can return, if the read can stop early on sstable timestamps, see
+// timestamp_ordered_single_row_reader.
+static std::optional<clustering_key>
+single_row_read_key(const schema& s, const query::partition_slice& slice, const partition_key& pk) {
+    if (s.is_counter() || s.is_view() || slice.options.contains(query::partition_slice::option::reversed)) {
+        return std::nullopt;
+    }
+    auto atomic = [] (const column_definition& cdef) { return cdef.is_atomic(); };
+    if (!boost::algorithm::all_of(s.regular_columns(), atomic) || !boost::algorithm::all_of(s.static_columns(), atomic)) {
+        return std::nullopt;
+    }
+    if (!s.clustering_key_size()) {
+        return clustering_key::make_empty();
+    }
+    auto& ranges = slice.row_ranges(s, pk);
+    if (ranges.size() != 1 || !ranges.front().is_singular() || !ranges.front().start()->value().is_full(s)) {
+        return std::nullopt;
+    }
+    return clustering_key(ranges.front().start()->value());
+}
+
 static flat_mutation_reader
 create_single_key_sstable_reader(column_family* cf,
                                  schema_ptr schema,
@@ -288,8 +584,15 @@ create_single_key_sstable_reader(column_family* cf,
                                  mutation_reader::forwarding fwd_mr)
 {
     auto key = sstables::key::from_partition_key(*schema, *pr.start()->value().key());
+    auto selected = filter_sstable_for_reader(sstables->select(pr), *cf, schema, pr, key, slice);
+    if (selected.size() > 1) {
+        if (auto ck = single_row_read_key(*schema, slice, *pr.start()->value().key())) {
+            return make_flat_mutation_reader<timestamp_ordered_single_row_reader>(std::move(schema), std::move(selected), pr, slice, pc,
+                    resource_tracker, std::move(trace_state), std::move(*ck), fwd, *cf->cf_stats(), sstable_histogram);
+        }
+    }
     auto readers = boost::copy_range<std::vector<flat_mutation_reader>>(
-        filter_sstable_for_reader(sstables->select(pr), *cf, schema, pr, key, slice)
+        selected
         | boost::adaptors::transformed([&] (const sstables::shared_sstable& sstable) {
             tracing::trace(trace_state, "Reading key {} from sstable {}", pr, seastar::value_of([&sstable] { return sstable->get_filename(); }));
             return sstable->read_row_flat(schema, pr.start()->value(), slice, pc, resource_tracker, trace_state, fwd);
@@ -298,6 +601,10 @@ create_single_key_sstable_reader(column_family* cf,
     if (readers.empty()) {
         return make_empty_flat_reader(schema);
     }
+    if (readers.size() > 1) {
+        return make_flat_mutation_reader<partition_tombstone_filtering_reader>(std::move(schema), std::move(selected), std::move(readers),
+                fwd, fwd_mr, *cf->cf_stats(), sstable_histogram);
+    }
     sstable_histogram.add(readers.size());
     return make_combined_reader(schema, std::move(readers), fwd, fwd_mr);
 }
@@ -326,6 +633,29 @@ flat_mutation_reader make_range_sstable_reader(schema_ptr s,
             fwd_mr);
 }
 
+// Estimates the cost of admitting an sstable read.
+// Single partition reads are short reads. Their cost grows with the number
+// of clustering ranges they read, each needing its own index lookup and
+// buffers. Range scans are long reads. Their cost grows with the number of
+// sstables they may read from concurrently, discounted by the expected cache
+// hit rate, since data served from cache never reaches the sstables.
+static reader_concurrency_semaphore::admission_cost
+estimate_read_admission_cost(const schema& s, const dht::partition_range& pr, const query::partition_slice& slice,
+        size_t sstable_count, cache_temperature hit_rate) {
+    using semaphore = reader_concurrency_semaphore;
+    static constexpr size_t max_ranges_accounted = 4;
+    static constexpr size_t max_sstables_accounted = 16;
+    if (pr.is_singular() && pr.start()->value().has_key()) {
+        auto& key = *pr.start()->value().key();
+        auto ranges = std::clamp(slice.row_ranges(s, key).size(), size_t(1), max_ranges_accounted);
+        return {semaphore::new_reader_base_cost * ssize_t(ranges), semaphore::read_class::short_read};
+    }
+    auto sstables = std::clamp(sstable_count, size_t(1), max_sstables_accounted);
+    auto miss_rate = 1.0f - std::clamp(float(hit_rate), 0.0f, 1.0f);
+    auto memory = std::max(semaphore::new_reader_base_cost, ssize_t(semaphore::new_reader_base_cost * sstables * miss_rate));
+    return {memory, semaphore::read_class::long_read};
+}
+
 flat_mutation_reader
 table::make_sstable_reader(schema_ptr s,
                                    lw_shared_ptr<sstables::sstable_set> sstables,
@@ -338,6 +668,15 @@ table::make_sstable_reader(schema_ptr s,
     auto* semaphore = service::get_local_streaming_read_priority().id() == pc.id()
         ? _config.streaming_read_concurrency_semaphore
         : _config.read_concurrency_semaphore;
+    if (_config.service_level_read_concurrency_semaphores) {
+        auto it = _config.service_level_read_concurrency_semaphores->find(pc.id());
+        if (it != _config.service_level_read_concurrency_semaphores->end()) {
+            semaphore = it->second.get();
+        }
+    }
+    auto cost = semaphore
+        ? estimate_read_admission_cost(*s, pr, slice, sstables->all()->size(), _global_cache_hit_rate)
+        : reader_concurrency_semaphore::admission_cost{};
 
     // CAVEAT: if make_sstable_reader() is called on a single partition
     // we want to optimize and read exactly this partition. As a
@@ -389,7 +728,8 @@ table::make_sstable_reader(schema_ptr s,
     }();
 
     if (semaphore) {
-        return make_restricted_flat_reader(*semaphore, std::move(ms), std::move(s), pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
+        return make_restricted_flat_reader(*semaphore, std::move(ms), std::move(s), pr, slice, pc, std::move(trace_state), fwd, fwd_mr, cost,
+                &_stats.estimated_replica_admission);
     } else {
         return ms.make_reader(std::move(s), pr, slice, pc, std::move(trace_state), fwd, fwd_mr);
     }
@@ -712,11 +1052,15 @@ table::add_sstable_and_update_cache(sstables::shared_sstable sst) {
 }
 
 future<>
-table::update_cache(lw_shared_ptr<memtable> m, sstables::shared_sstable sst) {
-    auto adder = [this, m, sst] {
-        auto newtab_ms = sst->as_mutation_source();
-        add_sstable(sst, {engine().cpu_id()});
-        m->mark_flushed(std::move(newtab_ms));
+table::update_cache(lw_shared_ptr<memtable> m, std::vector<sstables::shared_sstable> ssts) {
+    auto adder = [this, m, ssts = std::move(ssts)] {
+        std::vector<mutation_source> sources;
+        sources.reserve(ssts.size());
+        for (auto& sst : ssts) {
+            sources.push_back(sst->as_mutation_source());
+            add_sstable(sst, {engine().cpu_id()});
+        }
+        m->mark_flushed(sources.size() == 1 ? std::move(sources.front()) : make_combined_mutation_source(std::move(sources)));
         try_trigger_compaction();
     };
     if (_config.enable_cache) {
@@ -956,10 +1300,17 @@ table::seal_active_memtable(flush_permit&& permit) {
 future<stop_iteration>
 table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_permit&& permit) {
   return with_scheduling_group(_config.memtable_scheduling_group, [this, old = std::move(old), permit = std::move(permit)] () mutable {
-    auto newtab = make_sstable();
+    // A large memtable is flushed into a run of sstables split by token
+    // range and written concurrently, so that the flush isn't limited by
+    // how fast a single writer can serialize the whole memtable.
+    unsigned splits = 1;
+    if (_config.memtable_flush_split_size) {
+        splits = std::clamp<size_t>(old->occupancy().used_space() / _config.memtable_flush_split_size, 1, max_memtable_flush_splits);
+    }
+    auto ranges = make_lw_shared<dht::partition_range_vector>(old->split_for_flush(splits));
+    auto run_id = utils::make_random_uuid();
+    auto estimated_partitions = old->partition_count() / ranges->size() + 1;
 
-    newtab->set_unshared();
-    tlogger.debug("Flushing to {}", newtab->get_filename());
     // Note that due to our sharded architecture, it is possible that
     // in the face of a value change some shards will backup sstables
     // while others won't.
@@ -971,35 +1322,55 @@ table::try_flush_memtable_to_sstable(lw_shared_ptr<memtable> old, sstable_write_
     //
     // The code as is guarantees that we'll never partially backup a
     // single sstable, so that is enough of a guarantee.
-    database_sstable_write_monitor monitor(std::move(permit), newtab, _compaction_manager, _compaction_strategy, old->get_max_timestamp());
-    return do_with(std::move(monitor), [this, old, newtab] (auto& monitor) {
-        auto&& priority = service::get_local_memtable_flush_priority();
-        auto f = write_memtable_to_sstable(*old, newtab, monitor, incremental_backups_enabled(), priority, false);
-        // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
-        // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
-        // priority inversion.
-        return with_scheduling_group(default_scheduling_group(), [this, &monitor, old = std::move(old), newtab = std::move(newtab), f = std::move(f)] () mutable {
-            return f.then([this, newtab, old, &monitor] {
-                return newtab->open_data().then([this, old, newtab] () {
-                    tlogger.debug("Flushing to {} done", newtab->get_filename());
-                    return with_scheduling_group(_config.memtable_to_cache_scheduling_group, [this, old, newtab] {
-                        return update_cache(old, newtab);
-                    });
-                }).then([this, old, newtab] () noexcept {
-                    _memtables->erase(old);
-                    tlogger.debug("Memtable for {} replaced", newtab->get_filename());
-                    return stop_iteration::yes;
+    auto backup = incremental_backups_enabled();
+    std::vector<sstables::shared_sstable> newtabs;
+    // Monitors are referenced by the writers, so they must not move.
+    auto monitors = make_lw_shared<std::deque<database_sstable_write_monitor>>();
+    for (size_t i = 0; i < ranges->size(); ++i) {
+        auto newtab = make_sstable();
+        newtab->set_unshared();
+        tlogger.debug("Flushing to {}", newtab->get_filename());
+        // Only the first writer holds the write permit. The next memtable
+        // flush may start once it has written its data, overlapping with
+        // the sealing of this one.
+        monitors->emplace_back(i ? sstable_write_permit::unconditional() : std::move(permit), newtab,
+                _compaction_manager, _compaction_strategy, old->get_max_timestamp());
+        newtabs.push_back(std::move(newtab));
+    }
+    auto&& priority = service::get_local_memtable_flush_priority();
+    auto f = parallel_for_each(boost::irange<size_t>(0, ranges->size()), [&] (size_t i) {
+        return write_memtable_to_sstable(*old, newtabs[i], (*monitors)[i], (*ranges)[i], estimated_partitions, run_id, backup, priority);
+    });
+    // Switch back to default scheduling group for post-flush actions, to avoid them being staved by the memtable flush
+    // controller. Cache update does not affect the input of the memtable cpu controller, so it can be subject to
+    // priority inversion.
+    return with_scheduling_group(default_scheduling_group(), [this, monitors, ranges, old = std::move(old), newtabs = std::move(newtabs), f = std::move(f)] () mutable {
+        return f.then([this, newtabs, old] {
+            return parallel_for_each(newtabs, [] (const sstables::shared_sstable& newtab) {
+                return newtab->open_data();
+            }).then([this, old, newtabs] () {
+                tlogger.debug("Flushing to {} done", newtabs.front()->get_filename());
+                return with_scheduling_group(_config.memtable_to_cache_scheduling_group, [this, old, newtabs] {
+                    return update_cache(old, newtabs);
                 });
-            }).handle_exception([this, old, newtab, &monitor] (auto e) {
+            }).then([this, old, newtabs] () noexcept {
+                _memtables->erase(old);
+                tlogger.debug("Memtable for {} replaced", newtabs.front()->get_filename());
+                return stop_iteration::yes;
+            });
+        }).handle_exception([this, old, newtabs, monitors, ranges] (auto e) {
+            for (auto& monitor : *monitors) {
                 monitor.write_failed();
+            }
+            for (auto& newtab : newtabs) {
                 newtab->mark_for_deletion();
-                _config.cf_stats->failed_memtables_flushes_count++;
-                tlogger.error("failed to write sstable {}: {}", newtab->get_filename(), e);
-                // If we failed this write we will try the write again and that will create a new flush reader
-                // that will decrease dirty memory again. So we need to reset the accounting.
-                old->revert_flushed_memory();
-                return stop_iteration(_async_gate.is_closed());
-            });
+            }
+            _config.cf_stats->failed_memtables_flushes_count++;
+            tlogger.error("failed to write sstable {}: {}", newtabs.front()->get_filename(), e);
+            // If we failed this write we will try the write again and that will create a new flush reader
+            // that will decrease dirty memory again. So we need to reset the accounting.
+            old->revert_flushed_memory();
+            return stop_iteration(_async_gate.is_closed());
         });
     });
   });
@@ -1089,6 +1460,30 @@ table::reshuffle_sstables(std::set<int64_t> all_generations, int64_t start) {
 
 seastar::metrics::label column_family_label("cf");
 seastar::metrics::label keyspace_label("ks");
+seastar::metrics::label query_phase_label("phase");
+sstables::compression::read_stats table::compression_read_stats() const {
+    sstables::compression::read_stats ret;
+    for (auto& sst : *_sstables->all()) {
+        ret += sst->get_compression().stats;
+    }
+    return ret;
+}
+
+const sstables::compression::read_stats& table::cached_compression_read_stats() const {
+    if (lowres_clock::now() - _compression_read_stats_cache_timestamp > 1s) {
+        _compression_read_stats_cache_timestamp = lowres_clock::now();
+        _cached_compression_read_stats = compression_read_stats();
+    }
+    return _cached_compression_read_stats;
+}
+
+std::optional<int32_t> table::auto_compression_chunk_length() const {
+    if (!_config.compression_auto_chunk_length || !_schema->get_compressor_params().get_compressor()) {
+        return std::nullopt;
+    }
+    return sstables::chunk_length_for_reads(compression_read_stats());
+}
+
 void table::set_metrics() {
     auto cf = column_family_label(_schema->cf_name());
     auto ks = keyspace_label(_schema->ks_name());
@@ -1104,7 +1499,17 @@ void table::set_metrics() {
                 ms::make_gauge("live_disk_space", ms::description("Live disk space used"), _stats.live_disk_space_used)(cf)(ks),
                 ms::make_gauge("total_disk_space", ms::description("Total disk space used"), _stats.total_disk_space_used)(cf)(ks),
                 ms::make_gauge("live_sstable", ms::description("Live sstable count"), _stats.live_sstable_count)(cf)(ks),
-                ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks)
+                ms::make_gauge("pending_compaction", ms::description("Estimated number of compactions pending for this column family"), _stats.pending_compactions)(cf)(ks),
+                ms::make_gauge("compression_read_requested_bytes", ms::description("Uncompressed bytes reads asked for from the compressed data files of the live sstables"),
+                        [this] { return cached_compression_read_stats().requested_bytes; })(cf)(ks),
+                ms::make_gauge("compression_read_decompressed_bytes", ms::description("Bytes decompressed by reads of the live sstables"),
+                        [this] { return cached_compression_read_stats().decompressed_bytes; })(cf)(ks),
+                ms::make_gauge("compression_read_wasted_bytes", ms::description("Bytes decompressed by reads of the live sstables outside of the range they asked for"),
+                        [this] { return cached_compression_read_stats().wasted_bytes; })(cf)(ks),
+                ms::make_gauge("compression_read_decompression_time", ms::description("Time spent decompressing chunks of the live sstables, in nanoseconds"),
+                        [this] { return cached_compression_read_stats().decompression_ns; })(cf)(ks),
+                ms::make_gauge("compression_read_median_consumed_bytes", ms::description("Median of the bytes consumed by user single partition reads of the live sstables, rounded up to a power of two"),
+                        [this] { return cached_compression_read_stats().median_consumed_bytes(); })(cf)(ks)
         });
 
         // Metrics related to row locking
@@ -1129,6 +1534,8 @@ void table::set_metrics() {
                     ms::make_total_operations("view_updates_pushed_local", _view_stats.view_updates_pushed_local, ms::description("Number of updates (mutations) pushed to local view replicas"))(cf)(ks),
                     ms::make_total_operations("view_updates_failed_local", _view_stats.view_updates_failed_local, ms::description("Number of updates (mutations) that failed to be pushed to local view replicas"))(cf)(ks),
                     ms::make_gauge("view_updates_pending", ms::description("Number of updates pushed to view and are still to be completed"), _view_stats.writes)(cf)(ks),
+                    ms::make_total_operations("view_update_base_reads", _view_stats.view_update_base_reads, ms::description("Number of base writes which read existing base rows to generate view updates"))(cf)(ks),
+                    ms::make_total_operations("view_update_base_reads_coalesced", _view_stats.view_update_base_reads_coalesced, ms::description("Number of base writes which shared the read of existing base rows with other writes to the same partition"))(cf)(ks),
             });
         }
 
@@ -1141,6 +1548,20 @@ void table::set_metrics() {
                     ms::make_histogram("cas_commit_latency", ms::description("CAS commit round latency histogram"), [this] {return _stats.estimated_cas_commit.get_histogram(std::chrono::microseconds(100));})(cf)(ks),
                     ms::make_gauge("cache_hit_rate", ms::description("Cache hit rate"), [this] {return float(_global_cache_hit_rate);})(cf)(ks)
             });
+            for (size_t i = 0; i < _stats.estimated_query_phases.size(); ++i) {
+                _metrics.add_group("column_family", {
+                        ms::make_histogram("query_phase_latency", ms::description("Histogram of the time CQL requests spend in a given phase of their processing"),
+                                [this, i] {return _stats.estimated_query_phases[i].get_histogram(std::chrono::microseconds(10));})(cf)(ks)(query_phase_label(tracing::to_string(tracing::query_phase(i)))),
+                });
+            }
+            _metrics.add_group("column_family", {
+                    ms::make_histogram("query_phase_latency", ms::description("Histogram of the time CQL requests spend in a given phase of their processing"),
+                            [this] {return _stats.estimated_replica_memory_wait.get_histogram(std::chrono::microseconds(10));})(cf)(ks)(query_phase_label("replica_memory_wait")),
+                    ms::make_histogram("query_phase_latency", ms::description("Histogram of the time CQL requests spend in a given phase of their processing"),
+                            [this] {return _stats.estimated_replica_admission.get_histogram(std::chrono::microseconds(10));})(cf)(ks)(query_phase_label("replica_admission")),
+                    ms::make_histogram("query_phase_latency", ms::description("Histogram of the time CQL requests spend in a given phase of their processing"),
+                            [this] {return _stats.estimated_replica_read.get_histogram(std::chrono::microseconds(10));})(cf)(ks)(query_phase_label("replica_read")),
+            });
         }
     }
 }
@@ -2099,12 +2520,16 @@ future<> table::generate_and_propagate_view_updates(const schema_ptr& base,
             std::move(views),
             flat_mutation_reader_from_mutations({std::move(m)}),
             std::move(existings)).then([this, base_token = std::move(base_token)] (std::vector<frozen_mutation_and_schema>&& updates) mutable {
-        auto units = seastar::consume_units(*_config.view_update_concurrency_semaphore, memory_usage_of(updates));
-        //FIXME: discarded future.
-        (void)db::view::mutate_MV(std::move(base_token), std::move(updates), _view_stats, *_config.cf_stats, std::move(units)).handle_exception([] (auto ignored) { });
+        propagate_view_updates(std::move(base_token), std::move(updates));
     });
 }
 
+void table::propagate_view_updates(dht::token base_token, std::vector<frozen_mutation_and_schema>&& updates) const {
+    auto units = seastar::consume_units(*_config.view_update_concurrency_semaphore, memory_usage_of(updates));
+    //FIXME: discarded future.
+    (void)db::view::mutate_MV(std::move(base_token), std::move(updates), _view_stats, *_config.cf_stats, std::move(units)).handle_exception([] (auto ignored) { });
+}
+
 /**
  * Shard-local locking of clustering rows or entire partitions of the base
  * table during a Materialized-View read-modify-update:
@@ -2258,6 +2683,7 @@ table::cache_hit_rate table::get_hit_rate(gms::inet_address addr) {
 
 void table::drop_hit_rate(gms::inet_address addr) {
     _cluster_cache_hit_rates.erase(addr);
+    _replica_read_latencies.erase(addr);
 }
 
 void table::apply_streaming_mutation(schema_ptr m_schema, utils::UUID plan_id, const frozen_mutation& m, bool fragmented) {
@@ -2335,6 +2761,22 @@ write_memtable_to_sstable(memtable& mt, sstables::shared_sstable sst,
         mt.schema(), cfg, mt.get_encoding_stats(), pc);
 }
 
+future<>
+write_memtable_to_sstable(memtable& mt, sstables::shared_sstable sst,
+                          sstables::write_monitor& monitor,
+                          const dht::partition_range& range,
+                          uint64_t estimated_partitions,
+                          utils::UUID run_id,
+                          bool backup, const io_priority_class& pc) {
+    sstables::sstable_writer_config cfg;
+    cfg.replay_position = mt.replay_position();
+    cfg.backup = backup;
+    cfg.monitor = &monitor;
+    cfg.run_identifier = run_id;
+    return sst->write_components(mt.make_flush_reader(mt.schema(), pc, range), estimated_partitions,
+        mt.schema(), cfg, mt.get_encoding_stats(), pc);
+}
+
 future<>
 write_memtable_to_sstable(memtable& mt, sstables::shared_sstable sst) {
     return do_with(permit_monitor(sstable_write_permit::unconditional()), [&mt, sst] (auto& monitor) {
@@ -2388,17 +2830,21 @@ table::query(schema_ptr s,
         query::querier_cache_context cache_ctx) {
     utils::latency_counter lc;
     _stats.reads.set_latency(lc);
+    auto memory_wait_start = tracing::query_profile::clock::now();
     auto f = opts.request == query::result_request::only_digest
              ? memory_limiter.new_digest_read(max_size) : memory_limiter.new_data_read(max_size);
-    return f.then([this, lc, s = std::move(s), &cmd, opts, &partition_ranges,
+    return f.then([this, lc, s = std::move(s), &cmd, opts, &partition_ranges, memory_wait_start,
             trace_state = std::move(trace_state), timeout, cache_ctx = std::move(cache_ctx)] (query::result_memory_accounter accounter) mutable {
+        auto read_start = tracing::query_profile::clock::now();
+        _stats.estimated_replica_memory_wait.add(std::chrono::duration_cast<std::chrono::microseconds>(read_start - memory_wait_start).count());
         auto qs_ptr = std::make_unique<query_state>(std::move(s), cmd, opts, partition_ranges, std::move(accounter));
         auto& qs = *qs_ptr;
         return do_until(std::bind(&query_state::done, &qs), [this, &qs, trace_state = std::move(trace_state), timeout, cache_ctx = std::move(cache_ctx)] {
             auto&& range = *qs.current_partition_range++;
             return data_query(qs.schema, as_mutation_source(), range, qs.cmd.slice, qs.remaining_rows(),
                               qs.remaining_partitions(), qs.cmd.timestamp, qs.builder, trace_state, timeout, cache_ctx);
-        }).then([qs_ptr = std::move(qs_ptr), &qs] {
+        }).then([this, qs_ptr = std::move(qs_ptr), &qs, read_start] {
+            _stats.estimated_replica_read.add(std::chrono::duration_cast<std::chrono::microseconds>(tracing::query_profile::clock::now() - read_start).count());
             return make_ready_future<lw_shared_ptr<query::result>>(
                     make_lw_shared<query::result>(qs.builder.build()));
         }).finally([lc, this]() mutable {
@@ -2427,6 +2873,14 @@ void table::add_coordinator_read_latency(utils::estimated_histogram::duration la
     _stats.estimated_coordinator_read.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
 }
 
+void table::add_query_profile(const tracing::query_profile& profile) {
+    for (size_t i = 0; i < _stats.estimated_query_phases.size(); ++i) {
+        if (profile.has(tracing::query_phase(i))) {
+            _stats.estimated_query_phases[i].add(std::chrono::duration_cast<std::chrono::microseconds>(profile.get(tracing::query_phase(i))).count());
+        }
+    }
+}
+
 std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double percentile) {
     if (_cached_percentile != percentile || lowres_clock::now() - _percentile_cache_timestamp > 1s) {
         _percentile_cache_timestamp = lowres_clock::now();
@@ -2437,6 +2891,44 @@ std::chrono::milliseconds table::get_coordinator_read_latency_percentile(double
     return _percentile_cache_value;
 }
 
+void table::add_replica_read_latency(gms::inet_address addr, replica_read_kind kind, utils::estimated_histogram::duration latency) {
+    _replica_read_latencies[addr][size_t(kind)].histogram.add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+}
+
+std::optional<std::chrono::microseconds> table::get_replica_read_latency_percentile(gms::inet_address addr, replica_read_kind kind, double percentile) {
+    // Too few samples make for a poor estimation, let the caller fall back to the table-wide one.
+    static constexpr int64_t min_samples = 16;
+    auto it = _replica_read_latencies.find(addr);
+    if (it == _replica_read_latencies.end()) {
+        return std::nullopt;
+    }
+    auto& rl = it->second[size_t(kind)];
+    if (rl.cached_percentile != percentile || lowres_clock::now() - rl.percentile_cache_timestamp > 1s) {
+        if (rl.histogram.count() < min_samples) {
+            return std::nullopt;
+        }
+        rl.percentile_cache_timestamp = lowres_clock::now();
+        rl.cached_percentile = percentile;
+        rl.percentile_cache_value = std::chrono::microseconds(std::max(rl.histogram.percentile(percentile), int64_t(1)));
+        rl.histogram *= 0.9; // decay values a little to give new data points more weight
+    }
+    return rl.percentile_cache_value;
+}
+
+std::optional<std::chrono::microseconds> table::estimate_replica_read_latency(gms::inet_address addr, replica_read_kind kind, double percentile) {
+    auto latency = get_replica_read_latency_percentile(addr, kind, percentile);
+    if (!latency) {
+        return std::nullopt;
+    }
+    float hit_rate = float(get_hit_rate(addr).rate);
+    if (hit_rate < 0) {
+        // The replica doesn't report its hit rate.
+        return latency;
+    }
+    hit_rate = std::min(hit_rate, 1.0f);
+    return std::chrono::duration_cast<std::chrono::microseconds>(*latency * (2.0f - hit_rate));
+}
+
 future<>
 table::run_with_compaction_disabled(std::function<future<> ()> func) {
     ++_compaction_disabled;
@@ -2507,7 +2999,76 @@ future<row_locker::lock_holder> table::push_view_replica_updates(const schema_pt
     return push_view_replica_updates(s, std::move(m), timeout);
 }
 
-future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source, const io_priority_class& io_priority) const {
+// We read the whole set of regular columns in case the update now causes a base row to pass
+// a view's filters, and a view happens to include columns that have no value in this update.
+// Also, one of those columns can determine the lifetime of the base row, if it has a TTL.
+static query::partition_slice make_view_update_read_slice(const schema& base, query::clustering_row_ranges ranges) {
+    auto columns = boost::copy_range<query::column_id_vector>(
+            base.regular_columns() | boost::adaptors::transformed(std::mem_fn(&column_definition::id)));
+    query::partition_slice::option_set opts;
+    opts.set(query::partition_slice::option::send_partition_key);
+    opts.set(query::partition_slice::option::send_clustering_key);
+    opts.set(query::partition_slice::option::send_timestamp);
+    opts.set(query::partition_slice::option::send_ttl);
+    return query::partition_slice(
+            std::move(ranges), { }, std::move(columns), std::move(opts), { }, cql_serialization_format::internal(), query::max_rows);
+}
+
+/**
+ * Adds the rows in `ranges`, which the caller must have locked, to the read of
+ * the open batch for `key`, opening one if there is none.
+ *
+ * A batch accepts members until the reactor gets to run the read, so writes
+ * which acquired their locks in the meantime share it. Members lock distinct
+ * rows of the partition (see local_base_lock()), and the read happens while
+ * they all hold their locks, so each member sees its rows as if it read them
+ * on its own. The read is bounded by the latest of the members' timeouts,
+ * each member waits for it until its own.
+ */
+lw_shared_ptr<table::view_update_read_batch> table::join_view_update_read_batch(const schema_ptr& base, const dht::decorated_key& key,
+        const query::clustering_row_ranges& ranges, db::timeout_clock::time_point timeout) const {
+    ++_view_stats.view_update_base_reads;
+    auto [begin, end] = _view_update_read_batches.equal_range(key.token());
+    auto it = std::find_if(begin, end, [&] (auto& e) { return e.second->key.equal(*base, key); });
+    if (it != end) {
+        auto& batch = it->second;
+        ++_view_stats.view_update_base_reads_coalesced;
+        batch->ranges.insert(batch->ranges.end(), ranges.begin(), ranges.end());
+        batch->timeout = std::max(batch->timeout, timeout);
+        ++batch->pending;
+        return batch;
+    }
+    auto batch = make_lw_shared<view_update_read_batch>(key);
+    batch->ranges = ranges;
+    batch->timeout = timeout;
+    batch->pending = 1;
+    _view_update_read_batches.emplace(key.token(), batch);
+    // Let the writes that are ready to run join before reading.
+    (void)later().then([this, base, batch] {
+        auto [begin, end] = _view_update_read_batches.equal_range(batch->key.token());
+        _view_update_read_batches.erase(std::find_if(begin, end, [&] (auto& e) { return e.second == batch; }));
+        auto ranges = query::clustering_range::deoverlap(std::move(batch->ranges), clustering_key::tri_compare(*base));
+        return do_with(dht::partition_range::make_singular(batch->key), make_view_update_read_slice(*base, std::move(ranges)),
+                [this, base, timeout = batch->timeout] (auto& pr, auto& slice) {
+            auto reader = as_mutation_source().make_reader(base, pr, slice, service::get_local_sstable_query_read_priority(), nullptr,
+                    streamed_mutation::forwarding::no, mutation_reader::forwarding::no);
+            return do_with(std::move(reader), [timeout] (flat_mutation_reader& reader) {
+                return read_mutation_from_flat_mutation_reader(reader, timeout);
+            });
+        }).then_wrapped([batch] (future<mutation_opt> f) {
+            if (f.failed()) {
+                batch->existing.set_exception(f.get_exception());
+                return;
+            }
+            auto mo = f.get0();
+            batch->existing.set_value(mo ? make_lw_shared<const mutation>(std::move(*mo)) : nullptr);
+        });
+    });
+    return batch;
+}
+
+future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, mutation_source&& source,
+        const io_priority_class& io_priority, bool coalesce_reads) const {
     if (!_config.view_update_concurrency_semaphore->current()) {
         // We don't have resources to generate view updates for this write. If we reached this point, we failed to
         // throttle the client. The memory queue is already full, waiting on the semaphore would cause this node to
@@ -2531,23 +3092,52 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema
                 return make_ready_future<row_locker::lock_holder>();
         });
     }
-    // We read the whole set of regular columns in case the update now causes a base row to pass
-    // a view's filters, and a view happens to include columns that have no value in this update.
-    // Also, one of those columns can determine the lifetime of the base row, if it has a TTL.
-    auto columns = boost::copy_range<query::column_id_vector>(
-            base->regular_columns() | boost::adaptors::transformed(std::mem_fn(&column_definition::id)));
-    query::partition_slice::option_set opts;
-    opts.set(query::partition_slice::option::send_partition_key);
-    opts.set(query::partition_slice::option::send_clustering_key);
-    opts.set(query::partition_slice::option::send_timestamp);
-    opts.set(query::partition_slice::option::send_ttl);
-    auto slice = query::partition_slice(
-            std::move(cr_ranges), { }, std::move(columns), std::move(opts), { }, cql_serialization_format::internal(), query::max_rows);
     // Take the shard-local lock on the base-table row or partition as needed.
     // We'll return this lock to the caller, which will release it after
     // writing the base-table update.
-    future<row_locker::lock_holder> lockf = local_base_lock(base, m.decorated_key(), slice.default_row_ranges(), timeout);
+    future<row_locker::lock_holder> lockf = local_base_lock(base, m.decorated_key(), cr_ranges, timeout);
+    if (coalesce_reads) {
+        return lockf.then([this, m = std::move(m), cr_ranges = std::move(cr_ranges), views = std::move(views), base, timeout] (row_locker::lock_holder lock) mutable {
+            auto batch = join_view_update_read_batch(base, m.decorated_key(), cr_ranges, timeout);
+            auto base_token = m.token();
+            return batch->existing.get_shared_future(timeout).then([this, base, views = std::move(views), m = std::move(m), cr_ranges = std::move(cr_ranges)] (
+                    lw_shared_ptr<const mutation> existing) mutable {
+                auto existings = existing
+                        ? flat_mutation_reader_from_mutations({existing->sliced(cr_ranges)})
+                        : make_empty_flat_reader(base);
+                return db::view::generate_view_updates(base, std::move(views), flat_mutation_reader_from_mutations({std::move(m)}), std::move(existings));
+            }).then_wrapped([this, batch, base_token = std::move(base_token), timeout] (future<std::vector<frozen_mutation_and_schema>> f) mutable {
+                std::exception_ptr ep;
+                if (f.failed()) {
+                    ep = f.get_exception();
+                } else {
+                    auto updates = f.get0();
+                    std::move(updates.begin(), updates.end(), std::back_inserter(batch->updates));
+                }
+                // The last member to finish sends the updates of the whole batch.
+                if (--batch->pending == 0) {
+                    if (!batch->updates.empty()) {
+                        propagate_view_updates(std::move(base_token), db::view::merge_view_updates(std::move(batch->updates)));
+                    }
+                    batch->propagated.set_value();
+                }
+                if (ep) {
+                    return make_exception_future<>(std::move(ep));
+                }
+                // Keep our rows locked until our updates are sent, like a
+                // write which read on its own does.
+                return batch->propagated.get_shared_future(timeout);
+            }).then([lock = std::move(lock)] () mutable {
+                // return the local partition/row lock we have taken so it
+                // remains locked until the caller is done modifying this
+                // partition/row and destroys the lock object.
+                return std::move(lock);
+            });
+        });
+    }
+    auto slice = make_view_update_read_slice(*base, std::move(cr_ranges));
     return lockf.then([m = std::move(m), slice = std::move(slice), views = std::move(views), base, this, timeout, source = std::move(source), &io_priority] (row_locker::lock_holder lock) {
+      ++_view_stats.view_update_base_reads;
       return do_with(
         dht::partition_range::make_singular(m.decorated_key()),
         std::move(slice),
@@ -2565,11 +3155,11 @@ future<row_locker::lock_holder> table::do_push_view_replica_updates(const schema
 }
 
 future<row_locker::lock_holder> table::push_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout) const {
-    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source(), service::get_local_sstable_query_read_priority());
+    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source(), service::get_local_sstable_query_read_priority(), true);
 }
 
 future<row_locker::lock_holder> table::stream_view_replica_updates(const schema_ptr& s, mutation&& m, db::timeout_clock::time_point timeout, sstables::shared_sstable excluded_sstable) const {
-    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source_excluding(std::move(excluded_sstable)), service::get_local_streaming_write_priority());
+    return do_push_view_replica_updates(s, std::move(m), timeout, as_mutation_source_excluding(std::move(excluded_sstable)), service::get_local_streaming_write_priority(), false);
 }
 
 mutation_source
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include "alternator/conditions.hh"
+#include "alternator/executor.hh"
+#include "alternator/serialization.hh"
+#include "collection_mutation.hh"
+#include "cql3/query_options.hh"
+#include "schema_builder.hh"
+#include "types/map.hh"
+
+using namespace alternator;
+
+static const std::vector<const char*> nested_values = {
+    R"({"L": [{"N": "1"}, {"S": "x"}, {"L": [{"BOOL": true}]}, {"NULL": true}]})",
+    R"({"M": {"b": {"N": "-2.5"}, "a": {"B": "AQI="}, "c": {"M": {"d": {"SS": ["e"]}}}}})",
+    R"({"SS": ["a", "b", "c"]})",
+    R"({"NS": ["1", "-2", "3.25"]})",
+    R"({"BS": ["AQI=", "AwQ="]})",
+    R"({"NULL": true})",
+};
+
+SEASTAR_THREAD_TEST_CASE(test_nested_values_round_trip) {
+    for (auto text : nested_values) {
+        auto value = rjson::parse(text);
+        auto as_json = serialize_item(value, nested_value_format::json);
+        auto encoded = serialize_item(value, nested_value_format::encoded);
+        BOOST_REQUIRE_EQUAL(int8_t(as_json[0]), int8_t(alternator_type::NOT_SUPPORTED_YET));
+        BOOST_REQUIRE_EQUAL(int8_t(encoded[0]), int8_t(alternator_type::ENCODED));
+        BOOST_REQUIRE(deserialize_item(as_json) == value);
+        BOOST_REQUIRE(deserialize_item(encoded) == value);
+        BOOST_REQUIRE(serialized_items_equal(as_json, encoded));
+        BOOST_REQUIRE(serialized_items_equal(encoded, as_json));
+    }
+    auto a = rjson::parse(nested_values[0]);
+    auto b = rjson::parse(nested_values[2]);
+    BOOST_REQUIRE(!serialized_items_equal(serialize_item(a, nested_value_format::json), serialize_item(b, nested_value_format::encoded)));
+    BOOST_REQUIRE(!serialized_items_equal(serialize_item(a, nested_value_format::encoded), serialize_item(b, nested_value_format::encoded)));
+}
+
+// An EQ filter on a nested value must match items written before the binary
+// encoding existed, whose values are stored as JSON.
+SEASTAR_THREAD_TEST_CASE(test_eq_filter_matches_json_serialized_item) {
+    auto attrs_type = map_type_impl::get_instance(utf8_type, bytes_type, true);
+    auto s = schema_builder("ks", "t")
+            .with_column("p", utf8_type, column_kind::partition_key)
+            .with_column(bytes(executor::ATTRS_COLUMN_NAME), attrs_type, column_kind::regular_column)
+            .build();
+    auto& attrs_col = *s->get_column_definition(bytes(executor::ATTRS_COLUMN_NAME));
+    auto pk = partition_key::from_single_value(*s, utf8_type->decompose("k"));
+    auto ck = clustering_key_prefix::make_empty();
+
+    auto make_row = [&] (bytes stored) {
+        collection_mutation_description mut;
+        mut.cells.emplace_back(utf8_type->decompose("a"), atomic_cell::make_live(*bytes_type, 0, stored, atomic_cell::collection_member::yes));
+        row r;
+        r.apply(attrs_col, atomic_cell_or_collection(mut.serialize(*attrs_type)));
+        return r;
+    };
+    auto matches = [&] (const char* filter_value, const row& r) {
+        auto filter = rjson::parse(format(R"({{"a": {{"ComparisonOperator": "EQ", "AttributeValueList": [{}]}}}})", filter_value));
+        auto restrictions = get_filtering_restrictions(s, attrs_col, filter);
+        auto& non_pk = restrictions->get_non_pk_restriction();
+        BOOST_REQUIRE_EQUAL(non_pk.size(), 1);
+        return non_pk.begin()->second->is_satisfied_by(*s, pk, ck, r, cql3::query_options::DEFAULT, gc_clock::now());
+    };
+
+    for (auto text : nested_values) {
+        auto value = rjson::parse(text);
+        auto old_row = make_row(serialize_item(value, nested_value_format::json));
+        auto new_row = make_row(serialize_item(value, nested_value_format::encoded));
+        BOOST_REQUIRE(matches(text, old_row));
+        BOOST_REQUIRE(matches(text, new_row));
+        BOOST_REQUIRE(!matches(R"({"SS": ["z"]})", old_row));
+        BOOST_REQUIRE(!matches(R"({"SS": ["z"]})", new_row));
+    }
+}
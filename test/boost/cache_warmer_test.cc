@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+#include "database.hh"
+#include "db/cache_warmer.hh"
+#include "db/config.hh"
+
+#include <seastar/core/byteorder.hh>
+#include <seastar/core/fstream.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/testing/test_case.hh>
+#include "test/lib/cql_test_env.hh"
+#include "test/lib/tmpdir.hh"
+
+static uint64_t cache_stat(cql_test_env& e, uint64_t cache_tracker::stats::*stat) {
+    return e.db().map_reduce0([stat] (database& db) {
+        return db.row_cache_tracker().get_stats().*stat;
+    }, uint64_t(0), std::plus<uint64_t>()).get0();
+}
+
+static void start_cache_warmer(sharded<db::cache_warmer>& cw, cql_test_env& e) {
+    cw.start(std::ref(e.db()), std::cref(e.local_db().get_config())).get();
+    cw.invoke_on_all(&db::cache_warmer::start).get();
+    cw.invoke_on_all(&db::cache_warmer::wait_until_warmed_up).get();
+}
+
+static void evict_cache(cql_test_env& e) {
+    e.db().invoke_on_all([] (database& db) {
+        db.find_column_family("ks", "t").get_row_cache().evict();
+    }).get();
+}
+
+SEASTAR_TEST_CASE(test_cache_warmer_saves_and_warms_up) {
+    return seastar::async([] {
+        tmpdir saved_caches;
+        cql_test_config cfg;
+        cfg.db_config->saved_caches_directory(saved_caches.path().string(), db::config::config_source::CommandLine);
+        cfg.db_config->row_cache_save_period(3600, db::config::config_source::CommandLine);
+        do_with_cql_env_thread([&saved_caches] (cql_test_env& e) {
+            e.execute_cql("create table t (p int primary key, v int)").get();
+            for (int i = 0; i < 100; ++i) {
+                e.execute_cql(format("insert into t (p, v) values ({:d}, {:d})", i, i)).get();
+            }
+            e.db().invoke_on_all([] (database& db) { return db.flush_all_memtables(); }).get();
+
+            auto saved_keys_file = (saved_caches.path() / "row_cache_keys.db").string();
+            auto read_hot_keys = [&] {
+                for (int i = 0; i < 10; ++i) {
+                    e.execute_cql(format("select v from t where p = {:d}", i)).get();
+                }
+            };
+
+            {
+                // Nothing to warm up yet. Stopping saves the hot keys.
+                sharded<db::cache_warmer> cw;
+                start_cache_warmer(cw, e);
+                for (int i = 0; i < 32; ++i) {
+                    read_hot_keys();
+                }
+                cw.stop().get();
+            }
+            BOOST_REQUIRE(file_exists(saved_keys_file).get0());
+
+            // A fresh instance, as after a restart, reads the saved keys back into the cache.
+            evict_cache(e);
+            {
+                sharded<db::cache_warmer> cw;
+                start_cache_warmer(cw, e);
+                auto hits = cache_stat(e, &cache_tracker::stats::partition_hits);
+                auto misses = cache_stat(e, &cache_tracker::stats::partition_misses);
+                read_hot_keys();
+                BOOST_REQUIRE_GT(cache_stat(e, &cache_tracker::stats::partition_hits) - hits, 0);
+                BOOST_REQUIRE_LT(cache_stat(e, &cache_tracker::stats::partition_misses) - misses, 10);
+                cw.stop().get();
+            }
+        }, cfg).get();
+    });
+}
+
+SEASTAR_TEST_CASE(test_cache_warmer_rejects_corrupt_file) {
+    return seastar::async([] {
+        tmpdir saved_caches;
+        cql_test_config cfg;
+        cfg.db_config->saved_caches_directory(saved_caches.path().string(), db::config::config_source::CommandLine);
+        cfg.db_config->row_cache_save_period(3600, db::config::config_source::CommandLine);
+        do_with_cql_env_thread([&saved_caches] (cql_test_env& e) {
+            e.execute_cql("create table t (p int primary key, v int)").get();
+            auto id = e.local_db().find_schema("ks", "t")->id();
+            auto saved_keys_file = (saved_caches.path() / "row_cache_keys.db").string();
+
+            // A record of table t with the given number of keys, whose first key has the given
+            // length and is followed by the given bytes.
+            auto write_saved_keys = [&] (uint32_t count, uint32_t len, bytes key) {
+                auto out = make_file_output_stream(open_file_dma(saved_keys_file,
+                        open_flags::wo | open_flags::create | open_flags::truncate).get0());
+                char buf[3 * sizeof(uint32_t) + 2 * sizeof(int64_t)];
+                auto p = buf;
+                write_be<uint32_t>(p, 1);
+                write_be<int64_t>(p += sizeof(uint32_t), id.get_most_significant_bits());
+                write_be<int64_t>(p += sizeof(int64_t), id.get_least_significant_bits());
+                write_be<uint32_t>(p += sizeof(int64_t), count);
+                write_be<uint32_t>(p += sizeof(uint32_t), len);
+                out.write(buf, sizeof(buf)).get();
+                out.write(reinterpret_cast<const char*>(key.data()), key.size()).get();
+                out.close().get();
+            };
+            auto warm_up = [&] {
+                sharded<db::cache_warmer> cw;
+                start_cache_warmer(cw, e);
+                auto sum = [&cw] (uint64_t (db::cache_warmer::*stat)() const) {
+                    return cw.map_reduce0([stat] (db::cache_warmer& w) { return (w.*stat)(); }, uint64_t(0), std::plus<uint64_t>()).get0();
+                };
+                auto stats = std::make_pair(sum(&db::cache_warmer::keys_to_warm), sum(&db::cache_warmer::keys_warmed));
+                cw.stop().get();
+                return stats;
+            };
+
+            // The warm-up gives up on each of them without reading the bogus amounts.
+            for (auto [count, len] : {std::pair<uint32_t, uint32_t>(std::numeric_limits<uint32_t>::max(), 4),
+                                      std::pair<uint32_t, uint32_t>(1, std::numeric_limits<uint32_t>::max())}) {
+                write_saved_keys(count, len, int32_type->decompose(int32_t(1)));
+                auto [to_warm, warmed] = warm_up();
+                BOOST_REQUIRE_EQUAL(to_warm, 0);
+                BOOST_REQUIRE_EQUAL(warmed, 0);
+            }
+
+            // The warmer keeps working, and loads a valid record.
+            write_saved_keys(1, 4, int32_type->decompose(int32_t(1)));
+            auto [to_warm, warmed] = warm_up();
+            BOOST_REQUIRE_EQUAL(to_warm, 1);
+            BOOST_REQUIRE_EQUAL(warmed, 1);
+        }, cfg).get();
+    });
+}
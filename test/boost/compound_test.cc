@@ -22,6 +22,7 @@
 #define BOOST_TEST_MODULE core
 
 #include <boost/test/unit_test.hpp>
+#include <random>
 #include "compound.hh"
 #include "compound_compat.hh"
 #include "test/boost/range_assert.hh"
@@ -377,3 +378,91 @@ BOOST_AUTO_TEST_CASE(test_composite_validity) {
     BOOST_REQUIRE_EQUAL(is_valid({'\x00', '\x01', 'a'}), false);
     BOOST_REQUIRE_EQUAL(is_valid({'\x00', '\x02', 'a'}), false);
 }
+
+// Fixed-width components are compared without abstract_type::compare(),
+// check that the shortcut agrees with it.
+BOOST_AUTO_TEST_CASE(test_fixed_width_compare_matches_type_compare) {
+    auto seed = std::random_device{}();
+    BOOST_TEST_MESSAGE("seed: " << seed);
+    std::mt19937 gen(seed);
+
+    std::vector<data_type> fixed_width_types{byte_type, short_type, int32_type, long_type,
+            timestamp_type, time_type, simple_date_type};
+    for (size_t i = 0, n = fixed_width_types.size(); i < n; ++i) {
+        fixed_width_types.push_back(reversed_type_impl::get_instance(fixed_width_types[i]));
+    }
+
+    // Values are drawn mostly from a few small ones, so that equal and
+    // adjacent values are common, and include the extremes and empty values.
+    auto random_value = [&] (const data_type& type) {
+        auto length = *type->value_length_if_fixed();
+        int64_t v;
+        switch (std::uniform_int_distribution<int>(0, 7)(gen)) {
+        case 0: return bytes();
+        case 1: v = std::numeric_limits<int64_t>::min(); break;
+        case 2: v = std::numeric_limits<int64_t>::max(); break;
+        case 3: v = std::uniform_int_distribution<int64_t>()(gen); break;
+        default: v = std::uniform_int_distribution<int64_t>(-3, 3)(gen); break;
+        }
+        bytes b(bytes::initialized_later(), length);
+        for (size_t i = length; i > 0; --i) {
+            b[i - 1] = int8_t(v & 0xff);
+            v >>= 8;
+        }
+        return b;
+    };
+    auto sign = [] (int c) { return (c > 0) - (c < 0); };
+
+    for (auto&& t : fixed_width_types) {
+        BOOST_REQUIRE(t->get_fixed_width_order() != fixed_width_order::none);
+    }
+
+    for (int round = 0; round < 1000; ++round) {
+        std::vector<data_type> types;
+        auto n = std::uniform_int_distribution<size_t>(1, 4)(gen);
+        for (size_t i = 0; i < n; ++i) {
+            types.push_back(fixed_width_types[std::uniform_int_distribution<size_t>(0, fixed_width_types.size() - 1)(gen)]);
+        }
+        compound_type<allow_prefixes::yes> prefix_type(types);
+        compound_type<allow_prefixes::no> full_type(types);
+        BOOST_REQUIRE(prefix_type.has_fixed_width_components());
+        BOOST_REQUIRE(full_type.has_fixed_width_components());
+
+        auto random_components = [&] (size_t size) {
+            std::vector<bytes> ret;
+            for (size_t i = 0; i < size; ++i) {
+                ret.push_back(random_value(types[i]));
+            }
+            return ret;
+        };
+        auto reference_compare = [&] (const std::vector<bytes>& v1, const std::vector<bytes>& v2) {
+            for (size_t i = 0; i < std::min(v1.size(), v2.size()); ++i) {
+                if (auto c = types[i]->compare(v1[i], v2[i])) {
+                    return sign(c);
+                }
+            }
+            return sign(int(v1.size()) - int(v2.size()));
+        };
+
+        for (int i = 0; i < 100; ++i) {
+            // Sharing a random part of the first components makes later ones matter.
+            auto v1 = random_components(std::uniform_int_distribution<size_t>(0, n)(gen));
+            auto v2 = random_components(std::uniform_int_distribution<size_t>(0, n)(gen));
+            auto shared = std::uniform_int_distribution<size_t>(0, std::min(v1.size(), v2.size()))(gen);
+            std::copy_n(v1.begin(), shared, v2.begin());
+
+            auto b1 = prefix_type.serialize_value(v1);
+            auto b2 = prefix_type.serialize_value(v2);
+            BOOST_REQUIRE_EQUAL(sign(prefix_type.compare(b1, b2)), reference_compare(v1, v2));
+            BOOST_REQUIRE_EQUAL(sign(prefix_type.prefix_equality_tri_compare(b1, b2)),
+                    sign(prefix_equality_tri_compare(types.begin(), v1.begin(), v1.end(), v2.begin(), v2.end(),
+                            [] (const data_type& t, const bytes& a, const bytes& b) { return t->compare(a, b); })));
+
+            auto f1 = random_components(n);
+            auto f2 = random_components(n);
+            std::copy_n(f1.begin(), shared, f2.begin());
+            BOOST_REQUIRE_EQUAL(sign(full_type.compare(full_type.serialize_value(f1), full_type.serialize_value(f2))),
+                    reference_compare(f1, f2));
+        }
+    }
+}
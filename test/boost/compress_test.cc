@@ -156,3 +156,68 @@ BOOST_AUTO_TEST_CASE(segmented_offsets_corner_cases) {
     BOOST_REQUIRE(accessor.at(4079) == 4079);
     BOOST_REQUIRE(accessor.at(4080) == 4080);
 }
+
+BOOST_AUTO_TEST_CASE(read_stats_median_consumed_bytes) {
+    sstables::compression::read_stats stats;
+    BOOST_REQUIRE_EQUAL(stats.median_consumed_bytes(), 0);
+
+    stats.sample_consumed_bytes(0);
+    BOOST_REQUIRE_EQUAL(stats.sampled_reads, 1);
+    BOOST_REQUIRE_EQUAL(stats.median_consumed_bytes(), 1);
+
+    // Rounded up to a power of two.
+    stats = {};
+    stats.sample_consumed_bytes(3000);
+    stats.sample_consumed_bytes(4096);
+    stats.sample_consumed_bytes(5000);
+    BOOST_REQUIRE_EQUAL(stats.median_consumed_bytes(), 4096);
+
+    // A few huge reads don't move the median.
+    stats = {};
+    for (int i = 0; i < 10; ++i) {
+        stats.sample_consumed_bytes(1000);
+    }
+    for (int i = 0; i < 4; ++i) {
+        stats.sample_consumed_bytes(uint64_t(1) << 40);
+    }
+    BOOST_REQUIRE_EQUAL(stats.median_consumed_bytes(), 1024);
+    BOOST_REQUIRE_EQUAL(stats.consumed_bytes.back(), 4);
+
+    // Summing the stats of several sstables sums their histograms.
+    sstables::compression::read_stats other;
+    for (int i = 0; i < 20; ++i) {
+        other.sample_consumed_bytes(20000);
+    }
+    auto sum = stats + other;
+    BOOST_REQUIRE_EQUAL(sum.sampled_reads, 34);
+    BOOST_REQUIRE_EQUAL(sum.median_consumed_bytes(), 32 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(chunk_length_for_reads) {
+    auto stats_of = [] (uint64_t reads, uint64_t consumed_bytes) {
+        sstables::compression::read_stats stats;
+        for (uint64_t i = 0; i < reads; ++i) {
+            stats.sample_consumed_bytes(consumed_bytes);
+        }
+        return stats;
+    };
+    const auto enough = sstables::min_sampled_reads_for_auto_chunk_length;
+
+    BOOST_REQUIRE(!sstables::chunk_length_for_reads(stats_of(enough - 1, 8000)));
+
+    // Reads which didn't sample their size, like those of compaction, don't count.
+    auto unsampled = stats_of(enough - 1, 8000);
+    unsampled.reads = enough * 100;
+    unsampled.requested_bytes = enough * 100 * 1024 * 1024;
+    BOOST_REQUIRE(!sstables::chunk_length_for_reads(unsampled));
+
+    BOOST_REQUIRE_EQUAL(*sstables::chunk_length_for_reads(stats_of(enough, 8000)), 8 * 1024);
+    BOOST_REQUIRE_EQUAL(*sstables::chunk_length_for_reads(stats_of(enough, 100)), sstables::min_auto_chunk_length);
+    BOOST_REQUIRE_EQUAL(*sstables::chunk_length_for_reads(stats_of(enough, 1024 * 1024)), sstables::max_auto_chunk_length);
+    // Reads of over 2^30 bytes land in the top bucket, whose median is 2^31.
+    BOOST_REQUIRE_EQUAL(*sstables::chunk_length_for_reads(stats_of(enough, uint64_t(4) << 30)), sstables::max_auto_chunk_length);
+
+    // A minority of large reads doesn't make chunks larger.
+    auto mixed = stats_of(enough, 16 * 1024) + stats_of(enough / 2, 10 * 1024 * 1024);
+    BOOST_REQUIRE_EQUAL(*sstables::chunk_length_for_reads(mixed), 16 * 1024);
+}
@@ -37,6 +37,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/sleep.hh>
 #include "transport/messages/result_message.hh"
+#include "transport/response.hh"
 #include "utils/big_decimal.hh"
 #include "types/user.hh"
 #include "types/map.hh"
@@ -44,6 +45,7 @@
 #include "types/set.hh"
 #include "db/config.hh"
 #include "cql3/cql_config.hh"
+#include "cql3/query_processor.hh"
 #include "sstables/compaction_manager.hh"
 #include "test/lib/exception_utils.hh"
 #include "json.hh"
@@ -3805,6 +3807,100 @@ SEASTAR_TEST_CASE(test_cache_bypass) {
     });
 }
 
+SEASTAR_TEST_CASE(test_partition_tombstone_skips_shadowed_sstables) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, v int, PRIMARY KEY (pk, ck)) "
+                "WITH compaction = {'class': 'SizeTieredCompactionStrategy', 'min_threshold': 8}").get();
+        auto flush = [&] {
+            e.db().invoke_on_all([] (database& db) { return db.flush_all_memtables(); }).get();
+        };
+        auto skipped = [&] {
+            return e.db().map_reduce0([] (database& db) {
+                return db.find_column_family("ks", "t").cf_stats()->sstables_skipped_by_partition_tombstone;
+            }, int64_t(0), std::plus<int64_t>()).get0();
+        };
+        e.execute_cql("INSERT INTO t (pk, ck, v) VALUES (0, 0, 0) USING TIMESTAMP 1").get();
+        flush();
+        e.execute_cql("INSERT INTO t (pk, ck, v) VALUES (0, 1, 1) USING TIMESTAMP 2").get();
+        flush();
+        e.execute_cql("DELETE FROM t USING TIMESTAMP 10 WHERE pk = 0").get();
+        flush();
+        e.execute_cql("INSERT INTO t (pk, ck, v) VALUES (0, 2, 2) USING TIMESTAMP 20").get();
+        flush();
+
+        auto before = skipped();
+        auto msg = e.execute_cql("SELECT ck, v FROM t WHERE pk = 0 BYPASS CACHE").get0();
+        assert_that(msg).is_rows().with_rows({{int32_type->decompose(2), int32_type->decompose(2)}});
+        BOOST_REQUIRE_EQUAL(skipped() - before, 2);
+    });
+}
+
+SEASTAR_TEST_CASE(test_single_row_read_skips_superseded_sstables) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE t (pk int, ck int, v int, w int, PRIMARY KEY (pk, ck)) "
+                "WITH compaction = {'class': 'SizeTieredCompactionStrategy', 'min_threshold': 8}").get();
+        auto flush = [&] {
+            e.db().invoke_on_all([] (database& db) { return db.flush_all_memtables(); }).get();
+        };
+        auto invalidate_cache = [&] {
+            e.db().invoke_on_all([] (database& db) { return db.find_column_family("ks", "t").get_row_cache().invalidate([] {}); }).get();
+        };
+        auto skipped = [&] {
+            return e.db().map_reduce0([] (database& db) {
+                return db.find_column_family("ks", "t").cf_stats()->sstables_skipped_by_timestamp;
+            }, int64_t(0), std::plus<int64_t>()).get0();
+        };
+        auto require_row = [&] (sstring query, int32_t v, int32_t w, int64_t expected_skipped) {
+            auto before = skipped();
+            auto msg = e.execute_cql(query).get0();
+            assert_that(msg).is_rows().with_rows({{int32_type->decompose(v), int32_type->decompose(w)}});
+            BOOST_REQUIRE_EQUAL(skipped() - before, expected_skipped);
+        };
+
+        // Every sstable holds a version of the row ck = 0
+        e.execute_cql("INSERT INTO t (pk, ck, v, w) VALUES (0, 0, 1, 1) USING TIMESTAMP 1").get();
+        flush();
+        e.execute_cql("UPDATE t USING TIMESTAMP 2 SET v = 2 WHERE pk = 0 AND ck = 0").get();
+        flush();
+        e.execute_cql("INSERT INTO t (pk, ck, v, w) VALUES (0, 0, 3, 3) USING TIMESTAMP 3").get();
+        e.execute_cql("INSERT INTO t (pk, ck, v, w) VALUES (0, 1, 3, 3) USING TIMESTAMP 3").get();
+        flush();
+        e.execute_cql("UPDATE t USING TIMESTAMP 4 SET w = 4 WHERE pk = 0 AND ck = 0").get();
+        flush();
+
+        // The newest sstable has no row marker and only a part of the cells, the second newest completes the row.
+        require_row("SELECT v, w FROM t WHERE pk = 0 AND ck = 0 BYPASS CACHE", 3, 4, 2);
+        // The newest sstable doesn't have the row at all.
+        require_row("SELECT v, w FROM t WHERE pk = 0 AND ck = 1 BYPASS CACHE", 3, 3, 2);
+        // The cache is populated from the same reads, as none of the skipped sstables holds tombstones.
+        invalidate_cache();
+        require_row("SELECT v, w FROM t WHERE pk = 0 AND ck = 0", 3, 4, 2);
+        // Reads of more than a single row merge all sstables.
+        auto before = skipped();
+        auto msg = e.execute_cql("SELECT v, w FROM t WHERE pk = 0 BYPASS CACHE").get0();
+        assert_that(msg).is_rows().with_rows({
+            {int32_type->decompose(3), int32_type->decompose(4)},
+            {int32_type->decompose(3), int32_type->decompose(3)},
+        });
+        BOOST_REQUIRE_EQUAL(skipped(), before);
+
+        // The oldest sstable holds a tombstone, which could shadow other rows of the partition in the cache.
+        e.execute_cql("DELETE FROM t USING TIMESTAMP 0 WHERE pk = 0 AND ck = 1").get();
+        flush();
+        require_row("SELECT v, w FROM t WHERE pk = 0 AND ck = 0 BYPASS CACHE", 3, 4, 3);
+        invalidate_cache();
+        require_row("SELECT v, w FROM t WHERE pk = 0 AND ck = 0", 3, 4, 0);
+
+        // A newer row tombstone supersedes all the older sstables.
+        e.execute_cql("DELETE FROM t USING TIMESTAMP 5 WHERE pk = 0 AND ck = 0").get();
+        flush();
+        before = skipped();
+        msg = e.execute_cql("SELECT v, w FROM t WHERE pk = 0 AND ck = 0 BYPASS CACHE").get0();
+        assert_that(msg).is_rows().is_empty();
+        BOOST_REQUIRE_EQUAL(skipped() - before, 5);
+    });
+}
+
 SEASTAR_TEST_CASE(test_describe_varchar) {
    // Test that, like cassandra, a varchar column is represented as a text column.
    return do_with_cql_env_thread([] (cql_test_env& e) {
@@ -4492,3 +4588,78 @@ SEASTAR_TEST_CASE(test_view_with_two_regular_base_columns_in_key) {
         });
     });
 }
+
+SEASTAR_TEST_CASE(test_replication_map_follows_keyspace_changes) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        auto has_map = [&] (sstring ks_name) {
+            return e.db().map_reduce0([ks_name] (database& db) {
+                return bool(db.find_keyspace(ks_name).get_replication_strategy().get_replication_map());
+            }, true, std::logical_and<bool>()).get0();
+        };
+        e.execute_cql("CREATE KEYSPACE rm WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 1}").get();
+        BOOST_REQUIRE(has_map("rm"));
+        // Altering the keyspace replaces its replication strategy.
+        e.execute_cql("ALTER KEYSPACE rm WITH replication = {'class': 'SimpleStrategy', 'replication_factor': 2}").get();
+        BOOST_REQUIRE(has_map("rm"));
+        BOOST_REQUIRE(has_map("ks"));
+    });
+}
+
+SEASTAR_TEST_CASE(test_select_large_blob_does_not_cause_large_allocations) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE tb (pk int PRIMARY KEY, b blob)").get();
+        const size_t blob_size = 4 * 1024 * 1024;
+        bytes blob(bytes::initialized_later(), blob_size);
+        for (size_t i = 0; i < blob_size; ++i) {
+            blob[i] = int8_t(i * 7);
+        }
+        auto id = e.prepare("INSERT INTO tb (pk, b) VALUES (0, ?)").get0();
+        e.execute_prepared(id, {cql3::raw_value::make_value(blob)}).get();
+        // Serve the blob from an sstable, so that the whole read path is covered.
+        e.db().invoke_on_all([] (database& db) { return db.flush_all_memtables(); }).get();
+        e.db().invoke_on_all([] (database& db) { return db.find_column_family("ks", "tb").get_row_cache().invalidate([] {}); }).get();
+
+        // Allocations of exactly 128k, like full I/O buffers, are fine.
+        const memory::scoped_large_allocation_warning_threshold _{128 * 1024 + 1};
+
+        auto large_allocs_before = memory::stats().large_allocations();
+        auto msg = e.execute_cql("SELECT b FROM tb WHERE pk = 0").get0();
+        auto response = cql_transport::make_result(0, *msg, tracing::trace_state_ptr(), cql_transport::cql_server::current_version);
+        auto large_allocs_after = memory::stats().large_allocations();
+
+        BOOST_REQUIRE_GE(response->size(), blob_size);
+        BOOST_REQUIRE_EQUAL(large_allocs_after - large_allocs_before, 0);
+        assert_that(msg).is_rows().with_rows({{blob}});
+    });
+}
+
+SEASTAR_TEST_CASE(test_prepared_statement_memory_usage_grows_with_statement) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE pm (pk int, ck int, v1 int, v2 int, v3 int, PRIMARY KEY (pk, ck))").get();
+        auto prepare = [&] (sstring query) {
+            auto id = e.prepare(std::move(query)).get0();
+            auto prepared = e.local_qp().get_prepared(id);
+            BOOST_REQUIRE(prepared);
+            return prepared;
+        };
+        auto memory_usage = [&] (sstring query) {
+            return prepare(std::move(query))->memory_usage();
+        };
+
+        auto small_insert = memory_usage("INSERT INTO pm (pk, ck, v1) VALUES (?, ?, ?)");
+        auto large_insert = memory_usage("INSERT INTO pm (pk, ck, v1, v2, v3) VALUES (?, ?, ?, ?, ?) IF NOT EXISTS");
+        BOOST_REQUIRE_GT(large_insert, small_insert);
+
+        auto small_select = memory_usage("SELECT v1 FROM pm WHERE pk = ?");
+        auto large_select = memory_usage("SELECT v1, v2, v3 FROM pm WHERE pk = ? AND ck > ? AND ck < ?");
+        BOOST_REQUIRE_GT(large_select, small_select);
+
+        // A batch is charged for each of its statements.
+        auto insert = prepare("INSERT INTO pm (pk, ck, v1) VALUES (?, ?, ?)")->statement->memory_usage();
+        auto batch = prepare("BEGIN BATCH "
+                "INSERT INTO pm (pk, ck, v1) VALUES (?, ?, ?); "
+                "INSERT INTO pm (pk, ck, v1) VALUES (?, ?, ?); "
+                "APPLY BATCH")->statement->memory_usage();
+        BOOST_REQUIRE_GT(batch, 2 * insert);
+    });
+}
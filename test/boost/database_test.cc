@@ -469,3 +469,43 @@ SEASTAR_TEST_CASE(toppartitions_cross_shard_schema_ptr) {
         tq.gather().get();
     });
 }
+
+SEASTAR_TEST_CASE(test_query_profile_phases_per_table) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE ks.tab (id int PRIMARY KEY, v int)").get();
+        e.execute_cql("INSERT INTO ks.tab (id, v) VALUES (0, 0)").get();
+        e.db().invoke_on_all([] (database& db) {
+            auto& cf = db.find_column_family("ks", "tab");
+            return cf.flush().then([&cf] {
+                return cf.get_row_cache().invalidate([] {});
+            });
+        }).get();
+
+        auto replica_samples = [&e] (utils::estimated_histogram table_stats::* histogram) {
+            return e.db().map_reduce0([histogram] (database& db) {
+                return (db.find_column_family("ks", "tab").get_stats().*histogram).count();
+            }, int64_t(0), std::plus<int64_t>()).get0();
+        };
+
+        // The row is read from the sstable, so the read has to be admitted
+        e.execute_cql("SELECT * FROM ks.tab WHERE id = 0").get();
+        BOOST_REQUIRE_EQUAL(replica_samples(&table_stats::estimated_replica_memory_wait), 1);
+        BOOST_REQUIRE_EQUAL(replica_samples(&table_stats::estimated_replica_read), 1);
+        BOOST_REQUIRE_GE(replica_samples(&table_stats::estimated_replica_admission), 1);
+
+        // Only the phases the request went through are accounted
+        auto& cf = e.local_db().find_column_family("ks", "tab");
+        tracing::query_profile profile(tracing::query_profile::clock::now() - 1s);
+        BOOST_REQUIRE_GE(profile.elapsed(), 1s);
+        profile.add(tracing::query_phase::execute, 2ms);
+        profile.add(tracing::query_phase::respond, 0ms);
+        BOOST_REQUIRE(!profile.has(tracing::query_phase::parse));
+        BOOST_REQUIRE(profile.has(tracing::query_phase::respond));
+        cf.add_query_profile(profile);
+        auto& phases = cf.get_stats().estimated_query_phases;
+        BOOST_REQUIRE_EQUAL(phases[size_t(tracing::query_phase::parse)].count(), 0);
+        BOOST_REQUIRE_EQUAL(phases[size_t(tracing::query_phase::authorize)].count(), 0);
+        BOOST_REQUIRE_EQUAL(phases[size_t(tracing::query_phase::execute)].count(), 1);
+        BOOST_REQUIRE_EQUAL(phases[size_t(tracing::query_phase::respond)].count(), 1);
+    });
+}
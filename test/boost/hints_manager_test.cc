@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/core/thread.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "db/hints/manager.hh"
+#include "seastarx.hh"
+
+SEASTAR_THREAD_TEST_CASE(test_failed_segment_does_not_hold_back_sent_ones) {
+    std::list<sstring> segments{"s0", "s1", "s2", "s3", "s4"};
+    std::vector<sstring> attempted;
+
+    auto sent = db::hints::replay_segments_batch(segments, 4, default_scheduling_group(), [&attempted] (size_t i, const sstring& fname) {
+        attempted.push_back(fname);
+        // Let the segments be replayed concurrently
+        seastar::thread::yield();
+        if (fname == "s1") {
+            throw std::runtime_error("can't stat the segment");
+        }
+        return fname != "s2";
+    });
+
+    BOOST_REQUIRE_EQUAL(attempted.size(), 4);
+    BOOST_REQUIRE(sent == std::vector<char>({true, false, false, true}));
+    // The segments sent in full are gone, the failed ones are kept in order, the ones out of the batch are untouched
+    BOOST_REQUIRE(segments == std::list<sstring>({"s1", "s2", "s4"}));
+
+    // The next batch retries the failed segment
+    sent = db::hints::replay_segments_batch(segments, 4, default_scheduling_group(), [] (size_t i, const sstring& fname) {
+        return true;
+    });
+    BOOST_REQUIRE(sent == std::vector<char>({true, true, true}));
+    BOOST_REQUIRE(segments.empty());
+}
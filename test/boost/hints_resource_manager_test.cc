@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <seastar/core/thread.hh>
+#include <seastar/core/with_timeout.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include "db/hints/resource_manager.hh"
+#include "seastarx.hh"
+
+using namespace std::chrono_literals;
+
+SEASTAR_THREAD_TEST_CASE(test_replay_of_hint_bigger_than_replay_budget) {
+    db::hints::resource_manager rm(memory::stats().total_memory() / 10);
+
+    // With no hints on disk the replay runs at the minimum rate.
+    size_t min_rate = hints_replay_controller::min_rate_mb_per_sec * 1024 * 1024;
+    BOOST_REQUIRE_LE(rm.max_replay_budget(), min_rate);
+
+    // A hint bigger than a second worth of replay must still be sent, and mustn't hold back the ones behind it.
+    auto f1 = rm.consume_replay_budget(min_rate * 3 / 2);
+    auto f2 = rm.consume_replay_budget(1024);
+    with_timeout(lowres_clock::now() + 10s, std::move(f1)).get();
+    with_timeout(lowres_clock::now() + 10s, std::move(f2)).get();
+
+    rm.stop().get();
+}
@@ -334,6 +334,55 @@ SEASTAR_TEST_CASE(test_loading_cache_max_size_eviction) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_loading_cache_max_size_eviction_keeps_frequently_used) {
+    using namespace std::chrono;
+    load_count = 0;
+    utils::loading_cache<int, sstring> loading_cache(3, 1h, test_logger);
+    auto stop_cache_reload = seastar::defer([&loading_cache] { loading_cache.stop().get(); });
+
+    prepare().get();
+
+    loading_cache.get_ptr(0, loader).discard_result().get();
+    loading_cache.touch(0);
+
+    // A plain LRU would evict 0 when 3 is added.
+    for (int i = 1; i <= 3; ++i) {
+        loading_cache.get_ptr(i, loader).discard_result().get();
+    }
+
+    BOOST_REQUIRE_EQUAL(load_count, 4);
+    BOOST_REQUIRE_EQUAL(loading_cache.size(), 3);
+    BOOST_REQUIRE(loading_cache.find(0) != loading_cache.end());
+    BOOST_REQUIRE(loading_cache.find(1) == loading_cache.end());
+    BOOST_REQUIRE(loading_cache.find(3) != loading_cache.end());
+
+    // The second chance is used up, so 0 is evicted next unless it's used again.
+    loading_cache.get_ptr(4, loader).discard_result().get();
+    BOOST_REQUIRE(loading_cache.find(0) == loading_cache.end());
+}
+
+SEASTAR_THREAD_TEST_CASE(test_loading_cache_touch_by_iterator) {
+    using namespace std::chrono;
+    load_count = 0;
+    utils::loading_cache<int, sstring> loading_cache(2, 1h, test_logger);
+    auto stop_cache_reload = seastar::defer([&loading_cache] { loading_cache.stop().get(); });
+
+    prepare().get();
+
+    loading_cache.get_ptr(0, loader).discard_result().get();
+    loading_cache.get_ptr(1, loader).discard_result().get();
+
+    auto it = loading_cache.find(0);
+    BOOST_REQUIRE(it != loading_cache.end());
+    loading_cache.touch(it);
+
+    // 0 is no longer the least recently used entry.
+    loading_cache.get_ptr(2, loader).discard_result().get();
+    BOOST_REQUIRE_EQUAL(loading_cache.size(), 2);
+    BOOST_REQUIRE(loading_cache.find(0) != loading_cache.end());
+    BOOST_REQUIRE(loading_cache.find(1) == loading_cache.end());
+}
+
 SEASTAR_TEST_CASE(test_loading_cache_reload_during_eviction) {
     return seastar::async([] {
         using namespace std::chrono;
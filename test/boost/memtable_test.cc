@@ -175,6 +175,36 @@ SEASTAR_TEST_CASE(test_memtable_flush_reader) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(test_memtable_split_for_flush) {
+    random_mutation_generator gen(random_mutation_generator::generate_counters::no);
+    table_stats tbl_stats;
+    dirty_memory_manager mgr;
+    auto muts = gen(64);
+    auto mt = make_lw_shared<memtable>(gen.schema(), mgr, tbl_stats);
+    for (auto& m : muts) {
+        mt->apply(m);
+    }
+
+    BOOST_REQUIRE_EQUAL(mt->split_for_flush(1).size(), 1);
+    BOOST_REQUIRE_EQUAL(mt->split_for_flush(muts.size() + 1).size(), 1);
+
+    auto ranges = mt->split_for_flush(4);
+    BOOST_REQUIRE_GT(ranges.size(), 1);
+    BOOST_REQUIRE_LE(ranges.size(), 4);
+
+    // The ranges are disjoint and together cover every partition.
+    std::vector<dht::decorated_key> keys;
+    for (auto& range : ranges) {
+        auto rd = mt->make_flush_reader(gen.schema(), default_priority_class(), range);
+        while (auto mo = read_mutation_from_flat_mutation_reader(rd, db::no_timeout).get0()) {
+            BOOST_REQUIRE(range.contains(mo->decorated_key(), dht::ring_position_comparator(*gen.schema())));
+            keys.push_back(mo->decorated_key());
+        }
+    }
+    BOOST_REQUIRE_EQUAL(keys.size(), mt->partition_count());
+    BOOST_REQUIRE(std::is_sorted(keys.begin(), keys.end(), dht::decorated_key::less_comparator(gen.schema())));
+}
+
 SEASTAR_TEST_CASE(test_adding_a_column_during_reading_doesnt_affect_read_result) {
     return seastar::async([] {
         auto common_builder = schema_builder("ks", "cf")
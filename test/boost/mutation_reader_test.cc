@@ -1324,6 +1324,114 @@ SEASTAR_TEST_CASE(restricted_reader_create_reader) {
     });
 }
 
+SEASTAR_THREAD_TEST_CASE(restricted_reader_short_reads_bypass_long_reads) {
+    using read_class = reader_concurrency_semaphore::read_class;
+    using admission_cost = reader_concurrency_semaphore::admission_cost;
+    reader_concurrency_semaphore semaphore(100, 4 * new_reader_base_cost, get_name());
+
+    auto scan1 = semaphore.wait_admission(admission_cost{3 * new_reader_base_cost, read_class::long_read}).get0();
+
+    // Doesn't fit, queues up.
+    auto scan2_fut = semaphore.wait_admission(admission_cost{2 * new_reader_base_cost, read_class::long_read});
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(read_class::long_read), 1);
+
+    // Fits, and is not blocked by the queued long read.
+    auto point1_fut = semaphore.wait_admission(admission_cost{new_reader_base_cost, read_class::short_read});
+    BOOST_REQUIRE(point1_fut.available());
+    auto point1 = point1_fut.get0();
+
+    // Queues up behind no one but has to wait for memory.
+    auto point2_fut = semaphore.wait_admission(admission_cost{new_reader_base_cost, read_class::short_read});
+    BOOST_REQUIRE_EQUAL(semaphore.waiters(read_class::short_read), 1);
+
+    // Short reads are admitted first.
+    point1 = {};
+    BOOST_REQUIRE(point2_fut.available());
+    BOOST_REQUIRE(!scan2_fut.available());
+
+    scan1 = {};
+    BOOST_REQUIRE(scan2_fut.available());
+    scan2_fut.get();
+    point2_fut.get();
+
+    const auto& stats = semaphore.get_admission_stats();
+    BOOST_REQUIRE_EQUAL(stats.short_read_wait.count(), 2);
+    BOOST_REQUIRE_EQUAL(stats.long_read_wait.count(), 2);
+}
+
+SEASTAR_THREAD_TEST_CASE(restricted_reader_long_reads_do_not_starve) {
+    using read_class = reader_concurrency_semaphore::read_class;
+    using admission_cost = reader_concurrency_semaphore::admission_cost;
+    reader_concurrency_semaphore semaphore(1, 2 * new_reader_base_cost, get_name());
+
+    auto point = semaphore.wait_admission(admission_cost{new_reader_base_cost, read_class::short_read}).get0();
+    auto scan_fut = semaphore.wait_admission(admission_cost{2 * new_reader_base_cost, read_class::long_read});
+
+    for (unsigned i = 0; i < reader_concurrency_semaphore::max_long_read_bypass; ++i) {
+        auto next_fut = semaphore.wait_admission(admission_cost{new_reader_base_cost, read_class::short_read});
+        BOOST_REQUIRE(!next_fut.available());
+        point = {};
+        BOOST_REQUIRE(next_fut.available());
+        BOOST_REQUIRE(!scan_fut.available());
+        point = next_fut.get0();
+    }
+
+    // The long read was bypassed enough times, it goes first now.
+    auto next_fut = semaphore.wait_admission(admission_cost{new_reader_base_cost, read_class::short_read});
+    point = {};
+    BOOST_REQUIRE(scan_fut.available());
+    BOOST_REQUIRE(!next_fut.available());
+    BOOST_REQUIRE_EQUAL(semaphore.get_admission_stats().long_read_promotions, 1);
+
+    scan_fut.get();
+    BOOST_REQUIRE(next_fut.available());
+    next_fut.get();
+}
+
+SEASTAR_THREAD_TEST_CASE(restricted_reader_evicts_inactive_reads_until_admission) {
+    using read_class = reader_concurrency_semaphore::read_class;
+    using admission_cost = reader_concurrency_semaphore::admission_cost;
+    reader_concurrency_semaphore semaphore(4, 4 * new_reader_base_cost, get_name());
+
+    class permit_holder : public reader_concurrency_semaphore::inactive_read {
+        lw_shared_ptr<reader_concurrency_semaphore::reader_permit> _permit;
+        size_t _memory;
+    public:
+        permit_holder(lw_shared_ptr<reader_concurrency_semaphore::reader_permit> permit, size_t memory)
+            : _permit(std::move(permit)), _memory(memory) {
+        }
+        virtual void evict() override {
+            _permit = {};
+        }
+        virtual size_t memory_usage() const override {
+            return _memory;
+        }
+    };
+    auto register_inactive_read = [&] (size_t memory) {
+        auto permit = semaphore.wait_admission(memory).get0();
+        return semaphore.register_inactive_read(std::make_unique<permit_holder>(std::move(permit), memory));
+    };
+
+    auto oldest = register_inactive_read(new_reader_base_cost);
+    auto largest = register_inactive_read(2 * new_reader_base_cost);
+    auto newest = register_inactive_read(new_reader_base_cost);
+
+    // Short on memory only: the largest read makes enough room.
+    auto scan = semaphore.wait_admission(admission_cost{2 * new_reader_base_cost, read_class::long_read}).get0();
+    BOOST_REQUIRE(!semaphore.unregister_inactive_read(std::move(largest)));
+    BOOST_REQUIRE_EQUAL(semaphore.get_inactive_read_stats().population, 2);
+
+    // Short on count: the oldest read makes enough room.
+    auto point1 = semaphore.wait_admission(admission_cost{0, read_class::short_read}).get0();
+    BOOST_REQUIRE_EQUAL(semaphore.get_inactive_read_stats().population, 2);
+    auto point2 = semaphore.wait_admission(admission_cost{0, read_class::short_read}).get0();
+    BOOST_REQUIRE(!semaphore.unregister_inactive_read(std::move(oldest)));
+    BOOST_REQUIRE_EQUAL(semaphore.get_inactive_read_stats().population, 1);
+    BOOST_REQUIRE_EQUAL(semaphore.get_inactive_read_stats().permit_based_evictions, 2);
+
+    BOOST_REQUIRE(semaphore.unregister_inactive_read(std::move(newest)));
+}
+
 SEASTAR_TEST_CASE(test_restricted_reader_as_mutation_source) {
     return seastar::async([test_name = get_name()] {
         reader_concurrency_semaphore semaphore(100, 10 * new_reader_base_cost, test_name);
@@ -26,6 +26,8 @@
 #include "dht/murmur3_partitioner.hh"
 #include "locator/network_topology_strategy.hh"
 #include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/defer.hh>
 #include <seastar/core/sstring.hh>
 #include "log.hh"
 #include <vector>
@@ -332,6 +334,103 @@ SEASTAR_TEST_CASE(NetworkTopologyStrategy_heavy) {
     return heavy_origin_test();
 }
 
+static std::vector<inet_address> sorted(std::vector<inet_address> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+/**
+ * Check that a replication map built for the current ring serves the same
+ * natural and pending endpoints as token_metadata does, and that it is dropped
+ * once the ring or the pending ranges change.
+ */
+SEASTAR_THREAD_TEST_CASE(NetworkTopologyStrategy_replication_map) {
+    utils::fb_utilities::set_broadcast_address(gms::inet_address("localhost"));
+    utils::fb_utilities::set_broadcast_rpc_address(gms::inet_address("localhost"));
+
+    i_endpoint_snitch::create_snitch("RackInferringSnitch").get();
+    auto stop_snitch = defer([] { i_endpoint_snitch::stop_snitch().get(); });
+
+    std::vector<ring_point> ring_points = {
+        { 1.0, inet_address("192.100.10.1") },
+        { 2.0, inet_address("192.101.10.1") },
+        { 3.0, inet_address("192.102.10.1") },
+        { 4.0, inet_address("192.100.20.1") },
+        { 5.0, inet_address("192.101.20.1") },
+        { 6.0, inet_address("192.102.20.1") },
+    };
+    auto point_token = [&] (double point) {
+        return token{dht::token::kind::key, {(int8_t*)d2t(point / ring_points.size()).data(), 8}};
+    };
+    token_metadata tm;
+    for (auto& rp : ring_points) {
+        tm.update_normal_token(point_token(rp.point), rp.host);
+    }
+    std::map<sstring, sstring> options = {
+        {"100", "2"},
+        {"101", "1"},
+        {"102", "1"}
+    };
+    sstring ks_name = "test keyspace";
+    auto ars = abstract_replication_strategy::create_replication_strategy(ks_name, "NetworkTopologyStrategy", tm, options);
+
+    auto check = [&] {
+        ars->set_replication_map(make_lw_shared<const replication_map>(replication_map::build(*ars, tm).get0()));
+        BOOST_REQUIRE(ars->get_replication_map());
+        for (auto& rp : ring_points) {
+            for (double offset : {-0.5, -0.2, 0.0}) {
+                auto t = point_token(rp.point + offset);
+                auto expected = ars->calculate_natural_endpoints(t, tm);
+                auto endpoints = ars->get_natural_endpoints_range(t);
+                BOOST_CHECK(std::vector<inet_address>(endpoints.begin(), endpoints.end()) == expected);
+                BOOST_CHECK(ars->get_natural_endpoints(t) == expected);
+                BOOST_CHECK(sorted(ars->get_pending_endpoints(t)) == sorted(tm.pending_endpoints_for(t, ks_name)));
+            }
+        }
+    };
+
+    check();
+    for (auto& rp : ring_points) {
+        BOOST_CHECK(ars->get_pending_endpoints(point_token(rp.point)).empty());
+    }
+
+    auto joining1 = inet_address("192.100.30.1");
+    auto joining2 = inet_address("192.101.30.1");
+    std::unordered_multimap<range<token>, inet_address> pending;
+    auto r1 = range<token>::make({point_token(2.0), false}, {point_token(4.0), true});
+    auto r2 = range<token>::make({point_token(5.0), false}, {point_token(6.0), true});
+    pending.emplace(r1, joining1);
+    pending.emplace(r2, joining1);
+    pending.emplace(r2, joining2);
+    tm.set_pending_ranges(ks_name, std::move(pending));
+    // New pending ranges make the old map stale.
+    BOOST_REQUIRE(!ars->get_replication_map());
+
+    check();
+    BOOST_CHECK(ars->get_pending_endpoints(point_token(2.0)).empty());
+    BOOST_CHECK(sorted(ars->get_pending_endpoints(point_token(3.0))) == std::vector<inet_address>({joining1}));
+    BOOST_CHECK(sorted(ars->get_pending_endpoints(point_token(4.0))) == std::vector<inet_address>({joining1}));
+    BOOST_CHECK(ars->get_pending_endpoints(point_token(4.5)).empty());
+    BOOST_CHECK(sorted(ars->get_pending_endpoints(point_token(5.5))) == sorted({joining1, joining2}));
+    BOOST_CHECK(ars->get_pending_endpoints(point_token(1.0)).empty());
+
+    // Recalculating the same pending ranges, or changing another keyspace's,
+    // keeps the map current.
+    std::unordered_multimap<range<token>, inet_address> same_pending;
+    same_pending.emplace(r1, joining1);
+    same_pending.emplace(r2, joining2);
+    same_pending.emplace(r2, joining1);
+    tm.set_pending_ranges(ks_name, std::move(same_pending));
+    BOOST_REQUIRE(ars->get_replication_map());
+    std::unordered_multimap<range<token>, inet_address> other_pending;
+    other_pending.emplace(r1, joining2);
+    tm.set_pending_ranges("other keyspace", std::move(other_pending));
+    BOOST_REQUIRE(ars->get_replication_map());
+
+    tm.invalidate_cached_rings();
+    BOOST_REQUIRE(!ars->get_replication_map());
+}
+
 /**
  * static impl of "old" network topology strategy endpoint calculation.
  */
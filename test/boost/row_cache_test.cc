@@ -268,6 +268,42 @@ SEASTAR_TEST_CASE(test_cache_uses_continuity_info_for_single_partition_query) {
     });
 }
 
+SEASTAR_TEST_CASE(test_hot_keys_are_the_most_frequently_read) {
+    return seastar::async([] {
+        auto s = make_schema();
+        cache_tracker tracker;
+        row_cache cache(s, snapshot_source_from_snapshot(mutation_source([] (schema_ptr s, const dht::partition_range&, const query::partition_slice&, const io_priority_class&, tracing::trace_state_ptr, streamed_mutation::forwarding) {
+            return make_empty_flat_reader(s);
+        })), tracker);
+
+        BOOST_REQUIRE(cache.hot_keys().empty());
+
+        auto read = [&] (int pkey, int times) {
+            auto range = make_single_partition_range(s, pkey);
+            for (int i = 0; i < times; ++i) {
+                assert_that(cache.make_reader(s, range))
+                        .produces_end_of_stream();
+            }
+            return range.start()->value().as_decorated_key();
+        };
+
+        // Reads are sampled, so do many of them.
+        auto k2 = read(2, 200);
+        auto k1 = read(1, 400);
+        auto k3 = read(3, 100);
+
+        auto keys = cache.hot_keys();
+        BOOST_REQUIRE_EQUAL(keys.size(), 3);
+        BOOST_REQUIRE(keys[0].equal(*s, k1));
+        BOOST_REQUIRE(keys[1].equal(*s, k2));
+        BOOST_REQUIRE(keys[2].equal(*s, k3));
+
+        keys = cache.hot_keys(1);
+        BOOST_REQUIRE_EQUAL(keys.size(), 1);
+        BOOST_REQUIRE(keys[0].equal(*s, k1));
+    });
+}
+
 void test_cache_delegates_to_underlying_only_once_with_single_partition(schema_ptr s,
                                                                         const mutation& m,
                                                                         const dht::partition_range& range,
@@ -3600,3 +3636,112 @@ SEASTAR_TEST_CASE(test_reading_progress_with_small_buffer_and_invalidation) {
         assert_that(result).is_equal_to(m1);
     });
 }
+
+class cache_tester {
+public:
+    using update_lookup_hint = row_cache::update_lookup_hint;
+
+    static row_cache::partitions_type::iterator lower_bound(row_cache& rc, const dht::decorated_key& dk) {
+        return rc._partitions.lower_bound(dk, cache_entry::compare(rc._schema));
+    }
+
+    static std::optional<row_cache::partitions_type::iterator> lower_bound(row_cache& rc, const update_lookup_hint& hint,
+            const dht::decorated_key& dk) {
+        return hint.lower_bound(rc.partitions_end(), rc._tracker.region(), dk, cache_entry::compare(rc._schema));
+    }
+};
+
+SEASTAR_TEST_CASE(test_update_lookup_hint_invalidation) {
+    return seastar::async([] {
+        simple_schema ss;
+        auto s = ss.schema();
+        cache_tracker tracker;
+        memtable_snapshot_source underlying(s);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        const auto max_steps = row_cache::max_update_lookup_steps;
+        auto keys = ss.make_pkeys(2 * max_steps);
+        for (auto& key : keys) {
+            mutation m(s, key);
+            ss.add_row(m, ss.make_ckey(0), "v");
+            m.partition().make_fully_continuous();
+            underlying.apply(m);
+            cache.populate(m);
+        }
+
+        with_linearized_managed_bytes([&] {
+            cache_tester::update_lookup_hint hint;
+            auto& region = tracker.region();
+
+            BOOST_REQUIRE(!cache_tester::lower_bound(cache, hint, keys[0]));
+
+            hint.set(cache_tester::lower_bound(cache, keys[0]), region);
+            auto i = cache_tester::lower_bound(cache, hint, keys[max_steps - 1]);
+            BOOST_REQUIRE(i);
+            BOOST_REQUIRE((*i)->key().equal(*s, keys[max_steps - 1]));
+            // Too far from the hint.
+            BOOST_REQUIRE(!cache_tester::lower_bound(cache, hint, keys[max_steps]));
+
+            // At the end of a batch.
+            hint.invalidate();
+            BOOST_REQUIRE(!cache_tester::lower_bound(cache, hint, keys[1]));
+
+            hint.set(cache_tester::lower_bound(cache, keys[0]), region);
+            BOOST_REQUIRE(cache_tester::lower_bound(cache, hint, keys[1]));
+            // Compaction moves the entries the hint points to.
+            region.full_compaction();
+            BOOST_REQUIRE(!cache_tester::lower_bound(cache, hint, keys[1]));
+        });
+    });
+}
+
+SEASTAR_TEST_CASE(test_update_with_eviction_between_batches) {
+    return seastar::async([] {
+        simple_schema ss;
+        auto s = ss.schema();
+        cache_tracker tracker;
+        memtable_snapshot_source underlying(s);
+        row_cache cache(s, snapshot_source([&] { return underlying(); }), tracker);
+
+        const int n_keys = 2000; // enough for update to be preempted
+        auto keys = ss.make_pkeys(n_keys);
+        auto mt = make_lw_shared<memtable>(s);
+        std::vector<mutation> updates;
+        std::vector<mutation> expected;
+        for (auto& key : keys) {
+            mutation m(s, key);
+            ss.add_row(m, ss.make_ckey(0), "v1");
+            underlying.apply(m);
+            mutation m2(s, key);
+            ss.add_row(m2, ss.make_ckey(0), "v2");
+            mt->apply(m2);
+            expected.push_back(m + m2);
+            updates.push_back(std::move(m2));
+        }
+
+        // Populate the cache so that the update merges into existing entries.
+        populate_range(cache);
+
+        auto update_f = cache.update([&] () noexcept {
+            for (auto& m : updates) {
+                underlying.apply(m);
+            }
+        }, *mt);
+        // Remove the entries around the update's position whenever it yields,
+        // and bring some back, so that a hint kept across batches would point
+        // to freed entries.
+        for (int i = 0; !update_f.available(); i += 7) {
+            cache.evict();
+            auto& key = keys[i % n_keys];
+            assert_that(cache.make_reader(s, dht::partition_range::make_singular(key))).produces_partition_start(key);
+            later().get();
+        }
+        update_f.get();
+
+        auto rd = assert_that(cache.make_reader(s));
+        for (auto& m : expected) {
+            rd.produces(m);
+        }
+        rd.produces_end_of_stream();
+    });
+}
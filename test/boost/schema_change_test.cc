@@ -530,6 +530,48 @@ SEASTAR_TEST_CASE(test_notifications) {
     });
 }
 
+SEASTAR_TEST_CASE(test_merge_compares_only_affected_tables) {
+    return do_with_cql_env([](cql_test_env& e) {
+        return seastar::async([&] {
+            e.execute_cql("create keyspace tests with replication = { 'class' : 'SimpleStrategy', 'replication_factor' : 1 };").get();
+            for (int i = 0; i < 10; ++i) {
+                e.execute_cql(format("create table tests.table{} (pk int, ck int, v int, primary key (pk, ck));", i)).get();
+            }
+            e.execute_cql("create materialized view tests.view0 as select * from tests.table0 "
+                          "where pk is not null and ck is not null primary key (ck, pk);").get();
+            e.execute_cql("create index on tests.table1 (v);").get();
+
+            counting_migration_listener listener;
+            service::get_local_migration_manager().register_listener(&listener);
+            auto listener_lease = defer([&listener] { service::get_local_migration_manager().unregister_listener(&listener); });
+
+            auto untouched = e.db().local().find_schema("tests", "table9");
+
+            e.execute_cql("alter table tests.table2 add v2 int;").get();
+            BOOST_REQUIRE_EQUAL(listener.update_column_family_count, 1);
+
+            e.execute_cql("alter table tests.table0 add v2 int;").get();
+            BOOST_REQUIRE_EQUAL(listener.update_column_family_count, 2);
+            BOOST_REQUIRE_EQUAL(listener.update_view_count, 1);
+
+            e.execute_cql("drop materialized view tests.view0;").get();
+            BOOST_REQUIRE_EQUAL(listener.drop_view_count, 1);
+
+            e.execute_cql("drop table tests.table1;").get();
+            BOOST_REQUIRE_EQUAL(listener.drop_view_count, 2);
+            BOOST_REQUIRE_EQUAL(listener.drop_column_family_count, 1);
+            BOOST_REQUIRE(!e.db().local().has_schema("tests", "table1"));
+
+            BOOST_REQUIRE(untouched == e.db().local().find_schema("tests", "table9"));
+            BOOST_REQUIRE_EQUAL(listener.create_column_family_count, 0);
+
+            e.execute_cql("drop keyspace tests;").get();
+            BOOST_REQUIRE_EQUAL(listener.drop_column_family_count, 10);
+            BOOST_REQUIRE(!e.db().local().has_schema("tests", "table9"));
+        });
+    });
+}
+
 SEASTAR_TEST_CASE(test_drop_user_type_in_use) {
     return do_with_cql_env_thread([](cql_test_env& e) {
         e.execute_cql("create type simple_type (user_number int);").get();
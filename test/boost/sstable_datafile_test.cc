@@ -5400,3 +5400,78 @@ SEASTAR_TEST_CASE(incremental_compaction_data_resurrection_test) {
         BOOST_REQUIRE(is_partition_dead(alpha));
     });
 }
+
+SEASTAR_TEST_CASE(test_split_memtable_flush) {
+    return test_env::do_with_async([] (test_env& env) {
+        storage_service_for_tests ssft;
+        simple_schema ss;
+        auto s = ss.schema();
+
+        auto tmp = tmpdir();
+        cf_stats stats;
+        column_family::config cfg = column_family_test_config();
+        cfg.datadir = tmp.path().string();
+        cfg.enable_commitlog = false;
+        cfg.enable_incremental_backups = false;
+        cfg.cf_stats = &stats;
+        cfg.memtable_flush_split_size = 64 * 1024;
+        // The compaction manager isn't started, so the run written by the
+        // flush stays as it is.
+        auto cm = make_lw_shared<compaction_manager>();
+        auto cl_stats = make_lw_shared<cell_locker_stats>();
+        auto tracker = make_lw_shared<cache_tracker>();
+        auto cf = make_lw_shared<column_family>(s, cfg, column_family::no_commitlog(), *cm, *cl_stats, *tracker);
+        cf->mark_ready_for_writes();
+
+        std::vector<mutation> mutations;
+        for (auto& pk : ss.make_pkeys(512)) {
+            mutation m(s, pk);
+            ss.add_row(m, ss.make_ckey(0), make_random_string(1024));
+            cf->apply(m);
+            mutations.push_back(std::move(m));
+        }
+        auto old = column_family_test::switch_memtable(*cf);
+
+        // The flush makes its sstables after this one, so the second writer
+        // gets the second generation after it. A file in place of its data
+        // file makes it fail while the other writers succeed.
+        auto probe = cf->make_sstable();
+        auto failing_generation = probe->generation() + 2 * smp::count;
+        auto blocker = sstables::sstable::filename(cfg.datadir, s->ks_name(), s->cf_name(), probe->get_version(),
+                failing_generation, sstables::sstable::format_types::big, component_type::Data);
+        probe = {};
+        open_file_dma(blocker, open_flags::wo | open_flags::create).then([] (file f) {
+            return f.close().finally([f] {});
+        }).get();
+
+        BOOST_REQUIRE(!column_family_test::try_flush_memtable_to_sstable(*cf, old).get0());
+        BOOST_REQUIRE_EQUAL(stats.failed_memtables_flushes_count, 1);
+        BOOST_REQUIRE(cf->get_sstables()->empty());
+        // The monitors of all writers stopped charging the backlog...
+        BOOST_REQUIRE_EQUAL(cf->get_compaction_strategy().get_backlog_tracker().backlog(), 0);
+        // ...and the sstables written by the successful ones were removed,
+        // along with the failed one's.
+        sstables::await_background_jobs().get();
+        for (auto& entry : fs::directory_iterator(tmp.path())) {
+            BOOST_FAIL(format("Unexpected file left behind by a failed flush: {}", entry.path()));
+        }
+
+        BOOST_REQUIRE(column_family_test::try_flush_memtable_to_sstable(*cf, old).get0());
+        auto sstables = cf->get_sstables();
+        BOOST_REQUIRE_GT(sstables->size(), 1);
+        auto run_id = (*sstables->begin())->run_identifier();
+        for (auto& sst : *sstables) {
+            BOOST_REQUIRE_EQUAL(sst->run_identifier(), run_id);
+        }
+
+        std::sort(mutations.begin(), mutations.end(), mutation_decorated_key_less_comparator());
+        auto assertions = assert_that(cf->make_reader(s, query::full_partition_range));
+        for (auto& m : mutations) {
+            assertions.produces(m);
+        }
+        assertions.produces_end_of_stream();
+
+        cf->stop().get();
+        cm->stop().get();
+    });
+}
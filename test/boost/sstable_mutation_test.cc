@@ -1567,6 +1567,57 @@ SEASTAR_THREAD_TEST_CASE(test_large_index_pages_do_not_cause_large_allocations)
     BOOST_REQUIRE_EQUAL(large_allocs_after - large_allocs_before, 0);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_large_cell_values_do_not_cause_large_allocations) {
+    auto wait_bg = seastar::defer([] { sstables::await_background_jobs().get(); });
+
+    storage_service_for_tests ssft;
+    auto dir = tmpdir();
+
+    simple_schema ss;
+    auto s = ss.schema();
+
+    const size_t blob_size = 10 * 1024 * 1024;
+
+    auto pk = ss.make_pkey(0);
+    auto mt = make_lw_shared<memtable>(s);
+    {
+        mutation m(s, pk);
+        ss.add_row(m, ss.make_ckey(0), make_random_string(blob_size));
+        mt->apply(m);
+    }
+
+    auto pr = dht::partition_range::make_singular(pk);
+
+    auto mt_reader = mt->make_flat_reader(s, pr);
+    mutation expected = *read_mutation_from_flat_mutation_reader(mt_reader, db::no_timeout).get0();
+
+    sstables::test_env env;
+    int64_t generation = 1;
+    for (auto version : {sstable_version_types::la, sstable_version_types::mc}) {
+        BOOST_TEST_MESSAGE(format("Testing version {}", sstables::to_string(version)));
+        auto sst = env.make_sstable(s,
+                                    dir.path().string(),
+                                    generation++,
+                                    version,
+                                    sstables::sstable::format_types::big);
+        sst->write_components(mt->make_flat_reader(s), 1, s, sstable_writer_config{}, mt->get_encoding_stats()).get();
+        sst->load().get();
+
+        // Allocations of exactly 128k, like full I/O buffers, are fine.
+        const memory::scoped_large_allocation_warning_threshold _{128 * 1024 + 1};
+
+        auto large_allocs_before = memory::stats().large_allocations();
+        auto sst_reader = sst->as_mutation_source().make_reader(s, pr);
+        mutation actual = *read_mutation_from_flat_mutation_reader(sst_reader, db::no_timeout).get0();
+        auto result = actual.query(s->full_slice());
+        auto large_allocs_after = memory::stats().large_allocations();
+
+        assert_that(actual).is_equal_to(expected);
+        BOOST_REQUIRE_GE(result.buf().size(), blob_size);
+        BOOST_REQUIRE_EQUAL(large_allocs_after - large_allocs_before, 0);
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_schema_changes) {
     auto dir = tmpdir();
     storage_service_for_tests ssft;
@@ -33,6 +33,7 @@
 #include "compress.hh"
 #include "database.hh"
 #include <memory>
+#include <random>
 #include "test/boost/sstable_test.hh"
 #include "test/lib/tmpdir.hh"
 #include "partition_slice_builder.hh"
@@ -351,8 +352,10 @@ class test_row_consumer : public row_consumer {
         return proceed::yes;
     }
 
-    virtual proceed consume_cell(bytes_view col_name, bytes_view value,
+    virtual proceed consume_cell(bytes_view col_name, fragmented_temporary_buffer::view value_fragments,
             int64_t timestamp, int64_t ttl, int64_t expiration) override {
+        auto value_bytes = linearized(value_fragments);
+        bytes_view value(value_bytes);
         BOOST_REQUIRE(ttl == 0);
         BOOST_REQUIRE(expiration == 0);
         switch (count_cell) {
@@ -467,7 +470,7 @@ class count_row_consumer : public row_consumer {
         count_row_start++;
         return proceed::yes;
     }
-    virtual proceed consume_cell(bytes_view col_name, bytes_view value,
+    virtual proceed consume_cell(bytes_view col_name, fragmented_temporary_buffer::view value,
             int64_t timestamp, int64_t ttl, int64_t expiration) override {
         count_cell++;
         return proceed::yes;
@@ -619,8 +622,10 @@ class ttl_row_consumer : public count_row_consumer {
         return proceed::yes;
     }
 
-    virtual proceed consume_cell(bytes_view col_name, bytes_view value,
+    virtual proceed consume_cell(bytes_view col_name, fragmented_temporary_buffer::view value_fragments,
             int64_t timestamp, int64_t ttl, int64_t expiration) override {
+        auto value_bytes = linearized(value_fragments);
+        bytes_view value(value_bytes);
         switch (count_cell) {
         case 0:
             // The silly "cql row marker" cell
@@ -642,7 +647,7 @@ class ttl_row_consumer : public count_row_consumer {
             BOOST_REQUIRE(expiration == 1430154618);
             break;
         }
-        count_row_consumer::consume_cell(col_name, value, timestamp, ttl, expiration);
+        count_row_consumer::consume_cell(col_name, value_fragments, timestamp, ttl, expiration);
         return proceed::yes;
     }
 };
@@ -1303,3 +1308,153 @@ SEASTAR_TEST_CASE(test_skipping_in_compressed_stream) {
         expect_eof(in);
     });
 }
+
+// The compressed data source reads ahead a growing number of chunks. Check
+// that skipping into the chunks read but not decompressed yet, into the
+// read in flight and past it, and closing with a read in flight, all work.
+SEASTAR_TEST_CASE(test_skipping_in_compressed_stream_with_read_ahead) {
+    return seastar::async([] {
+        tmpdir tmp;
+        auto file_path = (tmp.path() / "test").string();
+        file f = open_file_dma(file_path, open_flags::create | open_flags::wo).get0();
+
+        compression_parameters cp({
+            { compression_parameters::SSTABLE_COMPRESSION, "LZ4Compressor" },
+            { compression_parameters::CHUNK_LENGTH_KB, "4" },
+        });
+
+        sstables::compression c;
+        auto out = make_compressed_file_m_format_output_stream(f, file_output_stream_options(), &c, cp);
+
+        // Poorly compressible, and such that every position can be told apart.
+        auto byte_at = [] (uint64_t pos) {
+            return char((pos * 2654435761u) >> 13);
+        };
+        const uint64_t chunk = c.uncompressed_chunk_length();
+        const uint64_t uncompressed_size = 64 * chunk + 1000;
+        temporary_buffer<char> data(uncompressed_size);
+        for (uint64_t i = 0; i < uncompressed_size; ++i) {
+            data.get_write()[i] = byte_at(i);
+        }
+        out.write(data.get(), data.size()).get();
+        out.close().get();
+        c.update(f.size().get0());
+
+        file_input_stream_options opts;
+        opts.read_ahead = 0;
+        // Room for several chunks per read.
+        opts.buffer_size = 16 * chunk;
+
+        auto make_is = [&] (bool sample_read_size = false) {
+            f = open_file_dma(file_path, open_flags::ro).get0();
+            return make_compressed_file_m_format_input_stream(f, &c, 0, uncompressed_size, opts, sample_read_size);
+        };
+
+        uint64_t pos = 0;
+        auto expect = [&] (input_stream<char>& in, size_t n) {
+            auto b = in.read_exactly(n).get0();
+            BOOST_REQUIRE_EQUAL(b.size(), n);
+            for (size_t i = 0; i < n; ++i) {
+                if (b[i] != byte_at(pos + i)) {
+                    BOOST_FAIL(format("Wrong data at position {}", pos + i));
+                }
+            }
+            pos += n;
+        };
+        auto skip_to = [&] (input_stream<char>& in, uint64_t new_pos) {
+            in.skip(new_pos - pos).get();
+            pos = new_pos;
+        };
+        auto expect_eof = [] (input_stream<char>& in) {
+            auto b = in.read().get0();
+            BOOST_REQUIRE(b.empty());
+        };
+
+        {
+            // Reading chunk 0 starts reading chunks 1-2.
+            auto in = make_is();
+            pos = 0;
+            expect(in, 100);
+            // Into the read in flight.
+            skip_to(in, 2 * chunk + 10);
+            expect(in, 2 * chunk);
+            in.close().get();
+        }
+
+        {
+            auto in = make_is();
+            pos = 0;
+            // Chunk 0, then chunks 1-2, then 3-6 are read.
+            expect(in, 3 * chunk + 10);
+            // Chunks 4-6 are read but not decompressed, skip into the last one.
+            skip_to(in, 6 * chunk + 20);
+            expect(in, chunk - 20);
+            // Chunks 7-8 are in flight, skip past them.
+            skip_to(in, 20 * chunk + 30);
+            expect(in, 3 * chunk);
+            // Within the chunk consumed last.
+            skip_to(in, pos + 10);
+            expect(in, 10);
+            // To the last, partial, chunk and past the end.
+            skip_to(in, 64 * chunk + 500);
+            expect(in, 500);
+            expect_eof(in);
+            in.close().get();
+        }
+
+        {
+            // Random reads and skips.
+            auto seed = std::random_device{}();
+            BOOST_TEST_MESSAGE(format("seed: {}", seed));
+            std::mt19937 gen(seed);
+            for (int i = 0; i < 20; ++i) {
+                auto in = make_is();
+                pos = 0;
+                while (pos < uncompressed_size) {
+                    auto n = std::uniform_int_distribution<uint64_t>(0, std::min<uint64_t>(4 * chunk, uncompressed_size - pos))(gen);
+                    if (std::uniform_int_distribution<int>(0, 2)(gen)) {
+                        expect(in, n);
+                    } else {
+                        skip_to(in, pos + n);
+                    }
+                }
+                expect_eof(in);
+                in.close().get();
+            }
+        }
+
+        {
+            // Close with the read of chunks 1-2 in flight.
+            auto in = make_is();
+            pos = 0;
+            expect(in, 100);
+            in.close().get();
+
+            // And after a skip, which reset the read-ahead.
+            in = make_is();
+            pos = 0;
+            expect(in, 5 * chunk);
+            skip_to(in, 30 * chunk);
+            expect(in, 10);
+            in.close().get();
+        }
+
+        {
+            // Sampled streams record the bytes consumed on close().
+            auto sampled = c.stats.sampled_reads;
+            auto in = make_is(true);
+            pos = 0;
+            expect(in, 100);
+            skip_to(in, 3 * chunk);
+            expect(in, 2 * chunk);
+            in.close().get();
+            BOOST_REQUIRE_EQUAL(c.stats.sampled_reads, sampled + 1);
+
+            in = make_is();
+            pos = 0;
+            expect(in, 100);
+            in.close().get();
+            BOOST_REQUIRE_EQUAL(c.stats.sampled_reads, sampled + 1);
+        }
+    });
+}
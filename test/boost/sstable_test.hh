@@ -63,6 +63,19 @@ class column_family_test {
     static int64_t calculate_shard_from_sstable_generation(int64_t generation) {
         return column_family::calculate_shard_from_sstable_generation(generation);
     }
+
+    // Replaces the active memtable with an empty one and returns the old one,
+    // which stays readable until it is flushed.
+    static lw_shared_ptr<memtable> switch_memtable(column_family& cf) {
+        auto old = cf._memtables->back();
+        cf._memtables->add_memtable();
+        return old;
+    }
+
+    // Makes a single flush attempt, without the retries of a regular flush.
+    static future<stop_iteration> try_flush_memtable_to_sstable(column_family& cf, lw_shared_ptr<memtable> mt) {
+        return cf.try_flush_memtable_to_sstable(std::move(mt), sstable_write_permit::unconditional());
+    }
 };
 
 namespace sstables {
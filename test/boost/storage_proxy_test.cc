@@ -28,6 +28,7 @@
 #include "test/lib/mutation_source_test.hh"
 #include "test/lib/result_set_assertions.hh"
 #include "service/storage_proxy.hh"
+#include "database.hh"
 #include "partition_slice_builder.hh"
 #include "schema_builder.hh"
 
@@ -112,3 +113,81 @@ SEASTAR_TEST_CASE(test_get_restricted_ranges) {
         });
     });
 }
+
+SEASTAR_THREAD_TEST_CASE(test_prioritize_targets_by_latency) {
+    using namespace std::chrono_literals;
+    gms::inet_address a("10.0.0.1"), b("10.0.0.2"), c("10.0.0.3"), extra("10.0.0.4");
+    std::map<std::pair<gms::inet_address, replica_read_kind>, std::chrono::microseconds> latencies;
+    auto estimate = [&] (gms::inet_address ep, replica_read_kind kind) -> std::optional<std::chrono::microseconds> {
+        auto it = latencies.find({ep, kind});
+        if (it == latencies.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    };
+
+    // Nothing is known, the snitch order is kept.
+    std::vector<gms::inet_address> targets{a, b, c, extra};
+    BOOST_REQUIRE(!service::prioritize_targets_by_latency(targets, 3, 1, estimate));
+    BOOST_REQUIRE(targets == std::vector<gms::inet_address>({a, b, c, extra}));
+
+    // The fastest data replica serves the data request, even if it is a slow
+    // digest replica, and the extra target is never picked.
+    latencies[{a, replica_read_kind::data}] = 500us;
+    latencies[{b, replica_read_kind::data}] = 300us;
+    latencies[{c, replica_read_kind::data}] = 400us;
+    latencies[{extra, replica_read_kind::data}] = 100us;
+    latencies[{a, replica_read_kind::digest}] = 200us;
+    latencies[{b, replica_read_kind::digest}] = 900us;
+    latencies[{c, replica_read_kind::digest}] = 250us;
+    auto delay = service::prioritize_targets_by_latency(targets, 3, 1, estimate);
+    BOOST_REQUIRE(targets == std::vector<gms::inet_address>({b, a, c, extra}));
+    // b's data latency, not its digest one, bounds the delay.
+    BOOST_REQUIRE(delay == 300us);
+
+    // The data latency of every data target counts.
+    targets = {a, b, c, extra};
+    delay = service::prioritize_targets_by_latency(targets, 3, 2, estimate);
+    BOOST_REQUIRE(targets == std::vector<gms::inet_address>({b, a, c, extra}));
+    BOOST_REQUIRE(delay == 500us);
+
+    // A replica we wait for without an estimation makes the delay unknown,
+    // but the data replica is still picked from the known ones.
+    latencies.erase({c, replica_read_kind::digest});
+    targets = {a, b, c, extra};
+    BOOST_REQUIRE(!service::prioritize_targets_by_latency(targets, 3, 1, estimate));
+    BOOST_REQUIRE(targets == std::vector<gms::inet_address>({b, a, c, extra}));
+}
+
+SEASTAR_TEST_CASE(test_replica_read_latency_estimation) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        using namespace std::chrono_literals;
+        e.execute_cql("create table cf (p int primary key, v int)").get();
+        auto& cf = e.local_db().find_column_family("ks", "cf");
+        gms::inet_address ep("10.0.0.2");
+
+        for (int i = 0; i < 100; ++i) {
+            cf.add_replica_read_latency(ep, replica_read_kind::digest, 1ms);
+            cf.add_replica_read_latency(ep, replica_read_kind::mutation_data, 100ms);
+        }
+        // Data reads are tracked apart from digest and mutation data ones.
+        BOOST_REQUIRE(!cf.estimate_replica_read_latency(ep, replica_read_kind::data, 0.99));
+        for (int i = 0; i < 100; ++i) {
+            cf.add_replica_read_latency(ep, replica_read_kind::data, 10ms);
+        }
+        auto digest = *cf.get_replica_read_latency_percentile(ep, replica_read_kind::digest, 0.99);
+        auto data = *cf.get_replica_read_latency_percentile(ep, replica_read_kind::data, 0.99);
+        BOOST_REQUIRE_LT(digest.count(), 2000);
+        BOOST_REQUIRE_GT(data.count(), 5000);
+        BOOST_REQUIRE_LT(data.count(), 20000);
+
+        // A warm replica isn't penalized, a cold one is, and one which doesn't
+        // report its hit rate is estimated by its latencies alone.
+        cf.set_hit_rate(ep, cache_temperature(1.0f));
+        BOOST_REQUIRE(cf.estimate_replica_read_latency(ep, replica_read_kind::data, 0.99) == data);
+        cf.set_hit_rate(ep, cache_temperature(0.0f));
+        BOOST_REQUIRE(cf.estimate_replica_read_latency(ep, replica_read_kind::data, 0.99) == 2 * data);
+        cf.set_hit_rate(ep, cache_temperature::invalid());
+        BOOST_REQUIRE(cf.estimate_replica_read_latency(ep, replica_read_kind::data, 0.99) == data);
+    });
+}
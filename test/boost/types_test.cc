@@ -494,6 +494,125 @@ BOOST_AUTO_TEST_CASE(test_compound_type_compare) {
         type.serialize_value({bytes("c"), bytes("b"), bytes("c")})) < 0);
 }
 
+static void verify_comparable_bytes(data_type t, const std::vector<bytes>& values) {
+    for (auto&& v1 : values) {
+        for (auto&& v2 : values) {
+            auto expected = t->compare(v1, v2);
+            auto actual = compare_unsigned(t->to_comparable_bytes(v1), t->to_comparable_bytes(v2));
+            BOOST_REQUIRE_MESSAGE((expected < 0) == (actual < 0) && (expected > 0) == (actual > 0),
+                format("{}: {} vs {}: expected {}, got {}", t->name(), to_hex(v1), to_hex(v2), expected, actual));
+        }
+    }
+}
+
+static std::vector<bytes> values_from_strings(data_type t, std::vector<sstring> strings) {
+    return boost::copy_range<std::vector<bytes>>(strings | boost::adaptors::transformed([&] (const sstring& s) {
+        return t->from_string(s);
+    }));
+}
+
+BOOST_AUTO_TEST_CASE(test_comparable_bytes) {
+    verify_comparable_bytes(int32_type, values_from_strings(int32_type,
+            {"", "-2147483648", "-256", "-1", "0", "1", "255", "256", "2147483647"}));
+    verify_comparable_bytes(long_type, values_from_strings(long_type,
+            {"", "-9223372036854775808", "-1", "0", "1", "9223372036854775807"}));
+    verify_comparable_bytes(boolean_type, {bytes(), boolean_type->decompose(false), boolean_type->decompose(true)});
+    verify_comparable_bytes(timestamp_type, {bytes(),
+            timestamp_type->decompose(db_clock::time_point(db_clock::duration(-1000))),
+            timestamp_type->decompose(db_clock::time_point(db_clock::duration(0))),
+            timestamp_type->decompose(db_clock::time_point(db_clock::duration(1000)))});
+    verify_comparable_bytes(simple_date_type, values_from_strings(simple_date_type,
+            {"", "1900-01-01", "1970-01-01", "2020-02-29", "9999-12-31"}));
+
+    auto verify_floating = [] (auto zero, data_type t) {
+        using T = decltype(zero);
+        auto limits = std::numeric_limits<T>();
+        verify_comparable_bytes(t, {bytes(),
+                t->decompose(limits.quiet_NaN()), t->decompose(-limits.quiet_NaN()),
+                t->decompose(limits.infinity()), t->decompose(-limits.infinity()),
+                t->decompose(limits.max()), t->decompose(limits.lowest()), t->decompose(limits.denorm_min()),
+                t->decompose(T(0.)), t->decompose(T(-0.)), t->decompose(T(1.5)), t->decompose(T(-1.5))});
+    };
+    verify_floating(float(0), float_type);
+    verify_floating(double(0), double_type);
+
+    auto varints = values_from_strings(varint_type, {"", "-1000000000000000000000", "-257", "-256", "-255",
+            "-129", "-128", "-1", "0", "1", "127", "128", "255", "256", "1000000000000000000000"});
+    varints.push_back(from_hex("00ff"));
+    varints.push_back(from_hex("ffff"));
+    varints.push_back(from_hex("000000"));
+    verify_comparable_bytes(varint_type, varints);
+
+    verify_comparable_bytes(decimal_type, values_from_strings(decimal_type, {"", "-1e10", "-12.5", "-1.3", "-1.25",
+            "-1.2", "-1", "-1.00", "-0.001", "0", "0.00", "0e5", "0.001", "1", "1.0", "1.00", "1.2", "1.25", "1.3",
+            "10", "12.5", "1e10", "1.23e-2", "0.0123"}));
+
+    verify_comparable_bytes(bytes_type, {bytes(), from_hex("00"), from_hex("0000"), from_hex("0001"), from_hex("01"),
+            from_hex("6100"), from_hex("61"), from_hex("6162"), from_hex("ff"), from_hex("ff00")});
+    verify_comparable_bytes(utf8_type, values_from_strings(utf8_type, {"", "a", "aa", "ab", "b", "zzz"}));
+
+    verify_comparable_bytes(timeuuid_type, values_from_strings(timeuuid_type, {"",
+            "00000000-0000-1000-8000-000000000000",
+            "6d2d0a00-6ae5-11ea-8000-000000000000",
+            "6d2d0a00-6ae5-11ea-ffff-ffffffffffff",
+            "6d2d0a01-6ae5-11ea-8000-000000000000",
+            "ffffffff-ffff-1fff-7f7f-7f7f7f7f7f7f"}));
+    verify_comparable_bytes(uuid_type, values_from_strings(uuid_type, {"",
+            "00000000-0000-1000-8000-000000000000",
+            "6d2d0a00-6ae5-11ea-8000-000000000000",
+            "6d2d0a01-6ae5-11ea-8000-000000000000",
+            "00000000-0000-4000-8000-000000000000",
+            "ffffffff-ffff-4fff-bfff-ffffffffffff"}));
+
+    auto rev_int = reversed_type_impl::get_instance(int32_type);
+    verify_comparable_bytes(rev_int, values_from_strings(int32_type, {"", "-1", "0", "1"}));
+    auto rev_utf8 = reversed_type_impl::get_instance(utf8_type);
+    verify_comparable_bytes(rev_utf8, values_from_strings(utf8_type, {"", "a", "aa", "ab", "b"}));
+
+    auto list_type = list_type_impl::get_instance(utf8_type, false);
+    auto make_list = [&] (std::vector<sstring> elements) {
+        return list_type->decompose(make_list_value(list_type, boost::copy_range<list_type_impl::native_type>(
+                elements | boost::adaptors::transformed([] (const sstring& e) { return data_value(e); }))));
+    };
+    verify_comparable_bytes(list_type, {make_list({}), make_list({""}), make_list({"", ""}), make_list({"a"}),
+            make_list({"a", "b"}), make_list({"aa"}), make_list({"b"})});
+
+    auto map_type = map_type_impl::get_instance(int32_type, utf8_type, false);
+    auto make_map = [&] (std::vector<std::pair<int32_t, sstring>> elements) {
+        return map_type->decompose(make_map_value(map_type, boost::copy_range<map_type_impl::native_type>(
+                elements | boost::adaptors::transformed([] (auto& e) { return std::make_pair(data_value(e.first), data_value(e.second)); }))));
+    };
+    verify_comparable_bytes(map_type, {bytes(), make_map({}), make_map({{1, "a"}}), make_map({{1, "b"}}),
+            make_map({{1, "a"}, {2, "a"}}), make_map({{2, ""}})});
+
+    auto tuple_type = tuple_type_impl::get_instance({int32_type, utf8_type, int32_type});
+    auto make_tuple = [&] (std::vector<bytes_opt> elements) {
+        return tuple_type->build_value(std::move(elements));
+    };
+    verify_comparable_bytes(tuple_type, {make_tuple({}), make_tuple({std::nullopt}),
+            make_tuple({std::nullopt, std::nullopt, std::nullopt}), make_tuple({int32_type->decompose(1)}),
+            make_tuple({int32_type->decompose(1), std::nullopt}), make_tuple({int32_type->decompose(1), utf8_type->decompose("a")}),
+            make_tuple({int32_type->decompose(1), std::nullopt, int32_type->decompose(1)}),
+            make_tuple({int32_type->decompose(2)})});
+
+    compound_type<allow_prefixes::yes> type({int32_type, rev_utf8});
+    std::vector<bytes> keys = {
+        type.serialize_value(std::vector<bytes>{}),
+        type.serialize_value({int32_type->decompose(1)}),
+        type.serialize_value({int32_type->decompose(1), utf8_type->decompose("a")}),
+        type.serialize_value({int32_type->decompose(1), utf8_type->decompose("b")}),
+        type.serialize_value({int32_type->decompose(2)}),
+        type.serialize_value({int32_type->decompose(2), utf8_type->decompose("")}),
+    };
+    for (auto&& k1 : keys) {
+        for (auto&& k2 : keys) {
+            auto expected = type.compare(k1, k2);
+            auto actual = compare_unsigned(type.to_comparable_bytes(k1), type.to_comparable_bytes(k2));
+            BOOST_REQUIRE((expected < 0) == (actual < 0) && (expected > 0) == (actual > 0));
+        }
+    }
+}
+
 template <typename T>
 std::optional<T>
 extract(data_value a) {
@@ -33,6 +33,7 @@
 #include "db/config.hh"
 #include "test/lib/tmpdir.hh"
 #include "test/lib/exception_utils.hh"
+#include "lua.hh"
 
 using ire = exceptions::invalid_request_exception;
 using exception_predicate::message_equals;
@@ -975,6 +976,71 @@ SEASTAR_TEST_CASE(test_user_function) {
     });
 }
 
+SEASTAR_TEST_CASE(test_user_function_globals_are_per_call) {
+    return with_udf_enabled([] (cql_test_env& e) {
+        e.execute_cql("CREATE TABLE my_table (key int PRIMARY KEY, val int);").get();
+        for (int i = 0; i < 3; ++i) {
+            e.execute_cql(format("INSERT INTO my_table (key, val) VALUES ({}, {});", i, i)).get();
+        }
+        auto ones = std::vector<std::vector<bytes_opt>>{{serialized(int32_t(1))}, {serialized(int32_t(1))}, {serialized(int32_t(1))}};
+        e.execute_cql("CREATE FUNCTION my_func(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                "'if calls == nil then calls = 0 end calls = calls + 1 return calls';").get();
+        auto msg = e.execute_cql("SELECT my_func(val) FROM my_table;").get0();
+        assert_that(msg).is_rows().with_rows(ones);
+
+        // Through _G.
+        e.execute_cql("CREATE FUNCTION my_func2(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                "'if _G.calls == nil then _G.calls = 0 end _G.calls = _G.calls + 1 return calls';").get();
+        msg = e.execute_cql("SELECT my_func2(val) FROM my_table;").get0();
+        assert_that(msg).is_rows().with_rows(ones);
+
+        // Into a library table.
+        e.execute_cql("CREATE FUNCTION my_func3(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                "'if table.calls == nil then table.calls = 0 end table.calls = table.calls + 1 return table.calls';").get();
+        msg = e.execute_cql("SELECT my_func3(val) FROM my_table;").get0();
+        assert_that(msg).is_rows().with_rows(ones);
+
+        // Replacing a library function.
+        e.execute_cql("CREATE FUNCTION my_func4(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                "'local t = {} table.insert(t, val) table.insert = nil return #t';").get();
+        msg = e.execute_cql("SELECT my_func4(val) FROM my_table;").get0();
+        assert_that(msg).is_rows().with_rows(ones);
+
+        // The metatables all calls share are out of reach.
+        e.execute_cql("CREATE FUNCTION my_func5(val int) CALLED ON NULL INPUT RETURNS int LANGUAGE Lua AS "
+                "'if getmetatable(\"\") == false then return 1 end return 0';").get();
+        msg = e.execute_cql("SELECT my_func5(val) FROM my_table;").get0();
+        assert_that(msg).is_rows().with_rows(ones);
+    });
+}
+
+SEASTAR_THREAD_TEST_CASE(test_user_function_throughput) {
+    db::config db_cfg;
+    auto cfg = lua::make_runtime_config(db_cfg);
+    auto bitcode = lua::compile(cfg, {"val"}, "return 2 * val");
+    constexpr int32_t row_count = 10000;
+    std::vector<std::vector<data_value>> rows;
+    rows.reserve(row_count);
+    for (int32_t i = 0; i < row_count; ++i) {
+        rows.push_back({data_value(i)});
+    }
+    auto check = [] (const bytes& result, int32_t arg) {
+        BOOST_REQUIRE_EQUAL(value_cast<int32_t>(int32_type->deserialize(result)), 2 * arg);
+    };
+    auto measure = [] (auto&& func) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto elapsed = measure([&] {
+        for (int32_t i = 0; i < row_count; ++i) {
+            check(lua::run_script(lua::bitcode_view{bitcode}, rows[i], int32_type, cfg).get0(), i);
+        }
+    });
+    BOOST_TEST_MESSAGE(format("{} calls: {:.0f} calls/s", row_count, row_count / elapsed));
+}
+
 SEASTAR_THREAD_TEST_CASE(test_user_function_db_init) {
     tmpdir data_dir;
     auto db_cfg_ptr = make_shared<db::config>();
@@ -24,6 +24,7 @@
 #include "database.hh"
 #include "db/view/view_builder.hh"
 #include "db/system_keyspace.hh"
+#include "db/config.hh"
 
 #include <seastar/testing/test_case.hh>
 #include "test/lib/cql_test_env.hh"
@@ -80,6 +81,37 @@ SEASTAR_TEST_CASE(test_builder_with_large_partition) {
     });
 }
 
+SEASTAR_TEST_CASE(test_builder_bulk_mode) {
+    cql_test_config cfg;
+    cfg.db_config->view_building_bulk_mode(true, db::config::config_source::CommandLine);
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+
+        // More partitions than populates in flight, and more rows than a
+        // bulk step consumes, on any shard.
+        auto rows = 2 * smp::count * db::view::view_builder::bulk_batch_size;
+        for (size_t i = 0; i < rows; ++i) {
+            e.execute_cql(format("insert into cf (p, c, v) values ({:d}, {:d}, {:d})", i, i % 4, i % 16)).get();
+        }
+
+        auto f = e.local_view_builder().wait_until_built("ks", "vcf");
+        e.execute_cql("create materialized view vcf as select * from cf "
+                      "where p is not null and c is not null and v is not null "
+                      "primary key (v, c, p)").get();
+
+        f.get();
+        for (auto v = 0; v < 16; ++v) {
+            auto msg = e.execute_cql(format("select count(*) from vcf where v = {:d}", v)).get0();
+            assert_that(msg).is_rows().with_rows({{{long_type->decompose(int64_t(rows / 16))}}});
+        }
+
+        auto steps = e.db().map_reduce0([] (database& db) {
+            return db.find_column_family("ks", "cf").cf_stats()->view_building_steps;
+        }, int64_t(0), [] (int64_t a, int64_t b) { return std::max(a, b); }).get0();
+        BOOST_REQUIRE_GT(steps, 1);
+    }, cfg);
+}
+
 // This test reproduces issue #4213. We have a large base partition with
 // many rows, and the view has the *same* partition key as the base, so all
 // the generated view rows will go to the same view partition. The view
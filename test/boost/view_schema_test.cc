@@ -22,6 +22,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <boost/range/adaptor/map.hpp>
+#include <boost/range/irange.hpp>
 
 #include "database.hh"
 #include "types/user.hh"
@@ -4370,3 +4371,38 @@ SEASTAR_TEST_CASE(test_mv_allow_some_column_drops) {
         BOOST_REQUIRE_THROW(e.execute_cql("alter table cf2 drop d").get(), exceptions::invalid_request_exception);
     });
 }
+
+// Concurrent writes to different rows of the same base partition may share the
+// read of existing rows. Each of them must still see its own rows, so that the
+// view rows of the old values get deleted.
+SEASTAR_TEST_CASE(test_concurrent_updates_to_same_partition) {
+    return do_with_cql_env_thread([] (cql_test_env& e) {
+        static constexpr int rows = 20;
+        e.execute_cql("create table cf (p int, c int, v int, primary key (p, c))").get();
+        e.execute_cql("create materialized view mv as select * from cf "
+                      "where p is not null and c is not null and v is not null primary key (v, p, c)").get();
+        for (int c = 0; c < rows; ++c) {
+            e.execute_cql(format("insert into cf (p, c, v) values (0, {}, {})", c, c)).get();
+        }
+        auto& view_stats = e.local_db().find_column_family("ks", "cf").get_view_stats();
+        auto reads_before = view_stats.view_update_base_reads;
+        auto cs = boost::irange(0, rows);
+        parallel_for_each(cs.begin(), cs.end(), [&e] (int c) {
+            return e.execute_cql(format("update cf set v = {} where p = 0 and c = {}", c + rows, c)).discard_result();
+        }).get();
+        // Every update read the rows it changes, and some shared a read.
+        BOOST_REQUIRE_EQUAL(view_stats.view_update_base_reads - reads_before, rows);
+        BOOST_REQUIRE_GT(view_stats.view_update_base_reads_coalesced, 0);
+
+        eventually([&] {
+            auto msg = e.execute_cql("select v from mv").get0();
+            assert_that(msg).is_rows().with_size(rows);
+            for (int c = 0; c < rows; ++c) {
+                msg = e.execute_cql(format("select p, c from mv where v = {}", c)).get0();
+                assert_that(msg).is_rows().with_size(0);
+                msg = e.execute_cql(format("select p, c from mv where v = {}", c + rows)).get0();
+                assert_that(msg).is_rows().with_rows({{int32_type->decompose(0), int32_type->decompose(c)}});
+            }
+        });
+    });
+}
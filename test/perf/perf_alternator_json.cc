@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <seastar/core/memory.hh>
+
+#include "test/perf/perf.hh"
+#include "alternator/rjson.hh"
+
+// Times the JSON work Alternator does for a PutItem request and a GetItem
+// response, and counts the allocations it takes.
+
+static std::string make_item(int attributes) {
+    std::string item = "{\"p\":{\"S\":\"partition-key-0123456789\"},\"c\":{\"N\":\"12345\"}";
+    for (int i = 0; i < attributes; ++i) {
+        item += format(",\"attribute{}\":{{\"S\":\"value of attribute {} which is not very short\"}}", i, i);
+    }
+    return item + "}";
+}
+
+template <typename Func>
+static void run(const char* name, Func func) {
+    auto mallocs = memory::stats().mallocs();
+    constexpr int iterations = 1000;
+    for (int i = 0; i < iterations; ++i) {
+        func();
+    }
+    std::cout << name << ": " << (memory::stats().mallocs() - mallocs) / iterations << " allocations per request\n";
+    time_it(func);
+}
+
+int main(int argc, char* argv[]) {
+    for (int attributes : {4, 64}) {
+        std::cout << "Item with " << attributes << " attributes\n";
+        auto item = make_item(attributes);
+        auto put_item = "{\"TableName\":\"table\",\"Item\":" + item + "}";
+        auto get_item_response = rjson::parse("{\"Item\":" + item + "}");
+
+        run("PutItem request parsing", [&] {
+            auto v = rjson::parse(put_item);
+        });
+        run("GetItem response printing, contiguous", [&] {
+            auto s = rjson::print(get_item_response);
+        });
+        run("GetItem response printing, chunked", [&] {
+            auto chunks = rjson::print_chunked(get_item_response);
+        });
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "seastar/include/seastar/testing/perf_tests.hh"
+#include <seastar/testing/test_runner.hh>
+
+#include <random>
+
+#include "compound.hh"
+#include "utils/UUID_gen.hh"
+#include "utils/big_decimal.hh"
+
+// Compares keys with compound_type::compare() against compare_unsigned()
+// of their byte-comparable encodings.
+class comparable_keys {
+public:
+    static constexpr size_t count = 1000;
+private:
+    compound_type<> _type;
+    std::vector<bytes> _keys;
+    std::vector<bytes> _encoded;
+public:
+    comparable_keys(std::vector<data_type> types, std::function<std::vector<bytes> (std::default_random_engine&)> make_key)
+        : _type(std::move(types))
+    {
+        auto eng = seastar::testing::local_random_engine;
+        for (auto i = 0u; i < count; i++) {
+            _keys.push_back(_type.serialize_value(make_key(eng)));
+        }
+        // Adjacent keys share a prefix, like neighbours in a sorted run do.
+        std::sort(_keys.begin(), _keys.end(), [this] (const bytes& k1, const bytes& k2) {
+            return _type.compare(k1, k2) < 0;
+        });
+        for (auto& k : _keys) {
+            _encoded.push_back(_type.to_comparable_bytes(k));
+        }
+    }
+
+    size_t compare_keys() const {
+        for (auto i = 1u; i < count; i++) {
+            perf_tests::do_not_optimize(_type.compare(_keys[i - 1], _keys[i]));
+        }
+        return count - 1;
+    }
+    size_t compare_encoded() const {
+        for (auto i = 1u; i < count; i++) {
+            perf_tests::do_not_optimize(compare_unsigned(_encoded[i - 1], _encoded[i]));
+        }
+        return count - 1;
+    }
+    size_t encode() const {
+        for (auto& k : _keys) {
+            perf_tests::do_not_optimize(_type.to_comparable_bytes(k));
+        }
+        return count;
+    }
+};
+
+static sstring random_text(std::default_random_engine& eng, size_t size) {
+    auto dist = std::uniform_int_distribution<char>('a', 'c');
+    sstring s(sstring::initialized_later(), size);
+    std::generate(s.begin(), s.end(), [&] { return dist(eng); });
+    return s;
+}
+
+struct clustering_keys : public comparable_keys {
+    clustering_keys() : comparable_keys({long_type, utf8_type, timeuuid_type}, [] (std::default_random_engine& eng) {
+        return std::vector<bytes>{
+            long_type->decompose(std::uniform_int_distribution<int64_t>(0, 16)(eng)),
+            utf8_type->decompose(random_text(eng, 16)),
+            utils::UUID_gen::get_time_UUID().serialize(),
+        };
+    }) { }
+};
+
+struct decimal_keys : public comparable_keys {
+    decimal_keys() : comparable_keys({decimal_type}, [] (std::default_random_engine& eng) {
+        auto scale = std::uniform_int_distribution<int32_t>(0, 8)(eng);
+        auto unscaled = std::uniform_int_distribution<int64_t>(-1000000000, 1000000000)(eng);
+        return std::vector<bytes>{
+            decimal_type->decompose(big_decimal(scale, boost::multiprecision::cpp_int(unscaled))),
+        };
+    }) { }
+};
+
+PERF_TEST_F(clustering_keys, tri_compare) {
+    return compare_keys();
+}
+
+PERF_TEST_F(clustering_keys, comparable_bytes) {
+    return compare_encoded();
+}
+
+PERF_TEST_F(clustering_keys, encode) {
+    return encode();
+}
+
+PERF_TEST_F(decimal_keys, tri_compare) {
+    return compare_keys();
+}
+
+PERF_TEST_F(decimal_keys, comparable_bytes) {
+    return compare_encoded();
+}
+
+PERF_TEST_F(decimal_keys, encode) {
+    return encode();
+}
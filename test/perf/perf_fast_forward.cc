@@ -962,6 +962,35 @@ class large_part_ds1 : public simple_large_part_ds {
     }
 };
 
+// Rows are 3/4 of the default compression chunk long and incompressible,
+// so most of them straddle a chunk boundary. The number of rows is scaled
+// so the partition has as many bytes as large-part-ds1.
+class large_part_ds2 : public simple_large_part_ds {
+    static constexpr int row_size = compression_parameters::DEFAULT_CHUNK_LENGTH * 3 / 4;
+public:
+    large_part_ds2() : simple_large_part_ds("large-part-ds2", "One large partition with rows crossing compression chunk boundaries") {}
+
+    int n_rows(const table_config& cfg) override {
+        return std::max(1, int(int64_t(cfg.n_rows) * cfg.value_size / row_size));
+    }
+
+    generator_fn make_generator(schema_ptr s, const table_config& cfg) override {
+        auto& value_cdef = *s->get_column_definition("value");
+        auto pk = partition_key::from_single_value(*s, serialized(0));
+        return [this, s, ck = 0, n_ck = n_rows(cfg), &value_cdef, pk] () mutable -> std::optional<mutation> {
+            if (ck == n_ck) {
+                return std::nullopt;
+            }
+            auto ts = api::new_timestamp();
+            mutation m(s, pk);
+            auto& row = m.partition().clustered_row(*s, make_ck(*s, ck));
+            row.cells().apply(value_cdef, atomic_cell::make_live(*value_cdef.type, ts, serialized(make_blob(row_size))));
+            ++ck;
+            return m;
+        };
+    }
+};
+
 class small_part_ds1 : public multipart_ds, public dataset {
 public:
     small_part_ds1() : dataset("small-part", "Many small partitions with no clustering key",
@@ -1589,6 +1618,7 @@ auto make_datasets() {
     };
     add(std::make_unique<small_part_ds1>());
     add(std::make_unique<large_part_ds1>());
+    add(std::make_unique<large_part_ds2>());
     return dsets;
 }
 
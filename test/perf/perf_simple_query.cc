@@ -27,8 +27,12 @@
 #include "test/perf/perf.hh"
 #include <seastar/core/app-template.hh>
 #include <seastar/testing/test_runner.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/util/defer.hh>
 #include "schema_builder.hh"
+#include "database.hh"
 #include "release.hh"
+#include "service/qos/service_level_controller.hh"
 
 static const sstring table_name = "cf";
 
@@ -69,6 +73,12 @@ struct test_config {
     unsigned duration_in_seconds;
     bool counters;
     unsigned operations_per_shard = 0;
+    // Shares of the olap service level in the mixed workload, oltp has 1000.
+    unsigned olap_shares = 200;
+    // Whether the reads of the mixed workload go to disk rather than to the cache.
+    bool disk_bound = false;
+    // Materialized views on the written table, in the write workload.
+    unsigned views = 0;
 };
 
 std::ostream& operator<<(std::ostream& os, const test_config::run_mode& m) {
@@ -154,6 +164,88 @@ future<std::vector<double>> test_counter_update(cql_test_env& env, test_config&
         });
 }
 
+// Runs the write workload against a table with cfg.views materialized views, each keyed
+// on a different regular column, so that every write reads the existing row first.
+// Writes go to a few rows of each partition, so that concurrent writes often touch
+// the same base partition.
+future<std::vector<double>> test_write_with_views(cql_test_env& env, test_config& cfg) {
+    return seastar::async([&env, &cfg] {
+        static constexpr int rows_per_partition = 16;
+        std::cout << "Running write test with " << cfg.views << " views and config: " << cfg << std::endl;
+        env.execute_cql("CREATE TABLE cf (pk int, ck int, v0 int, v1 int, v2 int, v3 int, v4 int, PRIMARY KEY (pk, ck))").get();
+        for (unsigned i = 0; i < cfg.views; ++i) {
+            env.execute_cql(format("CREATE MATERIALIZED VIEW mv{0} AS SELECT * FROM cf "
+                    "WHERE v{0} IS NOT NULL AND pk IS NOT NULL AND ck IS NOT NULL PRIMARY KEY (v{0}, pk, ck)", i)).get();
+        }
+        auto id = env.prepare("UPDATE cf SET v0 = ?, v1 = ?, v2 = ?, v3 = ?, v4 = ? WHERE pk = ? AND ck = ?").get0();
+        return time_parallel([&env, &cfg, id] {
+            auto value = [] (int32_t v) {
+                return cql3::raw_value::make_value(int32_type->decompose(v));
+            };
+            std::vector<cql3::raw_value> values;
+            for (int i = 0; i < 5; ++i) {
+                values.push_back(value(std::rand() % 1000));
+            }
+            values.push_back(value(cfg.query_single_key ? 0 : std::rand() % cfg.partitions));
+            values.push_back(value(std::rand() % rows_per_partition));
+            return env.execute_prepared(id, std::move(values)).discard_result();
+        }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard).get0();
+    });
+}
+
+// Runs the read workload in two service levels at once, oltp and olap, to show
+// how their shares split the throughput between them. When disk bound, the data
+// is flushed and the reads bypass the cache, so that the levels compete for the
+// disk through their I/O classes and read queues rather than for the CPU.
+future<> test_mixed_read(cql_test_env& env, test_config& cfg) {
+    return seastar::async([&env, &cfg] {
+        std::cout << "Running mixed workload test with config: " << cfg << ", olap_shares=" << cfg.olap_shares
+                << ", disk_bound=" << (cfg.disk_bound ? "yes" : "no") << std::endl;
+        env.create_table([] (auto ks_name) {
+            return schema({}, ks_name, "cf",
+                    {{"KEY", bytes_type}},
+                    {},
+                    {{"C0", bytes_type}, {"C1", bytes_type}, {"C2", bytes_type}, {"C3", bytes_type}, {"C4", bytes_type}},
+                    {},
+                    utf8_type);
+        }).get();
+        create_partitions(env, cfg).get();
+        sstring query = "select \"C0\", \"C1\", \"C2\", \"C3\", \"C4\" from cf where \"KEY\" = ?";
+        if (cfg.disk_bound) {
+            env.db().invoke_on_all([] (database& db) {
+                return db.flush_all_memtables();
+            }).get();
+            query += " bypass cache";
+        }
+        auto id = env.prepare(query).get0();
+
+        auto& slc = qos::get_service_level_controller();
+        slc.start(std::ref(env.db()), current_scheduling_group()).get();
+        auto stop_slc = defer([&slc] { slc.stop().get(); });
+        slc.local().add_service_level("oltp", qos::service_level_options{1000}).get();
+        slc.local().add_service_level("olap", qos::service_level_options{int32_t(cfg.olap_shares)}).get();
+
+        auto run_in = [&env, &cfg, &slc, id] (sstring service_level) {
+            auto sg = slc.local().find_service_level(service_level)->sg;
+            return time_parallel([&env, &cfg, id, sg] {
+                return with_scheduling_group(sg, [&env, &cfg, id] {
+                    bytes key = make_key(cfg.query_single_key ? 0 : std::rand() % cfg.partitions);
+                    return env.execute_prepared(id, {{cql3::raw_value::make_value(std::move(key))}}).discard_result();
+                });
+            }, cfg.concurrency, cfg.duration_in_seconds, cfg.operations_per_shard);
+        };
+        auto results = when_all_succeed(run_in("oltp"), run_in("olap")).get();
+
+        auto median = [] (std::vector<double> r) {
+            std::sort(r.begin(), r.end());
+            return r[r.size() / 2];
+        };
+        auto oltp = median(std::get<0>(results));
+        auto olap = median(std::get<1>(results));
+        std::cout << format("\nmedian oltp: {:.2f}\nmedian olap: {:.2f}\noltp/olap: {:.2f}\n", oltp, olap, oltp / olap);
+    });
+}
+
 schema_ptr make_counter_schema(const sstring& ks_name) {
     return schema_builder(ks_name, "cf")
             .with_column("KEY", bytes_type, column_kind::partition_key)
@@ -221,6 +313,9 @@ void write_json_result(std::string result_file, const test_config& cfg, double m
     if (cfg.counters) {
         test_type += "_counters";
     }
+    if (cfg.views) {
+        test_type += format("_{}_views", cfg.views);
+    }
     results["test_properties"]["type"] = test_type;
 
     // <version>-<release>
@@ -261,6 +356,10 @@ int main(int argc, char** argv) {
         ("concurrency", bpo::value<unsigned>()->default_value(100), "workers per core")
         ("operations-per-shard", bpo::value<unsigned>(), "run this many operations per shard (overrides duration)")
         ("counters", "test counters")
+        ("mixed-workload", "run the read path in two service levels at once, oltp and olap")
+        ("views", bpo::value<unsigned>(), "in the write path, write to a table with this many materialized views (at most 5)")
+        ("olap-shares", bpo::value<unsigned>()->default_value(200), "shares of the olap service level in the mixed workload (oltp has 1000)")
+        ("disk-bound", "in the mixed workload, flush the data and bypass the cache, so that reads go to disk")
         ("json-result", bpo::value<std::string>(), "name of the json result file")
         ;
 
@@ -292,7 +391,19 @@ int main(int argc, char** argv) {
             if (app.configuration().count("operations-per-shard")) {
                 cfg.operations_per_shard = app.configuration()["operations-per-shard"].as<unsigned>();
             }
-            auto results = do_test(env, cfg).get0();
+            if (app.configuration().count("views")) {
+                cfg.views = app.configuration()["views"].as<unsigned>();
+                if (cfg.mode != test_config::run_mode::write || cfg.counters || cfg.views > 5) {
+                    throw std::invalid_argument("--views requires --write, no --counters, and at most 5 views");
+                }
+            }
+            if (app.configuration().count("mixed-workload")) {
+                cfg.olap_shares = app.configuration()["olap-shares"].as<unsigned>();
+                cfg.disk_bound = app.configuration().count("disk-bound");
+                test_mixed_read(env, cfg).get();
+                return make_ready_future<>();
+            }
+            auto results = cfg.views ? test_write_with_views(env, cfg).get0() : do_test(env, cfg).get0();
 
             std::sort(results.begin(), results.end());
             auto median = results[results.size() / 2];
@@ -94,6 +94,7 @@ int main(int argc, char** argv) {
         ("num_columns", bpo::value<unsigned>()->default_value(5), "number of columns per row")
         ("column_size", bpo::value<unsigned>()->default_value(64), "size in bytes for each column")
         ("sstables", bpo::value<unsigned>()->default_value(1), "number of sstables (valid only for compaction mode)")
+        ("clustering_rows", bpo::value<unsigned>()->default_value(0), "number of rows per partition, clustered by a bigint key (valid only for compaction mode)")
         ("mode", bpo::value<sstring>()->default_value("index_write"), "one of: sequential_read, index_read, write, compaction, index_write (default)")
         ("testdir", bpo::value<sstring>()->default_value("/var/lib/scylla/perf-tests"), "directory in which to store the sstables");
 
@@ -117,6 +118,9 @@ int main(int argc, char** argv) {
             cfg.num_columns = app.configuration()["num_columns"].as<unsigned>();
             cfg.column_size = app.configuration()["column_size"].as<unsigned>();
         }
+        if (mode == test_modes::compaction) {
+            cfg.clustering_rows = app.configuration()["clustering_rows"].as<unsigned>();
+        }
         return test->start(std::move(cfg)).then([mode, dir, test] {
             engine().at_exit([test] { return test->stop(); });
             if ((mode == test_modes::index_read) ||
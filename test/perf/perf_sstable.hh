@@ -43,6 +43,8 @@ class perf_sstable_test_env {
         unsigned num_columns;
         unsigned column_size;
         unsigned sstables;
+        // Rows per partition, clustered by a bigint key. Zero means no clustering key.
+        unsigned clustering_rows = 0;
         size_t buffer_size;
         sstring dir;
     };
@@ -82,11 +84,16 @@ class perf_sstable_test_env {
             columns.push_back(schema::column{ to_bytes(format("column{:04d}", i)), utf8_type });
         }
 
+        std::vector<schema::column> clustering_key_columns;
+        if (_cfg.clustering_rows) {
+            clustering_key_columns.push_back(schema::column{ "ck", long_type });
+        }
+
         schema_builder builder(make_lw_shared(schema(generate_legacy_id("ks", "perf-test"), "ks", "perf-test",
             // partition key
             {{"name", utf8_type}},
             // clustering key
-            {},
+            { clustering_key_columns },
             // regular columns
             { columns },
             // static columns
@@ -114,8 +121,16 @@ class perf_sstable_test_env {
         return do_for_each(idx.begin(), idx.end(), [this, local_keys = std::move(local_keys)] (auto iteration) {
             auto key = partition_key::from_deeply_exploded(*s, { local_keys.at(iteration) });
             auto mut = mutation(this->s, key);
-            for (auto& cdef: this->s->regular_columns()) {
-                mut.set_clustered_cell(clustering_key::make_empty(), cdef, atomic_cell::make_live(*utf8_type, 0, utf8_type->decompose(this->random_column())));
+            if (!_cfg.clustering_rows) {
+                for (auto& cdef: this->s->regular_columns()) {
+                    mut.set_clustered_cell(clustering_key::make_empty(), cdef, atomic_cell::make_live(*utf8_type, 0, utf8_type->decompose(this->random_column())));
+                }
+            }
+            for (unsigned row = 0; row < _cfg.clustering_rows; ++row) {
+                auto ck = clustering_key::from_singular(*s, int64_t(row));
+                for (auto& cdef: this->s->regular_columns()) {
+                    mut.set_clustered_cell(ck, cdef, atomic_cell::make_live(*utf8_type, 0, utf8_type->decompose(this->random_column())));
+                }
             }
             this->_mt->apply(std::move(mut));
             return make_ready_future<>();
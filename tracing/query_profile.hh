@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2020 ScyllaDB
+ */
+
+/*
+ * This file is part of Scylla.
+ *
+ * Scylla is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Scylla is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scylla.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "utils/UUID.hh"
+
+namespace tracing {
+
+/// Phases of a CQL request tracked by the query_profile.
+enum class query_phase : uint8_t {
+    parse,      // parsing and preparing of an unprepared statement
+    authorize,  // access checks
+    execute,    // validation and execution, including the replicas' work and the network round trips
+    respond,    // serialization of the response
+    // must be the last one
+    count,
+};
+
+const char* to_string(query_phase p);
+
+/// \brief A lightweight breakdown of a CQL request latency.
+///
+/// As opposed to a tracing session this costs only a few clock readings per
+/// request and is therefore collected for every request. Complete profiles are
+/// fed to tracing::record_query_profile() and, if the request targeted a
+/// single table, to that table's statistics.
+///
+/// Only the phases the request went through are recorded, e.g. an EXECUTE
+/// request has no parse phase.
+class query_profile {
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    clock::time_point _start;
+    std::array<clock::duration, size_t(query_phase::count)> _phases = {};
+    uint8_t _recorded = 0;
+    std::optional<utils::UUID> _table;
+
+    static_assert(size_t(query_phase::count) <= 8, "_recorded too narrow");
+
+public:
+    query_profile() : query_profile(clock::now()) { }
+
+    /// \param start when the request processing has started, e.g. on the
+    /// shard the request was received on before it bounced to another one.
+    explicit query_profile(clock::time_point start) noexcept : _start(start) { }
+
+    void add(query_phase p, clock::duration d) noexcept {
+        _phases[size_t(p)] += d;
+        _recorded |= 1u << size_t(p);
+    }
+
+    clock::duration get(query_phase p) const noexcept {
+        return _phases[size_t(p)];
+    }
+
+    /// \return true if the request went through the given phase.
+    bool has(query_phase p) const noexcept {
+        return _recorded & (1u << size_t(p));
+    }
+
+    void set_table(const utils::UUID& id) noexcept {
+        _table = id;
+    }
+
+    /// \return the id of the table targeted by the request, if it targeted a single one.
+    const std::optional<utils::UUID>& table() const noexcept {
+        return _table;
+    }
+
+    /// \return the time passed since the request processing has started.
+    clock::duration elapsed() const noexcept {
+        return clock::now() - _start;
+    }
+};
+
+/// \brief A compact record of a request slower than the slow query threshold.
+///
+/// A fixed size POD so that keeping the last few hundreds of them on every
+/// shard is cheap.
+struct slow_query_profile_record {
+    int64_t started_at_us;      // microseconds since epoch
+    uint32_t total_us;
+    std::array<uint32_t, size_t(query_phase::count)> phases_us;
+};
+
+}
@@ -95,7 +95,61 @@ tracing::tracing(const backend_registry& br, sstring tracing_backend_helper_clas
         sm::make_gauge("flushing_records", _flushing_records,
                         sm::description(seastar::format("Holds a number of tracing records that currently being written to the I/O backend. "
                                                         "If sum of this metric, cached_records and pending_for_write_records is close to {} we are likely to start dropping tracing records.", max_pending_trace_records + write_event_records_threshold))),
+
+        sm::make_histogram("query_latency", sm::description("Holds a histogram of the CQL requests latencies as seen by the query profiler."),
+                        [this] { return _query_latency.get_histogram(std::chrono::microseconds(100)); }),
+
+        sm::make_gauge("slow_query_profiles", [this] { return _slow_query_profiles.size(); },
+                        sm::description("Holds a number of slow query profile records currently kept on this shard.")),
     });
+
+    sm::label phase_label("phase");
+    for (size_t i = 0; i < _query_phase_latencies.size(); ++i) {
+        _metrics.add_group("tracing", {
+            sm::make_histogram("query_phase_latency", sm::description("Holds a histogram of the time CQL requests spend in a given phase of their processing."),
+                            [this, i] { return _query_phase_latencies[i].get_histogram(std::chrono::microseconds(10)); })(phase_label(to_string(query_phase(i)))),
+        });
+    }
+}
+
+const char* to_string(query_phase p) {
+    switch (p) {
+    case query_phase::parse: return "parse";
+    case query_phase::authorize: return "authorize";
+    case query_phase::execute: return "execute";
+    case query_phase::respond: return "respond";
+    case query_phase::count: break;
+    }
+    abort();
+}
+
+void tracing::record_query_profile(const query_profile& profile) {
+    auto to_us = [] (query_profile::clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+
+    auto total = profile.elapsed();
+    _query_latency.add(to_us(total));
+    for (size_t i = 0; i < _query_phase_latencies.size(); ++i) {
+        if (profile.has(query_phase(i))) {
+            _query_phase_latencies[i].add(to_us(profile.get(query_phase(i))));
+        }
+    }
+
+    if (total < _slow_query_duration_threshold) {
+        return;
+    }
+
+    if (_slow_query_profiles.size() >= max_slow_query_profile_records) {
+        _slow_query_profiles.pop_front();
+    }
+    slow_query_profile_record rec;
+    rec.started_at_us = std::chrono::duration_cast<std::chrono::microseconds>((std::chrono::system_clock::now() - total).time_since_epoch()).count();
+    rec.total_us = std::min<int64_t>(to_us(total), std::numeric_limits<uint32_t>::max());
+    for (size_t i = 0; i < rec.phases_us.size(); ++i) {
+        rec.phases_us[i] = std::min<int64_t>(to_us(profile.get(query_phase(i))), std::numeric_limits<uint32_t>::max());
+    }
+    _slow_query_profiles.push_back(rec);
 }
 
 future<> tracing::create_tracing(const backend_registry& br, sstring tracing_backend_class_name) {
@@ -46,12 +46,15 @@
 #include <seastar/core/sharded.hh>
 #include <seastar/core/sstring.hh>
 #include <seastar/core/metrics_registration.hh>
+#include <seastar/core/circular_buffer.hh>
 #include "gc_clock.hh"
 #include "utils/UUID.hh"
 #include "gms/inet_address.hh"
 #include "enum_set.hh"
 #include "log.hh"
 #include "seastarx.hh"
+#include "tracing/query_profile.hh"
+#include "utils/estimated_histogram.hh"
 
 namespace tracing {
 
@@ -322,6 +325,8 @@ class tracing : public seastar::async_sharded_service<tracing> {
     static constexpr int write_event_records_threshold = write_event_sessions_threshold * exp_trace_events_per_session;
     // Number of events when an info message is printed
     static constexpr int log_warning_period = 10000;
+    // maximum number of slow query profile records kept per shard
+    static constexpr size_t max_slow_query_profile_records = 1024;
 
     static const std::chrono::microseconds default_slow_query_duraion_threshold;
     static const std::chrono::seconds default_slow_query_record_ttl;
@@ -401,6 +406,11 @@ class tracing : public seastar::async_sharded_service<tracing> {
     std::ranlux48_base _gen;
     std::chrono::microseconds _slow_query_duration_threshold;
     std::chrono::seconds _slow_query_record_ttl;
+    // Latencies of CQL requests and of their phases, see query_profile
+    utils::estimated_histogram _query_latency;
+    std::array<utils::estimated_histogram, size_t(query_phase::count)> _query_phase_latencies;
+    // The last max_slow_query_profile_records profiles of requests slower than _slow_query_duration_threshold
+    circular_buffer<slow_query_profile_record> _slow_query_profiles;
 
 public:
     uint64_t get_next_rand_uint64() {
@@ -636,6 +646,23 @@ class tracing : public seastar::async_sharded_service<tracing> {
         return _slow_query_record_ttl;
     }
 
+    /**
+     * Account a completed CQL request profile
+     *
+     * Updates the histograms of the phases the request went through and, if the request took longer
+     * than the slow query threshold, stores its compact record in the slow
+     * query profiles ring, evicting the oldest record if the ring is full.
+     *
+     * This doesn't depend on the slow query logging being enabled.
+     *
+     * @param profile profile of the completed request
+     */
+    void record_query_profile(const query_profile& profile);
+
+    const circular_buffer<slow_query_profile_record>& slow_query_profiles() const {
+        return _slow_query_profiles;
+    }
+
 private:
     void write_timer_callback();
 
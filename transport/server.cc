@@ -30,6 +30,7 @@
 #include "cql3/statements/batch_statement.hh"
 #include "service/migration_manager.hh"
 #include "service/storage_service.hh"
+#include "database.hh"
 #include "db/consistency_level_type.hh"
 #include "db/write_type.hh"
 #include <seastar/core/future-util.hh>
@@ -603,8 +604,9 @@ future<> cql_server::connection::process_request() {
             // Replacing the immediately-invoked lambda below with just its body costs 5-10 usec extra per invocation.
             // Cause not understood.
             auto istream = buf.get_istream();
-            (void)_process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit)
-                    .then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
+            (void)with_scheduling_group(_scheduling_group, [this, istream, op, stream, tracing_requested, mem_permit] {
+                return _process_request_stage(this, istream, op, stream, seastar::ref(_client_state), tracing_requested, mem_permit);
+            }).then_wrapped([this, buf = std::move(buf), mem_permit, leave = std::move(leave)] (future<foreign_ptr<std::unique_ptr<cql_server::response>>> response_f) mutable {
                 try {
                     write_response(std::move(response_f.get0()), std::move(mem_permit), _compression);
                     _ready_to_respond = _ready_to_respond.finally([leave = std::move(leave)] {});
@@ -727,6 +729,9 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_au
             client_state.set_login(std::move(user));
             auto f = client_state.check_user_can_login();
             return f.then([this, stream, &client_state, challenge = std::move(challenge)]() mutable {
+                if (_server._config.get_scheduling_group_for_role) {
+                    _scheduling_group = _server._config.get_scheduling_group_for_role(client_state.user()->name);
+                }
                 auto tr_state = client_state.get_trace_state();
                 return make_ready_future<std::unique_ptr<cql_server::response>>(make_auth_success(stream, std::move(challenge), tr_state));
             });
@@ -746,17 +751,31 @@ cql_server::connection::init_cql_serialization_format() {
     _cql_serialization_format = cql_serialization_format(_version);
 }
 
-std::unique_ptr<cql_server::response>
-make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
-        cql_protocol_version_type version, bool skip_metadata = false);
+// Serializes the response and feeds the complete request profile to the query profiler
+// and, if the request targeted a single table, to that table's statistics.
+static std::unique_ptr<cql_server::response>
+make_profiled_result(int16_t stream, messages::result_message& msg, service::query_state& query_state, database& db,
+        cql_protocol_version_type version, bool skip_metadata = false) {
+    auto respond_start = tracing::query_profile::clock::now();
+    auto response = make_result(stream, msg, query_state.get_trace_state(), version, skip_metadata);
+    auto& profile = query_state.get_query_profile();
+    profile.add(tracing::query_phase::respond, tracing::query_profile::clock::now() - respond_start);
+    tracing::tracing::get_local_tracing_instance().record_query_profile(profile);
+    if (profile.table() && db.column_family_exists(*profile.table())) {
+        db.find_column_family(*profile.table()).add_query_profile(profile);
+    }
+    return response;
+}
 
 static future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>
 process_query_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
-        const cql3::cql_config& cql_config, const ::timeout_config& timeout_config, service_permit permit, bool init_trace) {
+        const cql3::cql_config& cql_config, const ::timeout_config& timeout_config, service_permit permit, bool init_trace,
+        tracing::query_profile::clock::time_point start) {
     auto query = in.read_long_string_view();
     auto q_state = std::make_unique<cql_query_state>(client_state, std::move(permit));
     auto& query_state = q_state->query_state;
+    query_state.get_query_profile() = tracing::query_profile(start);
     q_state->options = in.read_options(version, serialization_format, timeout_config, cql_config);
     auto& options = *q_state->options;
     auto skip_metadata = options.skip_metadata();
@@ -771,28 +790,28 @@ process_query_internal(service::client_state& client_state, distributed<cql3::qu
         tracing::begin(query_state.get_trace_state(), "Execute CQL3 query", client_state.get_client_address());
     }
 
-    return qp.local().process(query, query_state, options).then([q_state = std::move(q_state), stream, skip_metadata, version] (auto msg) {
+    return qp.local().process(query, query_state, options).then([&qp, q_state = std::move(q_state), stream, skip_metadata, version] (auto msg) {
         if (msg->move_to_shard()) {
             return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(*msg->move_to_shard());
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(make_foreign(make_profiled_result(stream, *msg, q_state->query_state, qp.local().db(), version, skip_metadata)));
         }
     });
 }
 
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 cql_server::connection::process_query_on_shard(unsigned shard, uint16_t stream, fragmented_temporary_buffer::istream is,
-        service::client_state& cs, service_permit permit) {
+        service::client_state& cs, service_permit permit, tracing::query_profile::clock::time_point start) {
     return smp::submit_to(shard, _server._config.bounce_request_smp_service_group,
-            [this, s = std::ref(_server.container()), is = std::move(is), cs = cs.move_to_other_shard(), stream, permit = std::move(permit)] () {
+            [this, s = std::ref(_server.container()), is = std::move(is), cs = cs.move_to_other_shard(), stream, permit = std::move(permit), start] () {
         service::client_state client_state = cs.get();
         cql_server& server = s.get().local();
-        return do_with(bytes_ostream(), std::move(client_state), [this, &server, is = std::move(is), stream]
+        return do_with(bytes_ostream(), std::move(client_state), [this, &server, is = std::move(is), stream, start]
                                               (bytes_ostream& linearization_buffer, service::client_state& client_state) {
             request_reader in(is, linearization_buffer);
             return process_query_internal(client_state, server._query_processor, in, stream, _version, _cql_serialization_format,
-                    server._cql_config, server.timeout_config(), /* FIXME */empty_service_permit(), false).then([] (auto msg) {
+                    server._cql_config, server.timeout_config(), /* FIXME */empty_service_permit(), false, start).then([] (auto msg) {
                 // result here has to be foreign ptr
                 return std::get<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::move(msg));
             });
@@ -804,13 +823,15 @@ future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 cql_server::connection::process_query(uint16_t stream, request_reader in, service::client_state& client_state, service_permit permit)
 {
     fragmented_temporary_buffer::istream is = in.get_stream();
+    // The request is timed from here even if it's bounced to another shard
+    auto start = tracing::query_profile::clock::now();
 
     return process_query_internal(client_state, _server._query_processor, in, stream,
-            _version, _cql_serialization_format,  _server._cql_config, _server.timeout_config(), permit, true)
-            .then([stream, &client_state, this, is, permit] (std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned> msg) mutable {
+            _version, _cql_serialization_format,  _server._cql_config, _server.timeout_config(), permit, true, start)
+            .then([stream, &client_state, this, is, permit, start] (std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned> msg) mutable {
         unsigned* shard = std::get_if<unsigned>(&msg);
         if (shard) {
-            return process_query_on_shard(*shard, stream, is, client_state, std::move(permit));
+            return process_query_on_shard(*shard, stream, is, client_state, std::move(permit), start);
         }
         return make_ready_future<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::get<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::move(msg)));
     });
@@ -847,7 +868,8 @@ future<std::unique_ptr<cql_server::response>> cql_server::connection::process_pr
 future<std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>>
 process_execute_internal(service::client_state& client_state, distributed<cql3::query_processor>& qp, request_reader in,
         uint16_t stream, cql_protocol_version_type version, cql_serialization_format serialization_format,
-        const cql3::cql_config& cql_config, const ::timeout_config& timeout_config, service_permit permit, bool init_trace) {
+        const cql3::cql_config& cql_config, const ::timeout_config& timeout_config, service_permit permit, bool init_trace,
+        tracing::query_profile::clock::time_point start) {
     cql3::prepared_cache_key_type cache_key(in.read_short_bytes());
     auto& id = cql3::prepared_cache_key_type::cql_id(cache_key);
     bool needs_authorization = false;
@@ -866,6 +888,7 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     auto q_state = std::make_unique<cql_query_state>(client_state, client_state.get_trace_state(), std::move(permit));
     auto& query_state = q_state->query_state;
+    query_state.get_query_profile() = tracing::query_profile(start);
     if (version == 1) {
         std::vector<cql3::raw_value_view> values;
         in.read_value_view_list(version, values);
@@ -907,28 +930,28 @@ process_execute_internal(service::client_state& client_state, distributed<cql3::
 
     tracing::trace(query_state.get_trace_state(), "Processing a statement");
     return qp.local().process_statement_prepared(std::move(prepared), std::move(cache_key), query_state, options, needs_authorization)
-            .then([trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
+            .then([&qp, trace_state = query_state.get_trace_state(), skip_metadata, q_state = std::move(q_state), stream, version] (auto msg) {
         if (msg->move_to_shard()) {
             return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(*msg->move_to_shard());
         } else {
             tracing::trace(q_state->query_state.get_trace_state(), "Done processing - preparing a result");
-            return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(make_foreign(make_result(stream, *msg, q_state->query_state.get_trace_state(), version, skip_metadata)));
+            return std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned>(make_foreign(make_profiled_result(stream, *msg, q_state->query_state, qp.local().db(), version, skip_metadata)));
         }
     });
 }
 
 future<foreign_ptr<std::unique_ptr<cql_server::response>>>
 cql_server::connection::process_execute_on_shard(unsigned shard, uint16_t stream, fragmented_temporary_buffer::istream is,
-        service::client_state& cs, service_permit permit) {
+        service::client_state& cs, service_permit permit, tracing::query_profile::clock::time_point start) {
     return smp::submit_to(shard, _server._config.bounce_request_smp_service_group,
-            [this, s = std::ref(_server.container()), is = std::move(is), cs = cs.move_to_other_shard(), stream, permit = std::move(permit)] () {
+            [this, s = std::ref(_server.container()), is = std::move(is), cs = cs.move_to_other_shard(), stream, permit = std::move(permit), start] () {
         service::client_state client_state = cs.get();
         cql_server& server = s.get().local();
-        return do_with(bytes_ostream(), std::move(client_state), [this, &server, is = std::move(is), stream]
+        return do_with(bytes_ostream(), std::move(client_state), [this, &server, is = std::move(is), stream, start]
                                               (bytes_ostream& linearization_buffer, service::client_state& client_state) {
             request_reader in(is, linearization_buffer);
             return process_execute_internal(client_state, server._query_processor, in, stream, _version, _cql_serialization_format,
-                    server._cql_config, server.timeout_config(), /* FIXME */empty_service_permit(), false).then([] (auto msg) {
+                    server._cql_config, server.timeout_config(), /* FIXME */empty_service_permit(), false, start).then([] (auto msg) {
                 // result here has to be foreign ptr
                 return std::get<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::move(msg));
             });
@@ -939,13 +962,15 @@ cql_server::connection::process_execute_on_shard(unsigned shard, uint16_t stream
 future<foreign_ptr<std::unique_ptr<cql_server::response>>> cql_server::connection::process_execute(uint16_t stream, request_reader in,
         service::client_state& client_state, service_permit permit) {
     fragmented_temporary_buffer::istream is = in.get_stream();
+    // The request is timed from here even if it's bounced to another shard
+    auto start = tracing::query_profile::clock::now();
 
     return process_execute_internal(client_state, _server._query_processor, in, stream,
-            _version, _cql_serialization_format,  _server._cql_config, _server.timeout_config(), permit, true)
-            .then([stream, &client_state, this, is, permit] (std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned> msg) mutable {
+            _version, _cql_serialization_format,  _server._cql_config, _server.timeout_config(), permit, true, start)
+            .then([stream, &client_state, this, is, permit, start] (std::variant<foreign_ptr<std::unique_ptr<cql_server::response>>, unsigned> msg) mutable {
         unsigned* shard = std::get_if<unsigned>(&msg);
         if (shard) {
-            return process_execute_on_shard(*shard, stream, is, client_state, std::move(permit));
+            return process_execute_on_shard(*shard, stream, is, client_state, std::move(permit), start);
         }
         return make_ready_future<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::get<foreign_ptr<std::unique_ptr<cql_server::response>>>(std::move(msg)));
     });
@@ -1043,9 +1068,11 @@ cql_server::connection::process_batch(uint16_t stream, request_reader in, servic
     tracing::trace(client_state.get_trace_state(), "Creating a batch statement");
 
     auto batch = ::make_shared<cql3::statements::batch_statement>(cql3::statements::batch_statement::type(type), std::move(modifications), cql3::attributes::none(), _server._query_processor.local().get_cql_stats());
+    auto execute_start = tracing::query_profile::clock::now();
     return _server._query_processor.local().process_batch(batch, query_state, options, std::move(pending_authorization_entries))
-            .then([this, stream, batch, q_state = std::move(q_state), trace_state = query_state.get_trace_state()] (auto msg) {
-        return make_result(stream, *msg, trace_state, _version);
+            .then([this, stream, batch, q_state = std::move(q_state), execute_start] (auto msg) {
+        q_state->query_state.get_query_profile().add(tracing::query_phase::execute, tracing::query_profile::clock::now() - execute_start);
+        return make_profiled_result(stream, *msg, q_state->query_state, _server._query_processor.local().db(), _version);
     });
 }
 
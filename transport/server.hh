@@ -110,6 +110,8 @@ struct cql_server_config {
     std::function<semaphore& ()> get_service_memory_limiter_semaphore;
     bool allow_shard_aware_drivers = true;
     smp_service_group bounce_request_smp_service_group = default_smp_service_group();
+    // Scheduling group to run the requests of an authenticated role in, see qos::service_level_controller.
+    std::function<scheduling_group (const std::optional<sstring>& role)> get_scheduling_group_for_role;
 };
 
 class cql_server : public seastar::peering_sharded_service<cql_server> {
@@ -161,6 +163,8 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
         service::client_state _client_state;
         std::unordered_map<uint16_t, cql_query_state> _query_states;
         unsigned _request_cpu = 0;
+        // Switched to the service level of the role after authentication.
+        scheduling_group _scheduling_group = current_scheduling_group();
 
         enum class tracing_request_type : uint8_t {
             not_requested,
@@ -223,10 +227,10 @@ class cql_server : public seastar::peering_sharded_service<cql_server> {
 
         future<foreign_ptr<std::unique_ptr<cql_server::response>>>
         process_execute_on_shard(unsigned shard, uint16_t stream, fragmented_temporary_buffer::istream is,
-                service::client_state& cs, service_permit permit);
+                service::client_state& cs, service_permit permit, tracing::query_profile::clock::time_point start);
         future<foreign_ptr<std::unique_ptr<cql_server::response>>>
         process_query_on_shard(unsigned shard, uint16_t stream, fragmented_temporary_buffer::istream is,
-                service::client_state& cs, service_permit permit);
+                service::client_state& cs, service_permit permit, tracing::query_profile::clock::time_point start);
 
         void write_response(foreign_ptr<std::unique_ptr<cql_server::response>>&& response, service_permit permit = empty_service_permit(), cql_compression compression = cql_compression::none);
 
@@ -296,4 +300,10 @@ class cql_server::event_notifier : public service::migration_listener,
     virtual void on_down(const gms::inet_address& endpoint) override;
 };
 
+// Serializes msg into the body of a RESULT response. Cell values are written
+// fragment by fragment, without linearizing them.
+std::unique_ptr<cql_server::response>
+make_result(int16_t stream, messages::result_message& msg, const tracing::trace_state_ptr& tr_state,
+        cql_protocol_version_type version, bool skip_metadata = false);
+
 }
@@ -773,6 +773,19 @@ struct is_byte_order_equal_visitor {
 
 bool abstract_type::is_byte_order_equal() const { return visit(*this, is_byte_order_equal_visitor{}); }
 
+namespace {
+struct fixed_width_order_visitor {
+    template <typename T> fixed_width_order operator()(const integer_type_impl<T>&) { return fixed_width_order::signed_integer; }
+    fixed_width_order operator()(const timestamp_type_impl&) { return fixed_width_order::signed_integer; }
+    fixed_width_order operator()(const time_type_impl&) { return fixed_width_order::signed_integer; }
+    fixed_width_order operator()(const simple_date_type_impl&) { return fixed_width_order::unsigned_bytes; }
+    fixed_width_order operator()(const reversed_type_impl& t) { return t.underlying_type()->get_fixed_width_order(); }
+    fixed_width_order operator()(const abstract_type&) { return fixed_width_order::none; }
+};
+}
+
+fixed_width_order abstract_type::get_fixed_width_order() const { return visit(*this, fixed_width_order_visitor{}); }
+
 static bool
 check_compatibility(const tuple_type_impl &t, const abstract_type& previous, bool (abstract_type::*predicate)(const abstract_type&) const);
 
@@ -1964,6 +1977,234 @@ int32_t abstract_type::compare(bytes_view v1, bytes_view v2) const {
     return visit(*this, compare_visitor{v1, v2});
 }
 
+namespace {
+// Building blocks of abstract_type::serialize_comparable(). Values which may be
+// empty start with a header byte, so that empty values sort first.
+constexpr int8_t comparable_empty = 0x00;
+constexpr int8_t comparable_present = 0x01;
+
+template <typename T>
+void put_comparable_be(std::vector<int8_t>& out, T v) {
+    static_assert(std::is_unsigned<T>::value);
+    for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8) {
+        out.push_back(int8_t(v >> shift));
+    }
+}
+
+// Reverses the order of the prefix-free encodings written starting at the given position.
+void invert_comparable(std::vector<int8_t>& out, size_t from) {
+    for (auto i = from; i < out.size(); ++i) {
+        out[i] = ~out[i];
+    }
+}
+
+// For values compared with compare_unsigned(). A zero byte is escaped as 0x00 0xff
+// and the value is terminated with 0x00 0x00, so that a proper prefix sorts first.
+void put_comparable_escaped(std::vector<int8_t>& out, bytes_view v) {
+    for (auto b : v) {
+        out.push_back(b);
+        if (b == 0) {
+            out.push_back(int8_t(0xff));
+        }
+    }
+    out.push_back(0);
+    out.push_back(0);
+}
+
+// The order of timeuuid_compare_bytes().
+void put_comparable_timeuuid_timestamp(std::vector<int8_t>& out, bytes_view v) {
+    out.push_back(v[6] & 0xf);
+    for (auto pos : {7, 4, 5, 0, 1, 2, 3}) {
+        out.push_back(v[pos]);
+    }
+}
+
+struct serialize_comparable_visitor {
+    bytes_view v;
+    std::vector<int8_t>& out;
+
+    bool put_header() {
+        out.push_back(v.empty() ? comparable_empty : comparable_present);
+        return !v.empty();
+    }
+    // Big-endian two's complement integers of a fixed width, the sign bit is flipped.
+    void put_signed() {
+        if (put_header()) {
+            out.push_back(int8_t(uint8_t(v[0]) ^ 0x80));
+            out.insert(out.end(), v.begin() + 1, v.end());
+        }
+    }
+    void put_unsigned() {
+        if (put_header()) {
+            out.insert(out.end(), v.begin(), v.end());
+        }
+    }
+
+    template <typename T> void operator()(const integer_type_impl<T>&) { put_signed(); }
+    void operator()(const timestamp_type_impl&) { put_signed(); }
+    void operator()(const time_type_impl&) { put_signed(); }
+    void operator()(const simple_date_type_impl&) { put_unsigned(); }
+    void operator()(const boolean_type_impl&) {
+        if (put_header()) {
+            out.push_back(v[0] != 0);
+        }
+    }
+    template <typename T> void operator()(const floating_type_impl<T>& t) {
+        if (!put_header()) {
+            return;
+        }
+        using bits_type = std::conditional_t<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>;
+        static_assert(sizeof(T) == sizeof(bits_type));
+        constexpr auto sign_bit = bits_type(1) << (sizeof(bits_type) * 8 - 1);
+        // All NaNs are equal and greater than anything else, like in compare_visitor.
+        auto bits = ~bits_type(0);
+        T x = deserialize_value(t, v);
+        if (!std::isnan(x)) {
+            std::memcpy(&bits, &x, sizeof(x));
+            bits = (bits & sign_bit) ? ~bits : bits | sign_bit;
+        }
+        put_comparable_be(out, bits);
+    }
+    void operator()(const string_type_impl&) { put_comparable_escaped(out, v); }
+    void operator()(const bytes_type_impl&) { put_comparable_escaped(out, v); }
+    void operator()(const duration_type_impl&) { put_comparable_escaped(out, v); }
+    void operator()(const inet_addr_type_impl&) { put_comparable_escaped(out, v); }
+    void operator()(const date_type_impl&) { put_comparable_escaped(out, v); }
+    void operator()(const timeuuid_type_impl&) {
+        if (put_header()) {
+            put_comparable_timeuuid_timestamp(out, v);
+            // The remaining bytes compare as signed.
+            for (auto b : v) {
+                out.push_back(int8_t(uint8_t(b) ^ 0x80));
+            }
+        }
+    }
+    void operator()(const uuid_type_impl&) {
+        // Values shorter than 16 bytes are all equal.
+        if (v.size() < 16) {
+            out.push_back(comparable_empty);
+            return;
+        }
+        out.push_back(comparable_present);
+        auto version = (v[6] >> 4) & 0x0f;
+        out.push_back(version);
+        if (version == 1) {
+            put_comparable_timeuuid_timestamp(out, v);
+        }
+        out.insert(out.end(), v.begin(), v.end());
+    }
+    void operator()(const varint_type_impl&) {
+        if (!put_header()) {
+            return;
+        }
+        // Strip redundant sign extension bytes, so that equal values are encoded the same.
+        auto b = v;
+        while (b.size() > 1 && ((b[0] == 0 && b[1] >= 0) || (b[0] == -1 && b[1] < 0))) {
+            b.remove_prefix(1);
+        }
+        // Negative values sort first, and among them the longer ones.
+        // Same-length values of the same sign compare as unsigned.
+        bool negative = b[0] < 0;
+        uint32_t length = b.size();
+        out.push_back(negative ? 0 : 1);
+        put_comparable_be(out, negative ? ~length : length);
+        out.insert(out.end(), b.begin(), b.end());
+    }
+    void operator()(const decimal_type_impl& t) {
+        if (!put_header()) {
+            return;
+        }
+        auto d = deserialize_value(t, v);
+        if (d.unscaled_value().is_zero()) {
+            out.push_back(1);
+            return;
+        }
+        bool negative = d.unscaled_value().sign() < 0;
+        auto digits = boost::multiprecision::cpp_int(boost::multiprecision::abs(d.unscaled_value())).str();
+        int64_t scale = d.scale();
+        while (digits.back() == '0') {
+            digits.pop_back();
+            --scale;
+        }
+        // The value is 0.<digits> * 10^exponent, with a non-zero first digit, so that
+        // the exponent decides first and then the digits compare lexicographically.
+        int64_t exponent = int64_t(digits.size()) - scale;
+        out.push_back(negative ? 0 : 2);
+        auto start = out.size();
+        put_comparable_be(out, uint64_t(exponent) ^ (uint64_t(1) << 63));
+        out.insert(out.end(), digits.begin(), digits.end());
+        out.push_back(0);
+        if (negative) {
+            invert_comparable(out, start);
+        }
+    }
+    void operator()(const listlike_collection_type_impl& l) {
+        if (!v.empty()) {
+            auto in = v;
+            auto sf = cql_serialization_format::internal();
+            using llpdi = listlike_partial_deserializing_iterator;
+            for (auto it = llpdi::begin(in, sf); it != llpdi::end(in, sf); ++it) {
+                out.push_back(1);
+                l.get_elements_type()->serialize_comparable(*it, out);
+            }
+        }
+        out.push_back(0);
+    }
+    void operator()(const map_type_impl& m) {
+        if (!put_header()) {
+            return;
+        }
+        auto in = v;
+        auto sf = cql_serialization_format::internal();
+        auto size = read_collection_size(in, sf);
+        for (int i = 0; i < size; ++i) {
+            out.push_back(1);
+            m.get_keys_type()->serialize_comparable(read_collection_value(in, sf), out);
+            m.get_values_type()->serialize_comparable(read_collection_value(in, sf), out);
+        }
+        out.push_back(0);
+    }
+    void operator()(const tuple_type_impl& t) {
+        // Trailing nulls don't take part in the comparison, see compare_aux().
+        std::vector<bytes_view_opt> elements;
+        for (auto it = tuple_deserializing_iterator::start(v), end = tuple_deserializing_iterator::finish(v);
+                it != end && elements.size() < t.size(); ++it) {
+            elements.push_back(*it);
+        }
+        while (!elements.empty() && !elements.back()) {
+            elements.pop_back();
+        }
+        for (size_t i = 0; i < elements.size(); ++i) {
+            if (!elements[i]) {
+                out.push_back(1);
+            } else {
+                out.push_back(2);
+                t.type(i)->serialize_comparable(*elements[i], out);
+            }
+        }
+        out.push_back(0);
+    }
+    void operator()(const empty_type_impl&) { out.push_back(comparable_empty); }
+    void operator()(const counter_type_impl&) { fail(unimplemented::cause::COUNTERS); }
+    void operator()(const reversed_type_impl& r) {
+        auto start = out.size();
+        r.underlying_type()->serialize_comparable(v, out);
+        invert_comparable(out, start);
+    }
+};
+}
+
+void abstract_type::serialize_comparable(bytes_view v, std::vector<int8_t>& out) const {
+    visit(*this, serialize_comparable_visitor{v, out});
+}
+
+bytes abstract_type::to_comparable_bytes(bytes_view v) const {
+    std::vector<int8_t> out;
+    out.reserve(v.size() + 16);
+    serialize_comparable(v, out);
+    return bytes(out.data(), out.size());
+}
+
 bool abstract_type::equal(bytes_view v1, bytes_view v2) const {
     return ::visit(*this, [&](const auto& t) {
         if (is_byte_order_equal_visitor{}(t)) {
@@ -433,6 +433,28 @@ class serialized_compare;
 class serialized_tri_compare;
 class user_type_impl;
 
+// Describes how the serialized values of a fixed-width type compare, so that hot
+// comparators can skip the virtual call to abstract_type::compare().
+// Only valid for values of the fixed length, empty values still have to go
+// through compare().
+enum class fixed_width_order : uint8_t {
+    none,           // no shortcut, use abstract_type::compare()
+    unsigned_bytes, // as unsigned bytes
+    signed_integer, // as a big-endian two's complement integer
+};
+
+// Compares two values of the same fixed length with the given order.
+inline int32_t tri_compare_fixed_width(fixed_width_order order, bytes_view v1, bytes_view v2) {
+    if (order == fixed_width_order::signed_integer) {
+        // bytes_view elements are signed, the sign bit is in the first one
+        if (v1[0] != v2[0]) {
+            return v1[0] < v2[0] ? -1 : 1;
+        }
+        return memcmp(v1.begin() + 1, v2.begin() + 1, v1.size() - 1);
+    }
+    return memcmp(v1.begin(), v2.begin(), v1.size());
+}
+
 // Unsafe to access across shards unless otherwise noted.
 class abstract_type : public enable_shared_from_this<abstract_type> {
     sstring _name;
@@ -539,6 +561,21 @@ class abstract_type : public enable_shared_from_this<abstract_type> {
      * When returns false, nothing can be inferred.
      */
     bool is_byte_order_equal() const;
+    /**
+     * How non-empty values of value_length_if_fixed() length compare, see fixed_width_order.
+     *
+     * Reversed types return the order of the underlying type, it's up to the caller to
+     * reverse the result.
+     */
+    fixed_width_order get_fixed_width_order() const;
+    /**
+     * Appends to out a byte-comparable encoding of the serialized value v:
+     * compare_unsigned() of the encodings of two values has the same sign as compare()
+     * of the values. Encodings are non-empty and prefix-free, so the encodings of
+     * consecutive components can be concatenated, see compound_type::to_comparable_bytes().
+     */
+    void serialize_comparable(bytes_view v, std::vector<int8_t>& out) const;
+    bytes to_comparable_bytes(bytes_view v) const;
     sstring get_string(const bytes& b) const;
     sstring to_string(bytes_view bv) const {
         return to_string_impl(deserialize(bv));
@@ -93,6 +93,9 @@ future<> directories::init(db::config& cfg, bool hinted_handoff_enabled) {
         add_sharded(cfg.hints_directory(), paths);
     }
     add_sharded(cfg.view_hints_directory(), paths);
+    if (cfg.row_cache_save_period()) {
+        add(cfg.saved_caches_directory(), paths);
+    }
 
     supervisor::notify("creating and verifying directories");
     return parallel_for_each(paths, [this, &cfg] (fs::path path) {
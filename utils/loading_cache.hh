@@ -108,13 +108,13 @@ class timestamped_val {
         return _lru_entry_ptr;
     }
 
-private:
     void touch() noexcept {
         assert(_lru_entry_ptr);
         _last_read = loading_cache_clock_type::now();
         _lru_entry_ptr->touch();
     }
 
+private:
     void set_anchor_back_reference(lru_entry* lru_entry_ptr) noexcept {
         _lru_entry_ptr = lru_entry_ptr;
     }
@@ -162,6 +162,7 @@ class timestamped_val<Tp, Key, EntrySize, Hash, EqualPred, LoadingSharedValuesSt
     timestamped_val_ptr _ts_val_ptr;
     lru_list_type& _lru_list;
     size_t& _cache_size;
+    unsigned _hits = 0;
 
 public:
     lru_entry(timestamped_val_ptr ts_val, lru_list_type& lru_list, size_t& cache_size)
@@ -192,6 +193,18 @@ class timestamped_val<Tp, Key, EntrySize, Hash, EqualPred, LoadingSharedValuesSt
             _lru_list.erase(_lru_list.iterator_to(*this));
         }
         _lru_list.push_front(*this);
+        _hits = std::min(_hits + 1, 2u);
+    }
+
+    /// Entries which were used more than once since they were loaded (or since their last second chance) are
+    /// not evicted the first time they reach the LRU end of the list. Returns true if this entry gets such a
+    /// second chance, in which case it has to be used again to get another one.
+    bool second_chance() noexcept {
+        if (_hits < 2) {
+            return false;
+        }
+        _hits = 1;
+        return true;
     }
 
     const Key& key() const noexcept {
@@ -226,6 +239,9 @@ enum class loading_cache_reload_enabled { no, yes };
 /// to exceed the cache size limit the least recently used value(s) is(are) going to be evicted until the size of the cache
 /// becomes such that adding the new value is not going to break the size limit. If the new entry's size is greater than
 /// the cache size then the get_XXX(...) method is going to return a future with the loading_cache::entry_is_too_big exception.
+/// Values which were used more than once since they were loaded get a second chance: the first time such a value is
+/// the least recently used one it is skipped, so that a burst of values used only once doesn't push out the frequently
+/// used ones.
 ///
 /// The size of the cache is defined as a sum of sizes of all cached entries.
 /// The size of each entry is defined by the value returned by the \tparam EntrySize predicate applied on it.
@@ -391,6 +407,23 @@ class loading_cache {
         return boost::make_transform_iterator(to_list_iterator(set_find(k)), _value_extractor_fn);
     }
 
+    /// \brief Marks the value as just used, like get_ptr(k) does, if it's cached.
+    ///
+    /// Unlike get_ptr(k) this never loads the value.
+    void touch(const Key& k) noexcept {
+        auto it = set_find(k);
+        if (it != set_end()) {
+            it->touch();
+        }
+    }
+
+    /// \brief Marks the value pointed to by an iterator returned by find() as just used.
+    ///
+    /// Saves the lookup touch(k) would do. \p it must not be end().
+    void touch(iterator it) noexcept {
+        it.base()->timestamped_value().touch();
+    }
+
     iterator end() {
         return boost::make_transform_iterator(list_end(), _value_extractor_fn);
     }
@@ -545,12 +578,23 @@ class loading_cache {
         });
     }
 
-    // Shrink the cache to the _max_size discarding the least recently used items
+    // Shrink the cache to the _max_size discarding the least recently used items which don't get a second chance.
+    // The most recently used item, which is the one which has just been added, is never discarded.
     void shrink() {
+        auto it = list_end();
         while (_current_size > _max_size) {
             using namespace std::chrono;
-            ts_value_lru_entry& lru_entry = *_lru_list.rbegin();
+            if (--it == list_begin()) {
+                // Every other item had its second chance - start over from the least recently used one.
+                it = std::prev(list_end());
+            }
+            ts_value_lru_entry& lru_entry = *it;
+            if (lru_entry.second_chance()) {
+                _logger.trace("shrink(): {}: giving the entry a second chance", lru_entry.key());
+                continue;
+            }
             _logger.trace("shrink(): {}: dropping the entry: ms since last_read {}", lru_entry.key(), duration_cast<milliseconds>(loading_cache_clock_type::now() - lru_entry.timestamped_value().last_read()).count());
+            ++it;
             loading_cache::destroy_ts_value(&lru_entry);
         }
     }